@@ -2,25 +2,73 @@
 #define DEBUG_MACRO_H 1
 
 
+///Tiered checking levels.
+///
+/// @c SVO_CHECK_OFF: no inline checks at all; the hot paths are free of assert/sanity overhead.
+/// @c SVO_CHECK_CHEAP: constant time checks only (bounds, flags, non-recursive sanity).
+/// @c SVO_CHECK_FULL: everything, including recursive svo_slice_sanity()/svo_block_sanity_check()
+///  passes and cross-checking of the fast accessors against their slow versions.
+///
+///The global level is @c SVO_CHECK_LEVEL (defaults to full, or off with NDEBUG); each module can be
+/// overridden on its own, e.g. -DSVO_CHECK_LEVEL=0 -DSVO_CHECK_LEVEL_SLICE_MGMT=2.
+///Checks compile down to @c assert(), so they still need a build without NDEBUG to fire; to validate
+/// a production build, use the background validation pass in svo_tree.sanity.hpp instead.
+#define SVO_CHECK_OFF 0
+#define SVO_CHECK_CHEAP 1
+#define SVO_CHECK_FULL 2
 
+#ifndef SVO_CHECK_LEVEL
 #ifndef NDEBUG
+#define SVO_CHECK_LEVEL SVO_CHECK_FULL
+#else
+#define SVO_CHECK_LEVEL SVO_CHECK_OFF
+#endif
+#endif
+
+#ifndef SVO_CHECK_LEVEL_CAPI
+#define SVO_CHECK_LEVEL_CAPI SVO_CHECK_LEVEL
+#endif
+#ifndef SVO_CHECK_LEVEL_TREE
+#define SVO_CHECK_LEVEL_TREE SVO_CHECK_LEVEL
+#endif
+#ifndef SVO_CHECK_LEVEL_BLOCK_MGMT
+#define SVO_CHECK_LEVEL_BLOCK_MGMT SVO_CHECK_LEVEL
+#endif
+#ifndef SVO_CHECK_LEVEL_SLICE_MGMT
+#define SVO_CHECK_LEVEL_SLICE_MGMT SVO_CHECK_LEVEL
+#endif
+#ifndef SVO_CHECK_LEVEL_SERIALIZATION
+#define SVO_CHECK_LEVEL_SERIALIZATION SVO_CHECK_LEVEL
+#endif
+#ifndef SVO_CHECK_LEVEL_MCLOADER
+#define SVO_CHECK_LEVEL_MCLOADER SVO_CHECK_LEVEL
+#endif
+
+///a translation unit selects its module by defining this before any include.
+#ifndef SVO_MODULE_CHECK_LEVEL
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL
+#endif
 
 
+///expensive checks; the existing DEBUG blocks.
 #ifndef DEBUG
-#define DEBUG if(1)
+#define DEBUG if(SVO_MODULE_CHECK_LEVEL >= SVO_CHECK_FULL)
 #endif
 
+///cheap checks.
+#ifndef DEBUG_CHEAP
+#define DEBUG_CHEAP if(SVO_MODULE_CHECK_LEVEL >= SVO_CHECK_CHEAP)
+#endif
+
+
+#ifndef NDEBUG
+
 #ifndef SCAFFOLDING
 #define SCAFFOLDING if(1)
 #endif
 
-    
 #else
 
-#ifndef DEBUG
-#define DEBUG if(0)
-#endif
-
 #ifndef SCAFFOLDING
 #define SCAFFOLDING if(0)
 #endif
@@ -0,0 +1,142 @@
+#ifndef SVO_ARCHIVE_HPP
+#define SVO_ARCHIVE_HPP 1
+
+#include <iosfwd>
+#include <vector>
+#include <map>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "svo_curves.h"
+#include "svo_tree.fwd.hpp"
+#include "svo_serialization.v2.hpp"
+
+namespace svo{
+
+typedef uint32_t svo_slice_id_t;
+static const svo_slice_id_t invalid_slice_id = svo_slice_id_t(-1);
+
+///Where a slice lives in an archive, and how it hangs in the hierarchy.
+struct svo_archive_entry_t{
+    svo_archive_entry_t();
+
+    ///byte offset of the serialized slice, from the start of the archive.
+    uint64_t offset;
+    ///size of the serialized slice, in bytes.
+    uint64_t size;
+
+    std::size_t level;
+    vside_t side;
+    vcurve_t parent_vcurve_begin;
+
+    svo_slice_id_t parent_id;
+    ///in the same order as the slice's @c children.
+    std::vector<svo_slice_id_t> children;
+};
+
+
+/**
+ * Writes a whole slice hierarchy into one seekable stream.
+ *
+ * Each slice is serialized with serialize_slice_v2(); the slices are numbered in pre-order, so the
+ * root is slice 0. An index of all slices is written after the slice data, and the fixed size header
+ * points to it, so the archive can be written in a single pass.
+ *
+ * Layout:
+ *  - 4 byte magic, "SVOA".
+ *  - u32 archive version: 2, or 3 if a slice has more than 2^32 voxels (see svo_vcurve_bytes()), in
+ *      which case parent_vcurve_begin is a u64 in the index.
+ *  - u64 index offset.
+ *  - the serialized slices.
+ *  - the index, as a checksummed section (see svo_write_section()): u32 slice count, then for each
+ *      slice: u64 offset, u64 size, u32 level, u32 side, u32 parent_vcurve_begin, u32 parent id,
+ *      u32 children count, and the children ids.
+ *
+ * The slices are checksummed unless @c options.checksums is turned off.
+ */
+void svo_write_archive(std::ostream& out, const svo_slice_t* root_slice
+                        , const svo_serialization_options_t& options = svo_serialization_options_t());
+
+
+/**
+ * Replaces some slices of an archive, in place, by appending their new versions.
+ *
+ * The new slices and a new index are written at the end of @c io, and then the header is pointed at
+ *  the new index; until that last write the archive still reads as before, so an interrupted update
+ *  leaves the old version intact. The space of the replaced slices is not reclaimed, so the archive
+ *  grows with each update; svo_rewrite_archive() reclaims it.
+ *
+ * The hierarchy cannot change: each slice must keep the level, side and number of children of its
+ *  entry; load it with empty children (see svo_archive_t::load_slice()) to keep the child info.
+ * The archive starts at the current position of @c io; open archives must be reopened to see the update.
+ */
+void svo_archive_update_slices(std::iostream& io, const std::map<svo_slice_id_t, const svo_slice_t*>& slices
+                                , const svo_serialization_options_t& options = svo_serialization_options_t());
+
+
+/**
+ * Copies the archive in @c in to @c out, leaving out the space of slices replaced by
+ *  svo_archive_update_slices().
+ *
+ * The slices are copied as they are, without decoding them, so this costs one read and one write of
+ *  each live slice. The archive starts at the current position of each stream.
+ */
+void svo_rewrite_archive(std::istream& in, std::ostream& out, bool verify_checksums = true);
+
+
+/**
+ * Random access to the slices of an archive written by svo_write_archive().
+ *
+ * The constructor reads just the header and index, starting at the stream's current position; slices
+ * are read on demand with one seek each.
+ * The stream must outlive the archive, and the archive is not thread safe.
+ *
+ * A malformed archive or slice throws @c std::runtime_error; with @c verify_checksums off, only the
+ *  structure is checked, which is enough for trusted archives.
+ */
+struct svo_archive_t{
+    explicit svo_archive_t(std::istream& in, bool verify_checksums = true);
+
+    std::size_t size() const;
+    const svo_archive_entry_t& entry(svo_slice_id_t slice_id) const;
+    const std::vector<svo_archive_entry_t>& entries() const;
+    ///true if the checksums of the index and slices are verified when they are loaded.
+    bool verify_checksums() const;
+
+    /**
+     * Loads a single slice into @c slice, which must be freshly initialized with the entry's level and side.
+     *
+     * If @c load_empty_children is set, empty child slices are attached, in the same order as
+     *  @c entry(slice_id).children, so that they can be filled in lazily later.
+     * @c filter selects the buffer elements to load; see svo_slice_load_filter_t.
+     */
+    void load_slice(svo_slice_id_t slice_id, svo_slice_t* slice, bool load_empty_children
+                    , const svo_slice_load_filter_t& filter = svo_slice_load_filter_t());
+
+    ///reads the serialized bytes of a slice without decoding them; feed them to unserialize_slice().
+    void read_slice_data(svo_slice_id_t slice_id, std::string& data);
+
+    /**
+     * Loads a slice and its descendants, up to @c max_depth levels below it.
+     *
+     * Children below @c max_depth are left out entirely (@c children is empty), and the loaded root
+     *  has no parent. Free the result with svo_uninit_slice().
+     */
+    svo_slice_t* load_subtree(svo_slice_id_t slice_id, std::size_t max_depth=std::size_t(-1)
+                                , const svo_slice_load_filter_t& filter = svo_slice_load_filter_t());
+
+    ///the child of @c slice_id whose cube starts at @c parent_vcurve_begin, or @c invalid_slice_id.
+    svo_slice_id_t find_child(svo_slice_id_t slice_id, vcurve_t parent_vcurve_begin) const;
+
+private:
+    std::istream& m_in;
+    ///position of the archive within @c m_in.
+    uint64_t m_begin;
+    bool m_verify_checksums;
+    std::vector<svo_archive_entry_t> m_entries;
+};
+
+
+} //namespace svo
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef SVO_ARENA_HPP
+#define SVO_ARENA_HPP 1
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace svo{
+
+
+/**
+ * A monotonic allocator: memory is carved out of a few large chunks, and is only given back all at
+ *  once, by release() or the destructor.
+ *
+ * Used to allocate a whole hierarchy of slices (see svo_init_slice(), svo_entree_slices()) and the
+ *  storage of their cpu buffers, instead of a heap allocation per slice, vector and buffer. Freeing
+ *  memory from the arena does nothing, so buffers that are resized many times waste arena space.
+ *
+ * The arena must outlive everything allocated from it. It is not thread safe.
+ */
+struct svo_arena_t{
+    static const std::size_t DEFAULT_CHUNK_BYTES = 1 << 20;
+
+    explicit svo_arena_t(std::size_t chunk_bytes = DEFAULT_CHUNK_BYTES);
+    ~svo_arena_t();
+
+    svo_arena_t(const svo_arena_t&) = delete;
+    svo_arena_t& operator=(const svo_arena_t&) = delete;
+
+    /**
+     * Returns @c bytes of memory aligned to @c alignment, which must be a power of 2.
+     *
+     * Allocations larger than a quarter of a chunk get a chunk of their own, so that they do not waste
+     *  the rest of the current chunk.
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    ///constructs a @c T in the arena; it must be destroyed with destroy(), which does not free it.
+    template<typename T, typename... Args>
+    T* create(Args&&... args);
+    ///calls the destructor of @c object, if it is not null.
+    template<typename T>
+    static void destroy(T* object);
+
+    ///frees all the chunks.
+    void release();
+
+    ///the number of chunks held.
+    std::size_t chunks() const;
+    ///the number of bytes handed out since the last release().
+    std::size_t bytes_allocated() const;
+private:
+    std::size_t m_chunk_bytes;
+    std::vector< std::unique_ptr<uint8_t[]> > m_chunks;
+    ///the free part of the current chunk.
+    uint8_t* m_next;
+    uint8_t* m_end;
+    std::size_t m_bytes_allocated;
+};
+
+
+/**
+ * A standard allocator that allocates from an svo_arena_t, or from the heap if the arena is null.
+ */
+template<typename T>
+struct svo_arena_allocator_t{
+    typedef T value_type;
+
+    svo_arena_allocator_t(svo_arena_t* arena = nullptr);
+    template<typename U>
+    svo_arena_allocator_t(const svo_arena_allocator_t<U>& other);
+
+    T* allocate(std::size_t n);
+    void deallocate(T* p, std::size_t n);
+
+    svo_arena_t* arena() const;
+private:
+    svo_arena_t* m_arena;
+};
+
+template<typename T, typename U>
+bool operator==(const svo_arena_allocator_t<T>& lhs, const svo_arena_allocator_t<U>& rhs);
+template<typename T, typename U>
+bool operator!=(const svo_arena_allocator_t<T>& lhs, const svo_arena_allocator_t<U>& rhs);
+
+
+} //namespace svo
+
+#include "svo_arena.inl.hpp"
+
+#endif
@@ -0,0 +1,75 @@
+
+
+
+#include <cassert>
+#include <new>
+#include <utility>
+
+namespace svo{
+
+
+template<typename T, typename... Args>
+inline T* svo_arena_t::create(Args&&... args)
+{
+    void* memory = allocate(sizeof(T), alignof(T));
+    return new (memory) T(std::forward<Args>(args)...);
+}
+
+template<typename T>
+inline void svo_arena_t::destroy(T* object)
+{
+    if (object)
+        object->~T();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template<typename T>
+inline svo_arena_allocator_t<T>::svo_arena_allocator_t(svo_arena_t* arena)
+    : m_arena(arena)
+{}
+
+template<typename T>
+template<typename U>
+inline svo_arena_allocator_t<T>::svo_arena_allocator_t(const svo_arena_allocator_t<U>& other)
+    : m_arena(other.arena())
+{}
+
+template<typename T>
+inline T* svo_arena_allocator_t<T>::allocate(std::size_t n)
+{
+    if (m_arena)
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+}
+
+template<typename T>
+inline void svo_arena_allocator_t<T>::deallocate(T* p, std::size_t /*n*/)
+{
+    ///arena memory is freed with the arena.
+    if (!m_arena)
+        ::operator delete(p);
+}
+
+template<typename T>
+inline svo_arena_t* svo_arena_allocator_t<T>::arena() const
+{
+    return m_arena;
+}
+
+template<typename T, typename U>
+inline bool operator==(const svo_arena_allocator_t<T>& lhs, const svo_arena_allocator_t<U>& rhs)
+{
+    return lhs.arena() == rhs.arena();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const svo_arena_allocator_t<T>& lhs, const svo_arena_allocator_t<U>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+
+} //namespace svo
@@ -0,0 +1,90 @@
+#ifndef SVO_BLOCK_IMAGE_HPP
+#define SVO_BLOCK_IMAGE_HPP 1
+
+#include <iosfwd>
+#include <string>
+#include <memory>
+#include <cstddef>
+#include "svo_inttypes.h"
+#include "svo_tree.fwd.hpp"
+
+namespace svo{
+
+
+/**
+ * Writes the blocks of a built tree as an image that can be mapped back without parsing the CDs.
+ *
+ * The image holds a small header and block table (bounds, section offsets, root info, parent block
+ * and the schema of the block's buffers), followed by the pages of each block, each at a
+ * @c SVO_PAGE_SIZE aligned file offset. Pages outside of any block are not written.
+ *
+ * The pages are written as they are in memory, so an image can only be loaded on a host with the
+ * same byte order; the loaders check this.
+ *
+ * The block table is a checksummed section (see svo_write_section()), and each block's entry holds the
+ *  CRC-32C of its pages; see svo_block_image_validation_t.
+ *
+ * Slices are not part of the image; the blocks' @c slice is null after loading.
+ */
+void svo_write_block_image(std::ostream& out, const svo_tree_t* tree);
+
+
+///How much of a block image the loaders check, beyond its structure.
+enum class svo_block_image_validation_t{
+    ///only the header and the block table's structure; for trusted images.
+      structure
+    ///also the checksum of the block table.
+    , table
+    ///also the checksum of every block's pages; this reads every page, even of a mapped image.
+    , full
+};
+
+
+/**
+ * A tree restored from a block image, and the memory backing its address space.
+ *
+ * The block table is parsed into @c svo_block_t objects, but the CD/data pages are never touched:
+ * svo_map_block_image() maps them straight from the file, copy-on-write, so the tree can still be
+ * edited without changing the file.
+ */
+struct svo_block_image_t{
+    svo_block_image_t(const svo_block_image_t&) = delete;
+    svo_block_image_t& operator=(const svo_block_image_t&) = delete;
+    ~svo_block_image_t();
+
+    svo_tree_t* tree() const;
+    ///true if the pages are mapped from the file, false if they were read into memory.
+    bool mapped() const;
+
+private:
+    svo_block_image_t();
+
+    std::unique_ptr<svo_tree_t> m_tree;
+    ///the reservation holding the address space; munmap()ed or free()d on destruction.
+    void* m_memory;
+    std::size_t m_memory_size;
+    bool m_mapped;
+
+    friend std::unique_ptr<svo_block_image_t> svo_map_block_image(const std::string& path, svo_block_image_validation_t validation);
+    friend std::unique_ptr<svo_block_image_t> svo_load_block_image(std::istream& in, svo_block_image_validation_t validation);
+};
+
+/**
+ * Maps the block image at @c path.
+ *
+ * Uses mmap() where available; elsewhere, or if the OS page size does not divide @c SVO_PAGE_SIZE,
+ *  it falls back to svo_load_block_image().
+ * By default only the block table is verified, so mapping stays lazy; a malformed image throws
+ *  @c std::runtime_error.
+ */
+std::unique_ptr<svo_block_image_t> svo_map_block_image(const std::string& path
+                                                    , svo_block_image_validation_t validation = svo_block_image_validation_t::table);
+
+///reads a block image from a seekable stream into freshly allocated memory, verifying all of it by default.
+std::unique_ptr<svo_block_image_t> svo_load_block_image(std::istream& in
+                                                    , svo_block_image_validation_t validation = svo_block_image_validation_t::full);
+
+
+} //namespace svo
+
+#endif
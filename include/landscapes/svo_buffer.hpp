@@ -4,17 +4,20 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 #include <map>
 #include <set>
 #include <cstddef>
 #include <cstdint>
 #include <typeinfo>
 #include <typeindex>
+#include <type_traits>
 
 #include "svo_buffer.fwd.hpp"
 #include "svo_tofromstr.hpp"
 #include "svo_validenum.hpp"
 #include "svo_inttypes.h"
+#include "svo_arena.hpp"
 
 
 #include "svo_tree.fwd.hpp"
@@ -64,10 +67,19 @@ private:
     std::size_t m_bytes;
 };
 
+///how the elements of a declaration are stored.
+enum class svo_layout_t{
+    ///one buffer, each entry holds all the elements.
+      INTERLEAVED
+    ///one buffer per element, so that each element is a unit-stride stream.
+    , PLANAR
+};
+
 struct svo_declaration_t{
     typedef std::vector<svo_element_t> elements_list_t;
 
     svo_declaration_t();
+    explicit svo_declaration_t(svo_layout_t layout);
 
     std::size_t stride() const;
     void add(const svo_element_t& element);
@@ -75,6 +87,16 @@ struct svo_declaration_t{
 
     const elements_list_t& elements() const;
 
+    svo_layout_t layout() const;
+    /**
+     * The declarations of the buffers that store this declaration: itself if it is interleaved, and an
+     *  interleaved declaration of each element if it is planar.
+     *
+     * Buffers only hold interleaved declarations; add_buffer() of svo_cpu_buffers_t and svo_gpu_buffers_t
+     *  adds a buffer per plane, and get_element_view() finds the elements in whichever buffer they are.
+     */
+    std::vector<svo_declaration_t> planes() const;
+
     bool operator==(const svo_declaration_t& other) const;
     bool operator!=(const svo_declaration_t& other) const;
 
@@ -84,6 +106,7 @@ private:
     std::vector<std::size_t> m_offsets;
     std::size_t m_stride;
     std::set<std::string> m_names;
+    svo_layout_t m_layout;
 };
 
 template<typename svo_buffer_t>
@@ -98,9 +121,12 @@ struct svo_base_buffer_t{
     std::size_t stride() const;
     ///raw pointer to the beginning of the buffer.
     const uint8_t* rawdata() const;
-    ///raw pointer to the beginning of the buffer.
+    ///raw pointer to the beginning of the buffer, for writing; a shared cpu buffer is copied first.
     uint8_t* rawdata();
 
+    ///copy entries from @c src_buffer, whose elements must match these one to one; each element is converted
+    /// to the type of this buffer's. The element index overloads copy a single element, e.g. to re-layout an
+    /// interleaved buffer into planar ones.
     void copy_from_buffer(const svo_cpu_buffer_t& src_buffer
                             , std::size_t src_start=0, std::size_t copy_entries = (std::size_t)-1
                             , std::size_t dst_start=0);
@@ -152,28 +178,90 @@ protected:
     uint8_t* m_rawdata;
 };
 
+/**
+ * A buffer in main memory.
+ *
+ * The bytes live in a reference counted storage. Copying a buffer copies its entries; only view(), and
+ *  svo_cpu_buffers_t::share_buffers(), share the storage, in O(1). The storage is copied on the first
+ *  write through a buffer that shares it (rawdata(), resize()), so after that write neither buffer sees
+ *  the writes of the other. Pointers into the buffer (rawdata(), element views) taken before it was
+ *  shared still point into the shared storage though; writes through them are seen by every buffer
+ *  sharing it, so take them again after sharing. Buffers of different arenas do not share storage; see
+ *  set_arena().
+ */
 struct svo_cpu_buffer_t : svo_base_buffer_t<svo_cpu_buffer_t>{
     typedef svo_base_buffer_t<svo_cpu_buffer_t> super_type;
-    explicit svo_cpu_buffer_t(const svo_declaration_t& declaration, std::size_t initial_entries);
+    typedef std::vector< uint8_t, svo_arena_allocator_t<uint8_t> > storage_t;
+
+    ///if @c arena is not null, the storage, and the copies made on write, are allocated from it.
+    explicit svo_cpu_buffer_t(const svo_declaration_t& declaration, std::size_t initial_entries, svo_arena_t* arena = nullptr);
+    ///copies the entries of @c other, into storage allocated from the arena of @c other.
+    svo_cpu_buffer_t(const svo_cpu_buffer_t& other);
+    svo_cpu_buffer_t(svo_cpu_buffer_t&& other) = default;
+    svo_cpu_buffer_t& operator=(const svo_cpu_buffer_t& other);
+    svo_cpu_buffer_t& operator=(svo_cpu_buffer_t&& other) = default;
+
+    ///a buffer of the entries [@c start, @c start + @c entries) of this one, sharing its storage.
+    svo_cpu_buffer_t view(std::size_t start, std::size_t entries) const;
+    ///true if the storage is shared with another buffer.
+    bool shared() const;
 
     void resize(std::size_t new_size);
+    ///copies the storage if it is shared, so that it can be written.
+    void make_writable();
     void assert_invariants() const;
+
+    ///the arena that new storage is allocated from; null for the heap.
+    svo_arena_t* arena() const;
+    /**
+     * Allocates from @c arena from now on. If the storage was allocated from another arena (or the
+     *  heap), it is copied into @c arena, so that this buffer does not outlive the memory it points to
+     *  when that arena is released.
+     */
+    void set_arena(svo_arena_t* arena);
 private:
-    std::vector<uint8_t> m_data;
+    struct share_t{};
+    ///a buffer sharing the storage of @c other.
+    svo_cpu_buffer_t(const svo_cpu_buffer_t& other, share_t);
+
+    static std::shared_ptr<storage_t> make_storage(svo_arena_t* arena, std::size_t bytes);
+    ///replaces the storage with a copy of the entries, allocated from @c m_arena.
+    void copy_storage();
+
+    std::shared_ptr<storage_t> m_storage;
+    ///the byte offset of the first entry in @c m_storage.
+    std::size_t m_storage_offset;
+    svo_arena_t* m_arena;
+
+    friend struct svo_cpu_buffers_t;
 };
 
+/**
+ * A buffer in the data section of a block, in the tree's address space.
+ *
+ * The buffers of a block are laid out back to back from the block's @c data_start; see svo_gpu_buffers_t.
+ */
 struct svo_gpu_buffer_t : svo_base_buffer_t<svo_gpu_buffer_t>{
     typedef svo_base_buffer_t<svo_gpu_buffer_t> super_type;
     explicit svo_gpu_buffer_t(const svo_declaration_t& declaration, std::size_t initial_entries, svo_block_t* block, goffset_t start, goffset_t end);
 
+    ///only the last buffer of the block can be resized on its own; throws svo_bad_alloc if the block is full.
     void resize(std::size_t new_size);
+    ///gpu buffers are never shared; does nothing.
+    void make_writable();
     void assert_invariants() const;
-protected:
 
+    ///the goffset of the first entry.
+    goffset_t start() const;
+protected:
+    ///moves the buffer to @c start, with @c entries entries; does not move the bytes.
+    void relocate(goffset_t start, std::size_t entries);
 
     svo_block_t* m_block;
     goffset_t m_start;
     goffset_t m_end;
+
+    friend struct svo_gpu_buffers_t;
 };
 
 
@@ -210,6 +298,93 @@ namespace detail{
 }
 
 
+/**
+ * The data type and component count of an element that can be accessed as a @c T; see
+ *  svo_base_buffers_t::get_element_handle().
+ *
+ * Specialized for the fixed-width scalars; a vector type (e.g. float3_t) maps to its @c value_type, with as
+ *  many components as fit in it.
+ */
+template<typename T, typename enable_t = void>
+struct svo_element_traits_t;
+
+#define SVO_ELEMENT_TRAITS(T, DATA_TYPE)                                                \
+    template<>                                                                          \
+    struct svo_element_traits_t<T>{                                                     \
+        static constexpr svo_data_type_t type() { return svo_data_type_t::DATA_TYPE; }  \
+        static constexpr std::size_t count() { return 1; }                              \
+    };
+
+SVO_ELEMENT_TRAITS(int8_t, BYTE)
+SVO_ELEMENT_TRAITS(int16_t, SHORT)
+SVO_ELEMENT_TRAITS(int32_t, INT)
+SVO_ELEMENT_TRAITS(int64_t, LONG)
+SVO_ELEMENT_TRAITS(uint8_t, UNSIGNED_BYTE)
+SVO_ELEMENT_TRAITS(uint16_t, UNSIGNED_SHORT)
+SVO_ELEMENT_TRAITS(uint32_t, UNSIGNED_INT)
+SVO_ELEMENT_TRAITS(uint64_t, UNSIGNED_LONG)
+SVO_ELEMENT_TRAITS(float, FLOAT)
+SVO_ELEMENT_TRAITS(double, DOUBLE)
+
+#undef SVO_ELEMENT_TRAITS
+
+template<typename T>
+struct svo_element_traits_t<T, typename std::enable_if<std::is_class<T>::value>::type>{
+    typedef typename T::value_type value_type;
+    static_assert(sizeof(T) % sizeof(value_type) == 0, "a vector must be tightly packed");
+
+    static constexpr svo_data_type_t type() { return svo_element_traits_t<value_type>::type(); }
+    static constexpr std::size_t count() { return sizeof(T) / sizeof(value_type); }
+};
+
+/**
+ * A named element of a schema, resolved once by svo_base_buffers_t::get_element_handle(), to access it
+ *  as a @c T without looking the name up again.
+ *
+ * A handle is valid for any buffers with the schema it was resolved on; e.g. resolve it on one slice, and
+ *  use it on all the slices of a hierarchy.
+ */
+template<typename T>
+struct svo_element_handle_t{
+    ///an invalid handle.
+    svo_element_handle_t();
+
+    bool valid() const;
+    std::size_t buffer_index() const;
+    ///the byte offset of the element within an entry of its buffer.
+    std::size_t offset() const;
+private:
+    svo_element_handle_t(std::size_t buffer_index, std::size_t offset);
+
+    std::size_t m_buffer_index;
+    std::size_t m_offset;
+
+    template<typename svo_buffer_t, typename svo_buffers_t>
+    friend struct svo_base_buffers_t;
+};
+
+/**
+ * The values of an element, as a @c T (or a const @c T), in the buffer that holds them.
+ *
+ * Access is a multiply-add, and checks the index only in debug builds; the stride is the size of @c T if the
+ *  element is planar (see svo_layout_t).
+ */
+template<typename T>
+struct svo_typed_element_view_t{
+    typedef typename std::conditional<std::is_const<T>::value, const uint8_t, uint8_t>::type byte_t;
+
+    svo_typed_element_view_t(byte_t* ptr, std::size_t stride, std::size_t entries);
+
+    T& operator[](std::size_t entry_index) const;
+    std::size_t stride() const;
+    std::size_t entries() const;
+private:
+    byte_t* m_ptr;
+    std::size_t m_stride;
+    std::size_t m_entries;
+};
+
+
 template<typename svo_buffer_t, typename svo_buffers_t>
 struct svo_base_buffers_t{
     
@@ -233,6 +408,16 @@ struct svo_base_buffers_t{
     const detail::svo_element_view_t<const uint8_t, const svo_buffer_t> get_element_view(const std::string& element_name) const;
     detail::svo_element_view_t<uint8_t, svo_buffer_t> get_element_view(const std::string& element_name);
 
+    ///resolves @c element_name; throws if there is no such element, or if its type and count are not those of
+    /// @c T (see svo_element_traits_t).
+    template<typename T>
+    svo_element_handle_t<T> get_element_handle(const std::string& element_name) const;
+    ///O(1); @c handle must have been resolved on buffers with the same schema.
+    template<typename T>
+    svo_typed_element_view_t<const T> get_element_view(const svo_element_handle_t<T>& handle) const;
+    template<typename T>
+    svo_typed_element_view_t<T> get_element_view(const svo_element_handle_t<T>& handle);
+
     void assert_invariants() const;
 
     void copy_schema(const svo_base_buffers_t& other, std::size_t new_entries=0);
@@ -245,6 +430,12 @@ struct svo_base_buffers_t{
 
 protected:
     explicit svo_base_buffers_t();
+
+    ///checks that the elements of @c declaration are not in these buffers yet, and maps them to the buffer
+    /// about to be added.
+    void add_element_mappings(const svo_declaration_t& declaration);
+    ///adds a buffer for each plane of a planar @c declaration; returns the first.
+    svo_buffer_t& add_planar_buffers(const svo_declaration_t& declaration, std::size_t initial_entries);
 protected:
 
     ///actual storage of buffers
@@ -266,12 +457,22 @@ struct svo_cpu_buffers_t : svo_base_buffers_t<svo_cpu_buffer_t, svo_cpu_buffers_
     
     svo_cpu_buffers_t(const svo_cpu_buffers_t&) = delete;
     svo_cpu_buffers_t& operator=(const svo_cpu_buffers_t&) = delete;
-    explicit svo_cpu_buffers_t();
+    ///if @c arena is not null, the storage of the buffers is allocated from it.
+    explicit svo_cpu_buffers_t(svo_arena_t* arena = nullptr);
 
-    ///add buffer.
+    ///add buffer; a planar declaration adds a buffer per element, and returns the first.
     svo_cpu_buffer_t& add_buffer(const svo_declaration_t& declaration, std::size_t initial_entries=0);
 
+    ///replaces the buffers with views of the buffers of @c other, which share its storage; see svo_cpu_buffer_t.
+    ///The storage is only shared if @c other allocates from the same arena, and copied otherwise; see
+    /// svo_cpu_buffer_t::set_arena().
+    void share_buffers(const svo_cpu_buffers_t& other);
+
     void reset();
+
+    svo_arena_t* arena() const;
+private:
+    svo_arena_t* m_arena;
 };
 
 struct svo_gpu_buffers_t : svo_base_buffers_t<svo_gpu_buffer_t, svo_gpu_buffers_t>{
@@ -281,9 +482,15 @@ struct svo_gpu_buffers_t : svo_base_buffers_t<svo_gpu_buffer_t, svo_gpu_buffers_
     svo_gpu_buffers_t& operator=(const svo_gpu_buffers_t&) = delete;
     explicit svo_gpu_buffers_t(svo_block_t* block);
 
-    ///add buffer.
+    ///add buffer; a planar declaration adds a buffer per element, and returns the first.
     svo_gpu_buffer_t& add_buffer(const svo_declaration_t& declaration, std::size_t initial_entries=0);
 
+    /**
+     * Resizes all the buffers, moving them so that they stay back to back from the block's @c data_start;
+     *  new entries are zeroed. Throws svo_bad_alloc if they do not fit in the block's data section.
+     */
+    void resize(std::size_t new_entries);
+
     void assert_invariants() const;
 private:
     svo_block_t* m_block;
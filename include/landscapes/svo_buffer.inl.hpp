@@ -217,6 +217,14 @@ inline void svo_element_t::assert_invariants() const
 
 inline svo_declaration_t::svo_declaration_t()
     : m_stride(0)
+    , m_layout(svo_layout_t::INTERLEAVED)
+{
+    assert_invariants();
+}
+
+inline svo_declaration_t::svo_declaration_t(svo_layout_t layout)
+    : m_stride(0)
+    , m_layout(layout)
 {
     assert_invariants();
 }
@@ -263,10 +271,30 @@ inline std::size_t svo_declaration_t::stride() const
     return m_stride;
 }
 
+inline svo_layout_t svo_declaration_t::layout() const
+{
+    return m_layout;
+}
+
+inline std::vector<svo_declaration_t> svo_declaration_t::planes() const
+{
+    assert_invariants();
+    if (m_layout == svo_layout_t::INTERLEAVED)
+        return std::vector<svo_declaration_t>(1, *this);
+
+    std::vector<svo_declaration_t> result;
+    for (const auto& element : m_elements)
+    {
+        result.push_back(svo_declaration_t());
+        result.back().add(element);
+    }
+    return result;
+}
+
 inline bool svo_declaration_t::operator==(const svo_declaration_t& other) const
 {
     assert_invariants();
-    return m_elements == other.m_elements;
+    return m_elements == other.m_elements && m_layout == other.m_layout;
 }
 
 inline bool svo_declaration_t::operator!=(const svo_declaration_t& other) const
@@ -380,6 +408,7 @@ svo_base_buffer_t<svo_buffer_t>::
 rawdata()
 {
     self().assert_invariants();
+    self().make_writable();
     return m_rawdata;
 }
 
@@ -439,6 +468,18 @@ void convert_and_copy_element(uint8_t* dst_begin, uint8_t* dst_end, const uint8_
         , std::size_t dst_stride, std::size_t src_stride
         , std::size_t vector_width);
 
+/**
+ * Copy @c element_bytes bytes from each of @c copy_entries entries of one buffer to the other.
+ *
+ * If both elements are packed (the stride is the element size), this is a single memcpy; otherwise each
+ *  entry is copied with a fixed size memcpy for the common element sizes, which compiles to a single
+ *  load and store.
+ */
+inline void copy_strided_element(uint8_t* dst_begin, const uint8_t* src_begin
+        , std::size_t copy_entries
+        , std::size_t dst_stride, std::size_t src_stride
+        , std::size_t element_bytes);
+
 /**
  * Convert and copy the data from one element of buffer to an element of the other, given the buffers,
  * and specifying which elements, but *without* the compile-time data types of the two buffers elements.
@@ -476,7 +517,7 @@ copy_from_buffer(dst_buffer_t& dst_buffer, const src_buffer_t& src_buffer
         throw std::runtime_error(fmt::format("dst data is not a valid range inside the dst buffer, dst_start: {}, copy_entries: {}, dst_buffer.entires: {}"
                                             , dst_start, copy_entries, dst_buffer.entries()));
 
-    const auto& src_elements = dst_buffer.declaration().elements();
+    const auto& src_elements = src_buffer.declaration().elements();
     const auto& dst_elements = dst_buffer.declaration().elements();
     
     if (dst_elements.size() != src_elements.size())
@@ -545,10 +586,10 @@ copy_element_from_buffer(dst_buffer_t& dst_buffer, const src_buffer_t& src_buffe
         copy_entries = src_buffer.entries();
 
 
-    if (src_element_index < src_buffer.declaration().elements().size())
+    if (src_element_index >= src_buffer.declaration().elements().size())
         throw std::runtime_error(fmt::format("invalid element index, src_element_index: {}, elements().size(): {}"
                                             , src_element_index, src_buffer.declaration().elements().size()));
-    if (dst_element_index < dst_buffer.declaration().elements().size())
+    if (dst_element_index >= dst_buffer.declaration().elements().size())
         throw std::runtime_error(fmt::format("invalid element index, dst_element_index: {}, elements().size(): {}"
                                             , dst_element_index, dst_buffer.declaration().elements().size()));
 
@@ -566,8 +607,8 @@ copy_element_from_buffer(dst_buffer_t& dst_buffer, const src_buffer_t& src_buffe
     const auto& src_element = src_buffer.declaration().elements()[src_element_index];
     const auto& dst_element = dst_buffer.declaration().elements()[dst_element_index];
 
-    if (src_element.count() == dst_element.count())
-        throw std::runtime_error(fmt::format("elements are not convertible"
+    if (src_element.count() != dst_element.count())
+        throw std::runtime_error(fmt::format("elements are not convertible, "
                                              "src_element: {}, dst_element: {}"
                                             , src_element, dst_element));
 
@@ -578,9 +619,6 @@ copy_element_from_buffer(dst_buffer_t& dst_buffer, const src_buffer_t& src_buffe
     std::size_t src_stride = src_buffer.stride();
     std::size_t dst_stride = dst_buffer.stride();
 
-    std::size_t src_padding = src_stride - src_element_offset;
-    std::size_t dst_padding = dst_stride - dst_element_offset;
-
     const uint8_t* src_data = src_buffer.rawdata();
     uint8_t* dst_data = dst_buffer.rawdata();
 
@@ -592,45 +630,35 @@ copy_element_from_buffer(dst_buffer_t& dst_buffer, const src_buffer_t& src_buffe
     const uint8_t* src_end = src_begin + src_stride*copy_entries;
     uint8_t* dst_end = dst_begin + dst_stride*copy_entries;
     
-    ///if its the same type, it can get special handling
+    ///if its the same type, it is copied raw; e.g. re-layout between interleaved and planar buffers.
     if (src_element.type() == dst_element.type())
     {
         assert(src_element.bytes() == dst_element.bytes());
 
-        if (src_padding == 0 && dst_padding == 0)
-        {
-            ///if there are no holes,
-            ///copy it all in one shot.
-            std::memcpy(dst_begin, src_begin, copy_entries*src_element.bytes());
-            return;
-        }
+        copy_strided_element(dst_begin, src_begin, copy_entries, dst_stride, src_stride, src_element.bytes());
 
-        ///copy it over, raw element by raw element
-        uint8_t* dst_ptr = dst_begin;
-        const uint8_t* src_ptr = src_begin;
-        for (std::size_t i = 0; i < copy_entries; ++i)
-        {
-            assert(src_ptr >= src_begin);
-            assert(src_ptr < src_end);
-            assert(dst_ptr >= dst_begin);
-            assert(dst_ptr < dst_end);
-            
-            std::memcpy(dst_begin, src_ptr, src_element.bytes());
-            dst_ptr += dst_stride;
-            src_ptr += src_stride;
-        }
+        src_buffer.assert_invariants();
+        dst_buffer.assert_invariants();
         return;
     }
 
 
-    ///copy it over, element by element, and casting each vector subelements.
-    if (src_element.type() == svo_data_type_t::BYTE || src_element.type() == svo_data_type_t::UNSIGNED_BYTE)
+    ///copy it over, element by element, and casting each vector subelements; signed types are sign extended.
+    if (src_element.type() == svo_data_type_t::BYTE)
+        convert_and_copy_element_switch<int8_t>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, dst_element, src_element);
+    else if (src_element.type() == svo_data_type_t::UNSIGNED_BYTE)
         convert_and_copy_element_switch<uint8_t>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, dst_element, src_element);
-    else if (src_element.type() == svo_data_type_t::SHORT || src_element.type() == svo_data_type_t::UNSIGNED_SHORT)
+    else if (src_element.type() == svo_data_type_t::SHORT)
+        convert_and_copy_element_switch<int16_t>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, dst_element, src_element);
+    else if (src_element.type() == svo_data_type_t::UNSIGNED_SHORT)
         convert_and_copy_element_switch<uint16_t>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, dst_element, src_element);
-    else if (src_element.type() == svo_data_type_t::INT || src_element.type() == svo_data_type_t::UNSIGNED_INT)
+    else if (src_element.type() == svo_data_type_t::INT)
+        convert_and_copy_element_switch<int32_t>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, dst_element, src_element);
+    else if (src_element.type() == svo_data_type_t::UNSIGNED_INT)
         convert_and_copy_element_switch<uint32_t>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, dst_element, src_element);
-    else if (src_element.type() == svo_data_type_t::LONG || src_element.type() == svo_data_type_t::UNSIGNED_LONG)
+    else if (src_element.type() == svo_data_type_t::LONG)
+        convert_and_copy_element_switch<int64_t>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, dst_element, src_element);
+    else if (src_element.type() == svo_data_type_t::UNSIGNED_LONG)
         convert_and_copy_element_switch<uint64_t>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, dst_element, src_element);
     else if (src_element.type() == svo_data_type_t::FLOAT)
         convert_and_copy_element_switch<float>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, dst_element, src_element);
@@ -658,8 +686,9 @@ assert_invariants() const
 {
     super_type::assert_invariants();
 
-    assert(m_data.size() == m_entries*m_declaration.stride());
-    assert(m_rawdata == reinterpret_cast<const uint8_t*>(m_data.data()));
+    assert(m_storage);
+    assert(m_storage_offset + m_entries*m_declaration.stride() <= m_storage->size());
+    assert(m_rawdata == m_storage->data() + m_storage_offset || m_entries == 0);
 
 
 }
@@ -755,7 +784,7 @@ get_element_view(const std::string& element_name) const
     assert(element_index < buffer.declaration().elements().size());
 
     typedef detail::svo_element_view_t<const uint8_t, const svo_buffer_t> result_t;
-    return result_t( &buffer, element_index, buffer.rawdata(), buffer.stride(), buffer.entries() );
+    return result_t( &buffer, element_index, buffer.rawdata() + buffer.declaration().offset(element_index), buffer.stride(), buffer.entries() );
 }
 
 
@@ -782,7 +811,70 @@ get_element_view(const std::string& element_name)
     assert(element_index < buffer.declaration().elements().size());
 
     typedef detail::svo_element_view_t<uint8_t, svo_buffer_t> result_t;
-    return result_t( &buffer, element_index, buffer.rawdata(), buffer.stride(), buffer.entries() );
+    return result_t( &buffer, element_index, buffer.rawdata() + buffer.declaration().offset(element_index), buffer.stride(), buffer.entries() );
+}
+
+
+template<typename svo_buffer_t, typename svo_buffers_t>
+template<typename T>
+svo_element_handle_t<T>
+svo_base_buffers_t<svo_buffer_t, svo_buffers_t>::
+get_element_handle(const std::string& element_name) const
+{
+    self().assert_invariants();
+
+    auto w = m_buffer_element_mappings.find(element_name);
+
+    if (w == m_buffer_element_mappings.end())
+        throw std::runtime_error(fmt::format("buffer does not contain element {}", quote(element_name)));
+
+    std::size_t buffer_index, element_index;
+    std::tie(buffer_index, element_index) = w->second;
+
+    assert(buffer_index < m_buffers.size());
+    const auto& declaration = m_buffers[buffer_index].declaration();
+    const auto& element = declaration.elements()[element_index];
+
+    typedef svo_element_traits_t<T> traits_t;
+
+    if (element.type() != traits_t::type() || element.count() != traits_t::count())
+        throw std::runtime_error(fmt::format("element {} is {}x{}, it cannot be accessed as {}x{}"
+                                            , quote(element_name)
+                                            , tostr(element.type()), element.count()
+                                            , tostr(traits_t::type()), traits_t::count()));
+    assert(element.bytes() == sizeof(T));
+
+    return svo_element_handle_t<T>(buffer_index, declaration.offset(element_index));
+}
+
+template<typename svo_buffer_t, typename svo_buffers_t>
+template<typename T>
+inline svo_typed_element_view_t<const T>
+svo_base_buffers_t<svo_buffer_t, svo_buffers_t>::
+get_element_view(const svo_element_handle_t<T>& handle) const
+{
+    assert(handle.valid());
+    assert(handle.buffer_index() < m_buffers.size());
+
+    const auto& buffer = m_buffers[handle.buffer_index()];
+    assert(handle.offset() + sizeof(T) <= buffer.stride());
+
+    return svo_typed_element_view_t<const T>(buffer.rawdata() + handle.offset(), buffer.stride(), buffer.entries());
+}
+
+template<typename svo_buffer_t, typename svo_buffers_t>
+template<typename T>
+inline svo_typed_element_view_t<T>
+svo_base_buffers_t<svo_buffer_t, svo_buffers_t>::
+get_element_view(const svo_element_handle_t<T>& handle)
+{
+    assert(handle.valid());
+    assert(handle.buffer_index() < m_buffers.size());
+
+    auto& buffer = m_buffers[handle.buffer_index()];
+    assert(handle.offset() + sizeof(T) <= buffer.stride());
+
+    return svo_typed_element_view_t<T>(buffer.rawdata() + handle.offset(), buffer.stride(), buffer.entries());
 }
 
 
@@ -889,6 +981,67 @@ assert_invariants() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+template<typename T>
+inline svo_element_handle_t<T>::svo_element_handle_t()
+    : m_buffer_index(std::size_t(-1))
+    , m_offset(0)
+{}
+
+template<typename T>
+inline svo_element_handle_t<T>::svo_element_handle_t(std::size_t buffer_index, std::size_t offset)
+    : m_buffer_index(buffer_index)
+    , m_offset(offset)
+{}
+
+template<typename T>
+inline bool svo_element_handle_t<T>::valid() const
+{
+    return m_buffer_index != std::size_t(-1);
+}
+
+template<typename T>
+inline std::size_t svo_element_handle_t<T>::buffer_index() const
+{
+    return m_buffer_index;
+}
+
+template<typename T>
+inline std::size_t svo_element_handle_t<T>::offset() const
+{
+    return m_offset;
+}
+
+template<typename T>
+inline svo_typed_element_view_t<T>::svo_typed_element_view_t(byte_t* ptr, std::size_t stride, std::size_t entries)
+    : m_ptr(ptr)
+    , m_stride(stride)
+    , m_entries(entries)
+{
+    assert(m_ptr || m_entries == 0);
+    assert(m_stride >= sizeof(T));
+}
+
+template<typename T>
+inline T& svo_typed_element_view_t<T>::operator[](std::size_t entry_index) const
+{
+    assert(entry_index < m_entries);
+    return *reinterpret_cast<T*>(m_ptr + entry_index*m_stride);
+}
+
+template<typename T>
+inline std::size_t svo_typed_element_view_t<T>::stride() const
+{
+    return m_stride;
+}
+
+template<typename T>
+inline std::size_t svo_typed_element_view_t<T>::entries() const
+{
+    return m_entries;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 namespace detail{
     template<typename byte_t, typename svo_buffer_t>
     svo_element_view_t<byte_t, svo_buffer_t>::
@@ -1034,18 +1187,26 @@ void convert_and_copy_element_switch(uint8_t* dst_begin, uint8_t* dst_end, const
     switch(dst_element.type())
     {
         case(svo_data_type_t::BYTE):
+            convert_and_copy_element<int8_t, src_type>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, vector_width);
+            break;
         case(svo_data_type_t::UNSIGNED_BYTE):
             convert_and_copy_element<uint8_t, src_type>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, vector_width);
             break;
         case(svo_data_type_t::SHORT):
+            convert_and_copy_element<int16_t, src_type>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, vector_width);
+            break;
         case(svo_data_type_t::UNSIGNED_SHORT):
             convert_and_copy_element<uint16_t, src_type>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, vector_width);
             break;
         case(svo_data_type_t::INT):
+            convert_and_copy_element<int32_t, src_type>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, vector_width);
+            break;
         case(svo_data_type_t::UNSIGNED_INT):
             convert_and_copy_element<uint32_t, src_type>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, vector_width);
             break;
         case(svo_data_type_t::LONG):
+            convert_and_copy_element<int64_t, src_type>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, vector_width);
+            break;
         case(svo_data_type_t::UNSIGNED_LONG):
             convert_and_copy_element<uint64_t, src_type>(dst_begin, dst_end, src_begin, src_end, copy_entries, dst_stride, src_stride, vector_width);
             break;
@@ -1062,6 +1223,37 @@ void convert_and_copy_element_switch(uint8_t* dst_begin, uint8_t* dst_end, const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+
+///converts @c count values between two packed arrays; the loop is flat, so the compiler vectorizes it.
+template<typename dst_type, typename src_type>
+inline void convert_packed(uint8_t* dst_begin, const uint8_t* src_begin, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        src_type src_value;
+        std::memcpy(&src_value, src_begin + i*sizeof(src_type), sizeof(src_type));
+        dst_type dst_value = static_cast<dst_type>(src_value);
+        std::memcpy(dst_begin + i*sizeof(dst_type), &dst_value, sizeof(dst_type));
+    }
+}
+
+///converts strided elements of a compile-time @c vector_width; each entry is one load, convert and store.
+template<typename dst_type, typename src_type, std::size_t vector_width>
+inline void convert_strided(uint8_t* dst_begin, const uint8_t* src_begin
+        , std::size_t copy_entries
+        , std::size_t dst_stride, std::size_t src_stride)
+{
+    for (std::size_t i = 0; i < copy_entries; ++i)
+    {
+        src_type src_values[vector_width];
+        dst_type dst_values[vector_width];
+        std::memcpy(src_values, src_begin + i*src_stride, sizeof(src_values));
+        for (std::size_t vector_subelement = 0; vector_subelement < vector_width; ++vector_subelement)
+            dst_values[vector_subelement] = static_cast<dst_type>(src_values[vector_subelement]);
+        std::memcpy(dst_begin + i*dst_stride, dst_values, sizeof(dst_values));
+    }
+}
+
 template<typename dst_type, typename src_type>
 void convert_and_copy_element(uint8_t* dst_begin, uint8_t* dst_end, const uint8_t* src_begin, const uint8_t* src_end
         , std::size_t copy_entries
@@ -1077,43 +1269,81 @@ void convert_and_copy_element(uint8_t* dst_begin, uint8_t* dst_end, const uint8_
     assert(src_end >= src_begin);
     assert(sizeof(dst_type)*vector_width <= dst_stride);
     assert(sizeof(src_type)*vector_width <= src_stride);
+    assert(dst_begin + dst_stride*copy_entries <= dst_end);
+    assert(src_begin + src_stride*copy_entries <= src_end);
 
+    ///both buffers hold only this element; convert it as one flat array.
+    if (dst_stride == sizeof(dst_type)*vector_width && src_stride == sizeof(src_type)*vector_width)
+    {
+        convert_packed<dst_type, src_type>(dst_begin, src_begin, copy_entries*vector_width);
+        return;
+    }
 
-    uint8_t* dst_ptr = dst_begin;
-    const uint8_t* src_ptr = src_begin;
-
-    std::size_t src_element_bytes = sizeof(src_type);
-    std::size_t dst_element_bytes = sizeof(dst_type);
-    std::size_t src_padding = src_stride - src_element_bytes;
-    std::size_t dst_padding = dst_stride - dst_element_bytes;
-
-
+    switch(vector_width)
+    {
+        case(1):
+            convert_strided<dst_type, src_type, 1>(dst_begin, src_begin, copy_entries, dst_stride, src_stride);
+            return;
+        case(2):
+            convert_strided<dst_type, src_type, 2>(dst_begin, src_begin, copy_entries, dst_stride, src_stride);
+            return;
+        case(3):
+            convert_strided<dst_type, src_type, 3>(dst_begin, src_begin, copy_entries, dst_stride, src_stride);
+            return;
+        case(4):
+            convert_strided<dst_type, src_type, 4>(dst_begin, src_begin, copy_entries, dst_stride, src_stride);
+            return;
+        default:
+            break;
+    }
 
     ///copy it over, element by element, and casting each vector subelements.
     for (std::size_t i = 0; i < copy_entries; ++i)
-    {
+        convert_packed<dst_type, src_type>(dst_begin + i*dst_stride, src_begin + i*src_stride, vector_width);
+}
 
-        for (std::size_t vector_subelement = 0; vector_subelement < vector_width; ++vector_subelement)
-        {
-            assert(dst_ptr >= dst_begin);
-            assert(src_ptr >= src_begin);
-            assert(dst_ptr < dst_end);
-            assert(src_ptr < src_end);
-            
-            src_type src_value = *reinterpret_cast<const src_type*>(src_ptr);
-            dst_type& dst_value = *reinterpret_cast<dst_type*>(dst_ptr);
+////////////////////////////////////////////////////////////////////////////////
 
-            
-            ///conversion
-            dst_value = src_value;
+///copies @c bytes bytes of each entry; a compile-time size makes the memcpy a single load and store.
+template<std::size_t bytes>
+inline void copy_strided_bytes(uint8_t* dst_begin, const uint8_t* src_begin
+        , std::size_t copy_entries
+        , std::size_t dst_stride, std::size_t src_stride)
+{
+    for (std::size_t i = 0; i < copy_entries; ++i)
+        std::memcpy(dst_begin + i*dst_stride, src_begin + i*src_stride, bytes);
+}
 
-            src_ptr += sizeof(src_type);
-            dst_ptr += sizeof(dst_type);
-        }
+inline void copy_strided_element(uint8_t* dst_begin, const uint8_t* src_begin
+        , std::size_t copy_entries
+        , std::size_t dst_stride, std::size_t src_stride
+        , std::size_t element_bytes)
+{
+    assert(element_bytes <= dst_stride);
+    assert(element_bytes <= src_stride);
 
-        dst_ptr += src_padding;
-        src_ptr += dst_padding;
+    ///if there are no holes, copy it all in one shot.
+    if (dst_stride == element_bytes && src_stride == element_bytes)
+    {
+        std::memcpy(dst_begin, src_begin, copy_entries*element_bytes);
+        return;
     }
+
+    switch(element_bytes)
+    {
+        case(1):  copy_strided_bytes<1>(dst_begin, src_begin, copy_entries, dst_stride, src_stride); return;
+        case(2):  copy_strided_bytes<2>(dst_begin, src_begin, copy_entries, dst_stride, src_stride); return;
+        case(4):  copy_strided_bytes<4>(dst_begin, src_begin, copy_entries, dst_stride, src_stride); return;
+        case(8):  copy_strided_bytes<8>(dst_begin, src_begin, copy_entries, dst_stride, src_stride); return;
+        case(12): copy_strided_bytes<12>(dst_begin, src_begin, copy_entries, dst_stride, src_stride); return;
+        case(16): copy_strided_bytes<16>(dst_begin, src_begin, copy_entries, dst_stride, src_stride); return;
+        default:
+            break;
+    }
+
+    ///copy it over, raw element by raw element
+    for (std::size_t i = 0; i < copy_entries; ++i)
+        std::memcpy(dst_begin + i*dst_stride, src_begin + i*src_stride, element_bytes);
 }
 
 } //namespace detail
@@ -0,0 +1,29 @@
+#ifndef SVO_CRC32C_HPP
+#define SVO_CRC32C_HPP 1
+
+#include <cstddef>
+#include <cstdint>
+
+namespace svo{
+
+
+/**
+ * CRC-32C (Castagnoli) of @c bytes bytes at @c data.
+ *
+ * Pass the result of a previous call as @c crc to continue a checksum over several pieces; the result
+ *  is the same as one call over the concatenated data.
+ *
+ * Uses the SSE4.2 @c crc32 instruction when the CPU has it, and a slicing-by-8 table otherwise.
+ */
+uint32_t svo_crc32c(const void* data, std::size_t bytes, uint32_t crc = 0);
+
+///the portable implementation of svo_crc32c(); exposed for testing.
+uint32_t svo_crc32c_sw(const void* data, std::size_t bytes, uint32_t crc = 0);
+
+///true if svo_crc32c() uses the hardware instruction on this CPU.
+bool svo_crc32c_hw_available();
+
+
+} //namespace svo
+
+#endif
@@ -15,11 +15,22 @@ extern "C"{
 
 
 
+// Define SVO_VCURVE_64 (the SVO_VCURVE_64 CMake option) to use 64 bit curves, which allow slices with
+// sides of up to 2^21 voxels instead of 256. It changes the type of every vcurve in the library, so the
+// library and everything using it must agree on it.
+#ifdef SVO_VCURVE_64
+///Volume curve type; this is a 3d integer coordinate encoded into a straightline,
+/// long-array-volume index using one of several encoding techniques.
+typedef uint64_t vcurve_t;
+///type used to specify the length of an entire long-volume-array.
+typedef uint64_t vcurvesize_t;
+#else
 ///Volume curve type; this is a 3d integer coordinate encoded into a straightline,
 /// long-array-volume index using one of several encoding techniques.
 typedef uint32_t vcurve_t;
 ///type used to specify the length of an entire long-volume-array.
 typedef uint32_t vcurvesize_t;
+#endif
 ///This is the type used to specify the length of a side of a 3d-long-array-volume.
 typedef uint32_t vside_t;
 
@@ -28,9 +39,18 @@ typedef uint32_t vside_t;
 // 3D spaces, that means the largest allowed vside must take the size of types `vside_t` and
 // `vcurve_t` into account. Furthermore, the utility functions that use these types can be
 // optimized if they can assume limits to `vside_t` types.
+#ifdef SVO_VCURVE_64
+static const size_t SVO_VSIDE_LIMIT = 2097152;
+// see SVO_VSIDE_LIMIT
+static const size_t SVO_VSIDE_BITS = 21;
+#else
 static const size_t SVO_VSIDE_LIMIT = 256;
 // see SVO_VSIDE_LIMIT
 static const size_t SVO_VSIDE_BITS = 8;
+#endif
+
+// The side covered by the coords2vcurve() lookup tables; larger coordinates are looked up a byte at a time.
+static const size_t SVO_MORTON_TABLE_SIDE = 256;
 
 static const size_t SVO_VCURVE_LIMIT = SVO_VSIDE_LIMIT*SVO_VSIDE_LIMIT*SVO_VSIDE_LIMIT;
 
@@ -220,16 +240,29 @@ GLOBAL_STATIC_CONST uint32_t morton256_z[256] = {
 
 
 
+// Gathers every third bit of @c curve, starting with bit 0, into the low 10 bits of the result.
+//
+// Uses "magic number" masks: each step halves the gaps between the wanted bits, so it takes 4 shifts
+// and masks instead of one iteration per bit.
 static inline uint32_t uninterleave32_3(uint32_t curve)
 {
-    uint32_t result = 0;
-    size_t bitsize = sizeof(uint32_t)*8;
-    for (size_t i = 0; i < (bitsize / 3);  ++i)
-    {
-        uint32_t bit = (curve >> (i*3)) & 1;
-        result |= bit << i;
-    }
+    uint32_t result = curve & 0x09249249;
+    result = (result ^ (result >>  2)) & 0x030C30C3;
+    result = (result ^ (result >>  4)) & 0x0300F00F;
+    result = (result ^ (result >>  8)) & 0xFF0000FF;
+    result = (result ^ (result >> 16)) & 0x000003FF;
+    return result;
+}
 
+// Same as uninterleave32_3(), for the low 21 bits of a 64 bit curve.
+static inline uint64_t uninterleave64_3(uint64_t curve)
+{
+    uint64_t result = curve & 0x1249249249249249ULL;
+    result = (result ^ (result >>  2)) & 0x10C30C30C30C30C3ULL;
+    result = (result ^ (result >>  4)) & 0x100F00F00F00F00FULL;
+    result = (result ^ (result >>  8)) & 0x001F0000FF0000FFULL;
+    result = (result ^ (result >> 16)) & 0x001F00000000FFFFULL;
+    result = (result ^ (result >> 32)) & 0x00000000001FFFFFULL;
     return result;
 }
 
@@ -237,9 +270,15 @@ static inline void vcurve2coords(vcurve_t vcurve, vside_t side, vside_t* x, vsid
 {
     UNUSED(side);
 
+#ifdef SVO_VCURVE_64
+    *x = (vside_t)uninterleave64_3(vcurve >> 0);
+    *y = (vside_t)uninterleave64_3(vcurve >> 1);
+    *z = (vside_t)uninterleave64_3(vcurve >> 2);
+#else
     *x = uninterleave32_3(vcurve >> 0);
     *y = uninterleave32_3(vcurve >> 1);
     *z = uninterleave32_3(vcurve >> 2);
+#endif
 }
 
 static inline vcurve_t coords2vcurve(vside_t x, vside_t y, vside_t z, vside_t side)
@@ -250,8 +289,19 @@ static inline vcurve_t coords2vcurve(vside_t x, vside_t y, vside_t z, vside_t si
     assert(z < side);
     assert(side <= SVO_VSIDE_LIMIT);
 
+#ifdef SVO_VCURVE_64
+    // one lookup per byte of the coordinates; each byte spreads over 24 bits of the curve.
+    vcurve_t index = 0;
+    for (size_t shift = 0; shift < SVO_VSIDE_BITS; shift += 8)
+    {
+        uint32_t part = morton256_x[(x >> shift) & 0xFF] | morton256_y[(y >> shift) & 0xFF] | morton256_z[(z >> shift) & 0xFF];
+        index |= (vcurve_t)part << (shift*3);
+    }
+    return index;
+#else
     uint32_t index = morton256_x[x] | morton256_y[y] | morton256_z[z];
     return index;
+#endif
 }
 
 
@@ -314,7 +364,7 @@ static inline vcurve_t coords2vcurve_brute(vside_t x, vside_t y, vside_t z, vsid
     {
         for (size_t j = 0; j < 3; ++j)
         {
-            vside_t bit = (xyz[j] >> i) & 1;
+            vcurve_t bit = (xyz[j] >> i) & 1;
             size_t shift = i*3 + j;
             vcurve |= (bit << shift);
         }
@@ -0,0 +1,124 @@
+#ifndef SVO_EDIT_LOG_HPP
+#define SVO_EDIT_LOG_HPP 1
+
+#include <iosfwd>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <future>
+#include <cstddef>
+#include <cstdint>
+#include "svo_curves.h"
+#include "svo_tree.fwd.hpp"
+#include "svo_archive.hpp"
+
+namespace svo{
+
+
+enum class svo_edit_op_t : uint8_t{
+    ///adds a voxel, or replaces it if it exists; @c data holds one entry of each buffer, in schema order.
+      insert
+    ///removes a voxel, if it exists.
+    , erase
+    ///overwrites one element of an existing voxel; @c data holds the element's bytes.
+    , update
+};
+
+///One voxel edit, keyed by the archive id of its slice and its vcurve within the slice.
+struct svo_edit_t{
+    svo_edit_t();
+
+    svo_edit_op_t op;
+    svo_slice_id_t slice_id;
+    vcurve_t vcurve;
+    ///for @c update, the name of the element.
+    std::string element;
+    std::vector<uint8_t> data;
+};
+
+
+/**
+ * Reads the edits of an edit log, in the order they were appended.
+ *
+ * A record cut short at the end of the log, e.g. by a crash while appending, ends the log; its offset
+ *  is returned in @c valid_end, if given. Any other malformed record throws @c std::runtime_error.
+ */
+std::vector<svo_edit_t> svo_read_edit_log(std::istream& in, uint64_t* valid_end = nullptr);
+
+/**
+ * Applies @c edits, in order, to a loaded slice.
+ *
+ * The edits are folded per vcurve first and then merged with the slice in one pass, so applying @c k
+ *  edits costs O(n + k log k) rather than @c k insertions. Updates of voxels that do not exist are ignored.
+ */
+void svo_apply_edits(svo_slice_t* slice, const std::vector<const svo_edit_t*>& edits);
+
+
+/**
+ * An append-only log of voxel edits, persisted to a file.
+ *
+ * Each edit is one small checksummed record, so an edit costs a write proportional to the edit rather
+ *  than to its slice. compact() folds the log into a slice archive with svo_archive_update_slices(),
+ *  rewriting only the slices that were edited, and then drops the folded records from the log.
+ *
+ * Layout: 4 byte magic "SVOE", u32 version, and a byte order mark in host order; then the records, each
+ *  a section (see svo_write_section()) holding u8 op, u32 slice id, u64 vcurve, and for @c insert the
+ *  u32 size and bytes of @c data, for @c update the element name, the u32 size and the bytes of @c data.
+ *  The voxel data is in host byte order, so a log can only be read on a host with the same byte order.
+ *
+ * All methods are thread safe; appends can continue while a compaction runs.
+ */
+struct svo_edit_log_t{
+    /**
+     * Opens the log at @c path for appending, creating it if it does not exist.
+     *
+     * A torn record at the end of an existing log is cut off, and a log of an older version is rewritten
+     *  in the current one.
+     */
+    explicit svo_edit_log_t(const std::string& path);
+    svo_edit_log_t(const svo_edit_log_t&) = delete;
+    svo_edit_log_t& operator=(const svo_edit_log_t&) = delete;
+
+    void insert(svo_slice_id_t slice_id, vcurve_t vcurve, const std::vector<uint8_t>& entry);
+    void erase(svo_slice_id_t slice_id, vcurve_t vcurve);
+    void update(svo_slice_id_t slice_id, vcurve_t vcurve, const std::string& element, const void* data, std::size_t bytes);
+    void append(const svo_edit_t& edit);
+
+    ///flushes the appended records to the file.
+    void flush();
+
+    ///number of records in the log.
+    std::size_t size() const;
+
+    /**
+     * Folds the records in the log into the archive in @c archive, and removes them from the log.
+     *
+     * Records appended while compacting are kept for the next compaction. Nothing else may use
+     *  @c archive until this returns.
+     *
+     * The edited slices are appended to the archive, and their old versions are left behind as dead
+     *  space (see svo_archive_update_slices()); use svo_rewrite_archive() from time to time to reclaim it.
+     */
+    void compact(std::iostream& archive, const svo_serialization_options_t& options = svo_serialization_options_t());
+
+    ///runs compact() on a background thread.
+    std::future<void> compact_async(std::iostream& archive, const svo_serialization_options_t& options = svo_serialization_options_t());
+
+private:
+    void open_for_append();
+
+    std::string m_path;
+    mutable std::mutex m_mutex;
+    ///serializes compactions.
+    std::mutex m_compact_mutex;
+    std::ofstream m_out;
+    ///file offset past the last record.
+    uint64_t m_end;
+    std::size_t m_size;
+};
+
+
+} //namespace svo
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SVO_IMPORT_HPP
+#define SVO_IMPORT_HPP 1
+
+#include <iosfwd>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "svo_tree.fwd.hpp"
+#include "svo_buffer.fwd.hpp"
+
+namespace svo{
+
+
+/**
+ * Predicate telling whether the voxel at @c entry, one entry in the layout of the import's declaration,
+ *  is empty. Empty voxels are not imported.
+ */
+typedef std::function<bool(const uint8_t* entry)> svo_import_empty_fn_t;
+
+
+/**
+ * Imports a list of points into a volume of slices.
+ *
+ * Point @c i is at the voxel with coordinates @c coords[3*i], @c coords[3*i+1], @c coords[3*i+2], in
+ *  voxels of the whole volume, which has a side of @c volume.volume_side*volume.slice_side voxels; its
+ *  attributes are entry @c i of @c attributes, in the layout of @c declaration. If several points fall
+ *  on the same voxel, the last one wins.
+ *
+ * The points may come in any order; they are sorted by their Morton code (the slice's vcurve within the
+ *  volume, followed by the voxel's vcurve within the slice) with a parallel radix sort, and each
+ *  non-empty slice is then filled in one pass.
+ *
+ * @c volume.slices must be empty; it receives a new level 0 slice, with one buffer of @c declaration,
+ *  for each slice of the volume that has points, in vcurve order. The slices are owned by the caller.
+ *
+ * Throws @c std::runtime_error if a point is outside of the volume.
+ */
+void svo_import_points(volume_of_slices_t& volume, const svo_declaration_t& declaration
+                        , const vside_t* coords, const void* attributes, std::size_t count
+                        , std::size_t num_threads = 1);
+
+/**
+ * Imports a dense grid of voxels into a volume of slices.
+ *
+ * The grid has @c width*height*depth voxels of @c declaration.stride() bytes each, with @c x varying
+ *  fastest, then @c y, then @c z; it is placed at the origin of the volume, and must fit in it. Voxels
+ *  for which @c is_empty returns true are skipped; by default, a voxel is empty if all its bytes are zero.
+ *
+ * The output is as for svo_import_points().
+ */
+void svo_import_dense(volume_of_slices_t& volume, const svo_declaration_t& declaration
+                        , const void* data, vside_t width, vside_t height, vside_t depth
+                        , std::size_t num_threads = 1, const svo_import_empty_fn_t& is_empty = svo_import_empty_fn_t());
+
+///Same as above, reading the raw grid from a stream.
+void svo_import_dense(volume_of_slices_t& volume, const svo_declaration_t& declaration
+                        , std::istream& in, vside_t width, vside_t height, vside_t depth
+                        , std::size_t num_threads = 1, const svo_import_empty_fn_t& is_empty = svo_import_empty_fn_t());
+
+
+} //namespace svo
+
+#endif
@@ -27,4 +27,10 @@ typedef uint8_t child_mask_t;
 
 static const goffset_t invalid_goffset = (goffset_t)(-1);
 
+///the deepest level a traversal descends to; sizes the traversal stacks of the raymarcher
+/// (svo_tree.raymarch.h) and of the tree traversals (svo_tree.inl.hpp), and caps svo_lod_max_level().
+#ifndef MAXIMUM_TREE_DEPTH
+#define MAXIMUM_TREE_DEPTH 30
+#endif
+
 #endif
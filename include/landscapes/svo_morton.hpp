@@ -0,0 +1,39 @@
+#ifndef SVO_MORTON_HPP
+#define SVO_MORTON_HPP 1
+
+#include <cstddef>
+#include <cstdint>
+#include "svo_curves.h"
+
+namespace svo{
+
+
+/**
+ * Encodes @c n coordinates to vcurves, the same as coords2vcurve().
+ *
+ * Point @c i is @c coords[3*i], @c coords[3*i+1], @c coords[3*i+2]; its vcurve is written to
+ *  @c vcurves[i]. Only the low 10 bits of each coordinate are used, or 21 with @c SVO_VCURVE_64.
+ *
+ * Uses the BMI2 @c pdep instruction when the CPU has it, and branch free "magic number" bit spreading
+ *  otherwise, which compilers vectorize over the batch.
+ */
+void svo_morton_encode_n(const vside_t* coords, vcurve_t* vcurves, std::size_t n);
+
+/**
+ * Decodes @c n vcurves to coordinates, the same as vcurve2coords(); the inverse of svo_morton_encode_n().
+ *
+ * Uses the BMI2 @c pext instruction when the CPU has it.
+ */
+void svo_morton_decode_n(const vcurve_t* vcurves, vside_t* coords, std::size_t n);
+
+///the portable implementations of svo_morton_encode_n() and svo_morton_decode_n(); exposed for testing.
+void svo_morton_encode_n_portable(const vside_t* coords, vcurve_t* vcurves, std::size_t n);
+void svo_morton_decode_n_portable(const vcurve_t* vcurves, vside_t* coords, std::size_t n);
+
+///true if svo_morton_encode_n() and svo_morton_decode_n() use BMI2 on this CPU.
+bool svo_morton_bmi2_available();
+
+
+} //namespace svo
+
+#endif
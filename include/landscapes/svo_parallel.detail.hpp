@@ -0,0 +1,52 @@
+#ifndef SVO_PARALLEL_DETAIL_HPP
+#define SVO_PARALLEL_DETAIL_HPP 1
+
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+
+namespace svo{
+
+
+/**
+ * Runs @c fn(thread_index) on @c num_threads threads, the calling thread being one of them, and
+ *  rethrows the first exception thrown by any of them.
+ */
+template<typename fn_t>
+static inline void run_parallel(std::size_t num_threads, const fn_t& fn)
+{
+    num_threads = std::max<std::size_t>(num_threads, 1);
+
+    std::vector<std::exception_ptr> errors(num_threads);
+    auto guarded = [&fn, &errors](std::size_t thread_index){
+        try {
+            fn(thread_index);
+        } catch (...) {
+            errors[thread_index] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t thread_index = 1; thread_index < num_threads; ++thread_index)
+        threads.emplace_back(guarded, thread_index);
+    guarded(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+///the bounds of chunk @c chunk_index of @c size items split into @c chunks chunks.
+static inline std::size_t chunk_begin(std::size_t size, std::size_t chunks, std::size_t chunk_index)
+{
+    return size * chunk_index / chunks;
+}
+
+
+} //namespace svo
+
+#endif
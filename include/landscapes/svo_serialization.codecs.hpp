@@ -0,0 +1,54 @@
+#ifndef SVO_SERALIZATION_CODECS_HPP
+#define SVO_SERALIZATION_CODECS_HPP 1
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "svo_buffer.fwd.hpp"
+#include "svo_serialization.detail.hpp"
+
+namespace svo{
+
+
+///How one element (column) of a buffer is stored in a v2 stream.
+enum class svo_element_codec_t{
+    ///the raw column, each component in the stream's byte order.
+      none
+    ///a table of the distinct values, plus an 8 or 16 bit index per entry; good for colors/materials.
+    , palette
+    ///lossy; FLOAT/DOUBLE components scaled into [min,max] per component and bit-packed with a fixed number of bits.
+    , quantize
+    ///the raw column, deflated with zlib.
+    , zlib
+};
+
+struct svo_element_codec_params_t{
+    svo_element_codec_params_t();
+
+    svo_byte_order_t byte_order;
+    ///bits per quantized component, in [1,16].
+    uint32_t quantize_bits;
+    ///zlib compression level, in [0,9], or -1 for zlib's default.
+    int zlib_level;
+};
+
+/**
+ * Encodes element @c element_index of @c buffer into @c encoded.
+ *
+ * Returns the codec actually used; when @c codec does not apply to the element (e.g. quantizing
+ *  integers or non-finite values, or a palette that would be too large), the column is stored with
+ *  @c svo_element_codec_t::none.
+ */
+svo_element_codec_t svo_encode_element(const svo_cpu_buffer_t& buffer, std::size_t element_index
+                                        , svo_element_codec_t codec, const svo_element_codec_params_t& params
+                                        , std::vector<uint8_t>& encoded);
+
+///decodes a column encoded by svo_encode_element() into element @c element_index of @c buffer; throws on malformed input.
+void svo_decode_element(svo_cpu_buffer_t& buffer, std::size_t element_index
+                        , svo_element_codec_t codec, svo_byte_order_t byte_order
+                        , const uint8_t* encoded, std::size_t bytes);
+
+
+} //namespace svo
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef SVO_SERALIZATION_DETAIL_HPP
+#define SVO_SERALIZATION_DETAIL_HPP 1
+
+#include <iostream>
+#include <streambuf>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <stdexcept>
+#include "svo_curves.h"
+
+namespace svo{
+
+///Byte order of a bulk payload in a serialized stream.
+enum class svo_byte_order_t{
+      little
+    , big
+};
+
+static inline svo_byte_order_t svo_host_byte_order()
+{
+    const uint16_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1 ? svo_byte_order_t::little : svo_byte_order_t::big;
+}
+
+
+///writes @c v big-endian, one byte at a time; used for headers and other small fields.
+template<typename T>
+static inline void serialize_uint(std::ostream& out, T v)
+{
+    T bmask = 255;
+
+    uint8_t buffer[sizeof(T)];
+
+
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        uint8_t byte = (v >> (i*8)) & bmask;
+
+        //buffer[ i ] = byte;
+        buffer[ sizeof(T) - 1 - i ] = byte;
+    }
+
+    out.write(reinterpret_cast<char*>(&buffer[0]),sizeof(T));
+}
+
+
+template<typename T>
+static inline T unserialize_uint(std::istream& in)
+{
+    uint8_t buffer[sizeof(T)];
+    in.read(reinterpret_cast<char*>(&buffer[0]), sizeof(T));
+    if (std::size_t(in.gcount()) != sizeof(T))
+        throw std::runtime_error("Truncated stream: could not read an integer field");
+
+    T v = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        //uint8_t byte = buffer[i];
+        uint8_t byte = buffer[sizeof(T) - 1 - i];
+
+        v |= T(byte) << (i*8);
+    }
+    return v;
+}
+
+
+/**
+ * The number of bytes a vcurve of a slice of side @c side is stored in: 4 when every vcurve of the
+ *  slice fits in 32 bits, 8 otherwise. Only slices larger than 1024^3 need 8, which requires
+ *  @c SVO_VCURVE_64; every other slice is stored the same in both builds.
+ */
+static inline std::size_t svo_vcurve_bytes(vside_t side)
+{
+    return uint64_t(side) * side * side > (uint64_t(1) << 32) ? 8 : 4;
+}
+
+///writes a vcurve of a slice of side @c side, in svo_vcurve_bytes() bytes.
+static inline void serialize_vcurve(std::ostream& out, vcurve_t vcurve, vside_t side)
+{
+    if (svo_vcurve_bytes(side) == 8)
+        serialize_uint<uint64_t>(out, uint64_t(vcurve));
+    else
+        serialize_uint<uint32_t>(out, uint32_t(vcurve));
+}
+
+static inline vcurve_t unserialize_vcurve(std::istream& in, vside_t side)
+{
+    if (svo_vcurve_bytes(side) == 4)
+        return vcurve_t(unserialize_uint<uint32_t>(in));
+
+    uint64_t vcurve = unserialize_uint<uint64_t>(in);
+    if (vcurve > uint64_t(vcurve_t(-1)))
+        throw std::runtime_error("Serialized vcurve does not fit in vcurve_t; it needs SVO_VCURVE_64");
+    return vcurve_t(vcurve);
+}
+
+
+static inline uint16_t svo_bswap(uint16_t v)
+{
+#if defined(__GNUC__)
+    return __builtin_bswap16(v);
+#else
+    return uint16_t((v >> 8) | (v << 8));
+#endif
+}
+
+static inline uint32_t svo_bswap(uint32_t v)
+{
+#if defined(__GNUC__)
+    return __builtin_bswap32(v);
+#else
+    return    ((v >> 24) & 0x000000FFu) | ((v >>  8) & 0x0000FF00u)
+            | ((v <<  8) & 0x00FF0000u) | ((v << 24) & 0xFF000000u);
+#endif
+}
+
+static inline uint64_t svo_bswap(uint64_t v)
+{
+#if defined(__GNUC__)
+    return __builtin_bswap64(v);
+#else
+    return (uint64_t(svo_bswap(uint32_t(v))) << 32) | uint64_t(svo_bswap(uint32_t(v >> 32)));
+#endif
+}
+
+/**
+ * Byteswaps @c count contiguous words of @c T in place.
+ *
+ * This is a plain loop over independent words, which the compiler turns into shuffles
+ * (pshufb/vrev) when vectorizing.
+ */
+template<typename T>
+static inline void svo_bswap_n(T* data, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        data[i] = svo_bswap(data[i]);
+}
+
+template<typename T>
+static inline void svo_bswap_unaligned_n(uint8_t* data, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        T v;
+        std::memcpy(&v, data + i*sizeof(T), sizeof(T));
+        v = svo_bswap(v);
+        std::memcpy(data + i*sizeof(T), &v, sizeof(T));
+    }
+}
+
+/**
+ * Byteswaps @c count contiguous words of @c width bytes in place; @c data need not be aligned.
+ *
+ * @c width of 1 is a no-op.
+ */
+static inline void svo_bswap_bytes(uint8_t* data, std::size_t width, std::size_t count)
+{
+    switch (width)
+    {
+        case 1:
+            return;
+        case 2:
+            svo_bswap_unaligned_n<uint16_t>(data, count);
+            return;
+        case 4:
+            svo_bswap_unaligned_n<uint32_t>(data, count);
+            return;
+        case 8:
+            svo_bswap_unaligned_n<uint64_t>(data, count);
+            return;
+    }
+    assert(false && "unsupported word width");
+}
+
+
+///a read-only, seekable stream buffer over bytes held in memory, e.g. a section read with svo_read_section().
+struct svo_memory_streambuf_t : public std::streambuf{
+    svo_memory_streambuf_t(const char* data, std::size_t bytes)
+    {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + bytes);
+    }
+
+    std::size_t remaining() const
+    {
+        return egptr() - gptr();
+    }
+
+protected:
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+    {
+        if (!(which & std::ios_base::in))
+            return pos_type(off_type(-1));
+
+        off_type base = dir == std::ios_base::beg ? 0 : (dir == std::ios_base::cur ? gptr() - eback() : egptr() - eback());
+        off_type position = base + off;
+        if (position < 0 || position > egptr() - eback())
+            return pos_type(off_type(-1));
+
+        setg(eback(), eback() + position, egptr());
+        return pos_type(position);
+    }
+
+    virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which)
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
+} //namespace svo
+
+#endif
@@ -18,6 +18,7 @@ typedef std::vector< std::tuple<vside_t, vcurve_t> > children_params_t;
 
 
 void serialize_slice(std::ostream& out, const svo_slice_t* slice);
+///loads a v1 or v2 slice.
 children_params_t unserialize_slice(std::istream& in, svo_slice_t* slice, bool load_empty_children);
 
 
@@ -42,6 +43,9 @@ svo_declaration_t unserialize_declaration(std::istream& in);
 svo_schema_t unserialize_schema(std::istream& in);
 children_params_t unserialize_slice_child_info(std::istream& in, svo_slice_t* slice);
 
+///attaches an empty child slice to @c slice for each of @c children_params.
+void slice_load_empty_children(svo_slice_t* slice, const children_params_t& children_params);
+
 
 
 
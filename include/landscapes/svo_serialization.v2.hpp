@@ -0,0 +1,182 @@
+#ifndef SVO_SERALIZATION_V2_HPP
+#define SVO_SERALIZATION_V2_HPP 1
+
+#include <iosfwd>
+#include <vector>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include "svo_curves.h"
+#include "svo_tree.fwd.hpp"
+#include "svo_buffer.hpp"
+#include "svo_serialization.v1.hpp"
+#include "svo_serialization.detail.hpp"
+#include "svo_serialization.codecs.hpp"
+
+namespace svo{
+
+
+///How @c pos_data is stored in a v2 stream.
+enum class svo_pos_encoding_t{
+    ///one word per voxel, in the stream's byte order; 32 bit, or 64 bit for slices above 1024^3 voxels.
+      raw
+    ///runs of consecutive vcurves, stored as varint (gap, length) pairs; see svo_encode_pos_data_delta().
+    , delta_varint
+};
+
+///How a buffer's payload is laid out in a v2 stream.
+enum class svo_buffer_layout_t{
+    ///the buffer's entries, one after another, as in memory.
+      interleaved
+    ///each element stored on its own, with its size; a reader can skip the elements it does not need.
+    , columns
+};
+
+struct svo_serialization_options_t{
+    svo_serialization_options_t();
+
+    ///byte order of the bulk payloads; the reader swaps if it differs from the host.
+    svo_byte_order_t byte_order;
+    svo_pos_encoding_t pos_encoding;
+    ///layout of the buffers; buffers with element codecs are always stored as columns.
+    svo_buffer_layout_t buffer_layout;
+    ///write the checksummed variant of the format (version 3); on by default.
+    bool checksums;
+
+    ///codec for each element, by element name; elements not listed are stored raw.
+    std::map<std::string, svo_element_codec_t> element_codecs;
+    ///see svo_element_codec_params_t.
+    uint32_t quantize_bits;
+    int zlib_level;
+};
+
+
+/**
+ * Selects the parts of a slice to load.
+ *
+ * @c pos_data is always loaded. Elements are selected by name; buffers left with no selected elements
+ *  are not loaded at all, and the others are loaded with a declaration holding just the selected
+ *  elements, in their original order.
+ *
+ * What is skipped without being read depends on the format:
+ *  - v2: skipped buffers and skipped columns are seeked past, so they cost no I/O on a seekable stream.
+ *  - v3: a buffer is a checksummed section; a buffer with no selected elements is seeked past as a
+ *      whole. Skipped columns of a buffer that is loaded are in its section, so they are seeked past
+ *      only when checksums are not verified, and are otherwise read to check the section.
+ *
+ * Interleaved buffers with only some of their elements selected are always read whole and then
+ *  narrowed. svo_async_slice_loader_t reads each slice whole before decoding it, so there the filter
+ *  saves decoding and memory, not I/O.
+ */
+struct svo_slice_load_filter_t{
+    ///loads everything.
+    svo_slice_load_filter_t();
+
+    ///loads only @c pos_data, e.g. for occupancy or collision queries.
+    static svo_slice_load_filter_t positions_only();
+    ///loads @c pos_data and the named elements.
+    static svo_slice_load_filter_t only(const std::set<std::string>& element_names);
+
+    bool all_elements;
+    ///names of the elements to load, used when @c all_elements is false.
+    std::set<std::string> elements;
+
+    bool selects(const svo_element_t& element) const;
+    ///@c declaration, narrowed to the selected elements.
+    svo_declaration_t select(const svo_declaration_t& declaration) const;
+};
+
+
+/**
+ * Writes a slice in the v2 format.
+ *
+ * The v2 format has the same header and schema as v1, but @c pos_data and each buffer's payload are
+ * stored as single contiguous blocks in a declared byte order, instead of one big-endian word at a time.
+ * Loading a payload is then one read, plus a byteswap if the file's byte order differs from the host's.
+ *
+ * Layout:
+ *  - u32 format version, big-endian like v1; 2, or 3 if checksummed.
+ *  - header: u8 byte order of the payloads (0 little, 1 big), u8 pos_data encoding (0 raw,
+ *      1 delta_varint), and the slice child info, as in v1.
+ *  - pos_data: u32 entries; for raw, followed by @c entries vcurves of svo_vcurve_bytes() bytes, i.e.
+ *      32 bit unless the slice has more than 2^32 voxels; for delta_varint, followed
+ *      by a u32 encoded size and the encoded bytes.
+ *  - schema, as in v1.
+ *  - for each buffer, u32 entries and a u8 layout:
+ *      - 0 (interleaved), followed by the buffer's raw data; each element component is a word in the
+ *          declared byte order.
+ *      - 1 (columns), used when requested, or when any element of the buffer has a codec; for each element, a u8
+ *          svo_element_codec_t, a u32 encoded size, and the column encoded by svo_encode_element().
+ *
+ * In version 3 the header, pos_data, schema and each buffer are sections, each prefixed by a u32 length
+ *  and the u32 CRC-32C (see svo_crc32c()) of the section. A reader rejects truncated or corrupt
+ *  sections with an exception, and can skip a whole buffer with one seek.
+ */
+void serialize_slice_v2(std::ostream& out, const svo_slice_t* slice
+                        , const svo_serialization_options_t& options = svo_serialization_options_t());
+
+///true for the format versions written by serialize_slice_v2().
+bool is_v2_format_version(uint32_t format_version);
+
+/**
+ * Loads a v2 slice; @c unserialize_slice() also accepts v2 streams.
+ *
+ * Malformed streams throw @c std::runtime_error. Section lengths are always checked; the checksums
+ *  can be skipped with @c verify_checksums for trusted data, e.g. data that was just written.
+ */
+children_params_t unserialize_slice_v2(std::istream& in, svo_slice_t* slice, bool load_empty_children
+                                        , const svo_slice_load_filter_t& filter = svo_slice_load_filter_t()
+                                        , bool verify_checksums = true);
+
+///loads the rest of a v2 slice, after the @c format_version word.
+children_params_t unserialize_slice_v2_body(std::istream& in, uint32_t format_version, svo_slice_t* slice
+                                            , bool load_empty_children
+                                            , const svo_slice_load_filter_t& filter = svo_slice_load_filter_t()
+                                            , bool verify_checksums = true);
+
+
+/**
+ * Writes @c data as a section: a u32 length, the u32 CRC-32C of the data, and the data.
+ */
+void svo_write_section(std::ostream& out, const std::string& data);
+
+/**
+ * Reads the next section written by svo_write_section() into @c data; throws if it is truncated or,
+ *  if @c verify_checksums is set, if the checksum does not match. @c section_name is used in errors.
+ *
+ * The data is read in bounded chunks, so a corrupt length fails as a truncated stream rather than
+ *  as a huge allocation.
+ */
+void svo_read_section(std::istream& in, std::string& data, bool verify_checksums, const char* section_name);
+
+
+///the raw pos_data payload: one word of svo_vcurve_bytes(side) bytes per vcurve.
+void serialize_pos_data_bulk(std::ostream& out, const std::vector<vcurve_t>& pos_data, vside_t side, svo_byte_order_t byte_order);
+void serialize_buffer_data_bulk(std::ostream& out, const svo_cpu_buffer_t& buffer, svo_byte_order_t byte_order);
+
+void unserialize_pos_data_bulk(std::istream& in, std::vector<vcurve_t>& pos_data, std::size_t entries, vside_t side, svo_byte_order_t byte_order);
+void unserialize_buffer_data_bulk(std::istream& in, svo_cpu_buffer_t& buffer, svo_byte_order_t byte_order);
+
+/**
+ * Encodes sorted, unique vcurves as runs of consecutive values.
+ *
+ * Each run is a varint token @c (gap << 1) | (length > 1), where @c gap is the number of empty vcurves
+ * since the end of the previous run, optionally followed by a varint @c length - 2. Sparse voxels thus
+ * usually cost one byte, and a fully solid range costs a couple of bytes regardless of its size.
+ * With @c SVO_VCURVE_64 the vcurves must be below 2^63, as every vcurve of a slice is, so the token fits in 64 bits.
+ */
+void svo_encode_pos_data_delta(const std::vector<vcurve_t>& pos_data, std::vector<uint8_t>& encoded);
+
+///decodes exactly @c entries vcurves of a slice of side @c side, appending them to @c pos_data; throws on
+/// malformed input, including vcurves outside of the slice.
+void svo_decode_pos_data_delta(const uint8_t* encoded, std::size_t bytes, std::size_t entries, vside_t side
+                                , std::vector<vcurve_t>& pos_data);
+
+///swaps every multi-byte element component of the buffer in place.
+void svo_bswap_buffer(svo_cpu_buffer_t& buffer);
+
+
+} //namespace svo
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef SVO_SLICE_LOADER_HPP
+#define SVO_SLICE_LOADER_HPP 1
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+#include "opencl.shim.h"
+#include "svo_tree.fwd.hpp"
+#include "svo_archive.hpp"
+
+namespace svo{
+
+
+/**
+ * Computes the cube covered by a slice of an archive, in the space of the root slice, which spans the
+ *  unit cube [0,1]^3.
+ *
+ * Each child covers @c child.side/2 voxels of its parent, starting at the parent voxel @c parent_vcurve_begin.
+ */
+void svo_archive_slice_bounds(const svo_archive_t& archive, svo_slice_id_t slice_id
+                                , float3_t& lower, float3_t& upper);
+
+
+///A slice handed back by svo_async_slice_loader_t.
+struct svo_loaded_slice_t{
+    svo_loaded_slice_t();
+
+    svo_slice_id_t slice_id;
+    /**
+     * The decoded slice, owned by the receiver; free it with svo_uninit_slice(), or attach it to its
+     *  parent with svo_slice_attach_child() and @c entry(slice_id).parent_vcurve_begin.
+     * Null if loading failed.
+     */
+    svo_slice_t* slice;
+    ///set if loading failed.
+    std::exception_ptr error;
+};
+
+
+/**
+ * Loads slices of an archive in the background.
+ *
+ * Requests are kept in a bounded queue; one I/O thread takes the highest priority request, reads the
+ *  slice's bytes from the archive, and hands them to a pool of worker threads that decode them. Decoded
+ *  slices are put on a completion queue, from which the block builder takes them with try_pop() or
+ *  wait_pop().
+ *
+ * The I/O thread is the only one touching the archive's stream, so while the loader is alive the
+ *  archive may only be used through its const methods.
+ *
+ * The request methods, try_pop() and wait_pop() can be called from any thread.
+ */
+struct svo_async_slice_loader_t{
+    /**
+     * @param archive the archive to load from; must outlive the loader.
+     * @param num_workers number of decoding threads; at least one is used.
+     * @param capacity maximum number of slices requested, but not yet popped from the completion queue.
+     * @param load_empty_children attach empty children to the loaded slices, see svo_archive_t::load_slice().
+     * @param filter the buffer elements to load, see svo_slice_load_filter_t; each slice's bytes are still
+     *  read whole, with svo_archive_t::read_slice_data(), and only the selected elements are decoded.
+     */
+    svo_async_slice_loader_t(svo_archive_t& archive, std::size_t num_workers, std::size_t capacity
+                            , bool load_empty_children = true
+                            , const svo_slice_load_filter_t& filter = svo_slice_load_filter_t());
+    svo_async_slice_loader_t(const svo_async_slice_loader_t&) = delete;
+    svo_async_slice_loader_t& operator=(const svo_async_slice_loader_t&) = delete;
+
+    ///drops the queued requests, waits for the threads, and frees slices that were not popped.
+    ~svo_async_slice_loader_t();
+
+    /**
+     * Queues a slice to be loaded; higher @c priority is loaded first.
+     *
+     * Returns false if the queue is full, or if the slice is already being read or decoded. Requesting
+     *  a slice that is still queued just raises its priority.
+     */
+    bool request(svo_slice_id_t slice_id, float priority = 0);
+
+    ///drops a queued request; returns false if the slice is not queued, or is already being loaded.
+    bool cancel(svo_slice_id_t slice_id);
+
+    /**
+     * Prefetches the children of a slice, for traversal order loading; they are likely to be needed
+     *  right after @c slice_id. Returns the number of requests queued.
+     */
+    std::size_t prefetch_children(svo_slice_id_t slice_id, float priority = 0);
+
+    /**
+     * Prefetches the slices within @c max_distance of @c camera (both in root space, see
+     *  svo_archive_slice_bounds()), nearest first, until the queue is full.
+     *
+     * Slices that were already requested, or popped from the completion queue, are skipped; request
+     *  them explicitly to load them again. Returns the number of requests queued.
+     */
+    std::size_t prefetch_near(const float3_t& camera, float max_distance);
+
+    ///takes a loaded slice from the completion queue, if there is one.
+    bool try_pop(svo_loaded_slice_t& loaded);
+
+    ///waits for a loaded slice; returns false if nothing is queued or loading.
+    bool wait_pop(svo_loaded_slice_t& loaded);
+
+    ///number of slices queued, loading, or waiting on the completion queue.
+    std::size_t outstanding() const;
+
+private:
+    enum class slice_state_t : uint8_t { none, queued, loading, ready, popped };
+
+    struct pending_t{
+        svo_slice_id_t slice_id;
+        float priority;
+    };
+
+    struct decode_job_t{
+        svo_slice_id_t slice_id;
+        std::string data;
+    };
+
+    bool request_locked(svo_slice_id_t slice_id, float priority);
+    void complete_locked(svo_loaded_slice_t loaded);
+    void io_main();
+    void worker_main();
+
+    svo_archive_t& m_archive;
+    std::size_t m_capacity;
+    bool m_load_empty_children;
+    svo_slice_load_filter_t m_filter;
+    ///the I/O thread reads ahead of the workers by at most this many slices.
+    std::size_t m_max_decode_queue;
+
+    mutable std::mutex m_mutex;
+    ///wakes the I/O thread; new requests, or room in the decode queue.
+    std::condition_variable m_io_cv;
+    ///wakes the workers; new decode jobs.
+    std::condition_variable m_decode_cv;
+    ///wakes wait_pop().
+    std::condition_variable m_ready_cv;
+    bool m_stop;
+
+    std::vector<slice_state_t> m_states;
+    std::vector<pending_t> m_pending;
+    std::deque<decode_job_t> m_decode_queue;
+    ///slices read or being decoded.
+    std::size_t m_loading;
+    std::deque<svo_loaded_slice_t> m_ready;
+
+    std::thread m_io_thread;
+    std::vector<std::thread> m_workers;
+};
+
+
+} //namespace svo
+
+#endif
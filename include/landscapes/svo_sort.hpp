@@ -0,0 +1,74 @@
+#ifndef SVO_SORT_HPP
+#define SVO_SORT_HPP 1
+
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "svo_tree.fwd.hpp"
+
+namespace svo{
+
+
+///a Morton key, and the index of the item it belongs to.
+struct svo_sort_record_t{
+    uint64_t key;
+    uint64_t index;
+};
+
+/**
+ * Stable LSD radix sort of @c records by key, 8 bits per pass over the low @c key_bits bits.
+ *
+ * Each pass histograms the digits of each thread's chunk in parallel, turns the histograms into
+ *  per-(digit, thread) output offsets, and scatters each chunk in parallel. Passes where all the keys
+ *  have the same digit are skipped, so keys that only use a few bits of @c key_bits cost little.
+ */
+void svo_radix_sort(std::vector<svo_sort_record_t>& records, std::size_t key_bits, std::size_t num_threads = 1);
+
+
+/**
+ * Reorders the voxels of @c slice: voxel @c i of the result is voxel @c sources[i] of the input, in
+ *  @c pos_data and in every buffer. @c sources may skip or repeat voxels; the slice ends up with
+ *  @c sources.size() voxels.
+ *
+ * Each buffer is gathered once, entry by entry, into a new buffer.
+ */
+void svo_gather_slice_data(svo_slice_t* slice, const std::vector<std::size_t>& sources, std::size_t num_threads = 1);
+
+/**
+ * Sorts the voxels of @c slice by vcurve, with svo_radix_sort(), moving the buffer entries along, so
+ *  that @c pos_data is Morton ordered. If a vcurve appears more than once, the last of its voxels is
+ *  kept.
+ */
+void svo_sort_slice_data(svo_slice_t* slice, std::size_t num_threads = 1);
+
+/**
+ * Merges the voxels of Morton ordered slices into @c dst_slice.
+ *
+ * Voxel @c v of @c src_slices[i] becomes voxel @c v + @c vcurve_offsets[i] of @c dst_slice; e.g. for
+ *  the 8 octants of a slice joined into one, the offset of each octant is its first vcurve in the joined
+ *  slice. Null sources are skipped. The result is Morton ordered; if several sources have the same
+ *  vcurve, the one of the last source is kept.
+ *
+ * @c dst_slice must have no voxels; it takes the schema of the first source if it has none. All the
+ *  sources must have the schema of @c dst_slice.
+ *
+ * Each buffer is allocated once and filled with one copy per run of consecutive voxels of a source; if
+ *  there is only one run, the buffer is a view of the source's instead (see svo_cpu_buffer_t::view()).
+ */
+void svo_merge_slice_data(svo_slice_t* dst_slice, const std::vector<const svo_slice_t*>& src_slices
+                            , const std::vector<vcurve_t>& vcurve_offsets);
+
+/**
+ * Stably partitions the voxels of @c slice by the octant of the slice they are in, i.e. by the top 3
+ *  bits of their vcurve, moving the buffer entries along.
+ *
+ * The voxels of octant @c i end up in [@c octant_begin[i], @c octant_begin[i+1]), in their original
+ *  order. On a Morton ordered slice this moves nothing, and only finds the octant bounds.
+ */
+void svo_partition_slice_data(svo_slice_t* slice, std::array<std::size_t, 9>& octant_begin);
+
+
+} //namespace svo
+
+#endif
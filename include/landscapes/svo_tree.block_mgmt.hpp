@@ -23,10 +23,9 @@ struct slice_inserter_t{
     /// child offset to the children; 0 is initial invalid offset flag.
     typedef std::vector< std::tuple<std::size_t, vcurve_t, child_descriptor_t, offset_t> > out_data_t;
 
-    //struct out_data_t{
-    //    out_pos_data_t pos_data;
-    //    std::vector<svo_cpu_buffer_t> buffers;
-    //};
+    ///the attributes of the children of the CDs in an @c out_data_t; entry (out data index * 8 + ccurve) holds
+    /// the bytes of that child in each buffer of the slice's schema, back to back. See svo_get_data_index().
+    typedef std::vector<uint8_t> out_attrs_t;
 
     
     
@@ -82,6 +81,19 @@ private:
         , const cd_indices_t& cd_parent_indices
         , const out_data_t& out_data);
     ///////////////////////////////////////////////////////////////////////////////////////////////
+    ///the index into @c uc_out_data of the root CD of a classification.
+    std::size_t root_out_data_index(std::size_t classification) const;
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    ///makes room in @c out_attrs for the children of the CD at @c out_data_index, and copies in their attributes
+    /// from the block if @c cd_goffset is a CD of the block.
+    void stage_block_attrs(out_attrs_t& out_attrs, std::size_t out_data_index, goffset_t cd_goffset);
+    ///copies the attributes of the slice voxel at @c in_data_index into the child @c ccurve of the CD at @c out_data_index.
+    void stage_slice_attrs(out_attrs_t& out_attrs, std::size_t out_data_index, ccurve_t ccurve, std::size_t in_data_index);
+    ///gives @c dst_block the slice's schema, and room for the data of all its CDs.
+    void prepare_block_attrs(svo_block_t* dst_block);
+    ///writes the attributes staged for @c out_data_index into the data entries of the CD at @c cd_goffset, in @c dst_block.
+    void write_block_attrs(svo_block_t* dst_block, goffset_t cd_goffset, const out_attrs_t& out_attrs, std::size_t out_data_index);
+    ///////////////////////////////////////////////////////////////////////////////////////////////
     //void update_root_shadows();
     ///////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -111,6 +123,12 @@ private:
     /// first node in @c out_data.
     std::vector< offset_t > out_uc_root_offsets;
 
+    ///the size of an attribute entry across all the buffers of the slice; 0 if the slice has no buffers.
+    std::size_t attr_entry_bytes;
+    ///the attributes of @c uc_out_data, and of each of @c out_datas.
+    out_attrs_t uc_out_attrs;
+    std::vector< out_attrs_t > out_datas_attrs;
+
 
 public:
     std::vector<svo_block_t*> ret_blocks;
@@ -4,19 +4,39 @@
 #include "svo_curves.h"
 #include "svo_inttypes.h"
 #include "opencl.shim.h"
+#include "debug_macro.h"
 
 #ifdef __cplusplus
 extern "C"{
 #endif
 
+///checks in the accessors below are tiered by @c SVO_CHECK_LEVEL_CAPI (see debug_macro.h);
+/// the full tier re-fetches CDs and cross-checks against the slow @c *_check functions.
+#if SVO_CHECK_LEVEL_CAPI >= SVO_CHECK_CHEAP
+#define SVO_CAPI_ASSERT(expr) assert(expr)
+#else
+#define SVO_CAPI_ASSERT(expr) ((void)0)
+#endif
+
+#if SVO_CHECK_LEVEL_CAPI >= SVO_CHECK_FULL
+#define SVO_CAPI_FULL_ASSERT(expr) assert(expr)
+#else
+#define SVO_CAPI_FULL_ASSERT(expr) ((void)0)
+#endif
+
 typedef struct child_descriptor_t{
     uint64_t data;
 } child_descriptor_t;
 
 
+///one per block, at the block's @c info_goffset; every page header of the block points to it.
 typedef struct svo_info_section_t{
-    
-    
+    ///the block's first CD slot is at (info section goffset - @c cd_start_offset).
+    offset_t cd_start_offset;
+    ///the block's data section is at (info section goffset + @c data_offset).
+    offset_t data_offset;
+    ///the number of entries in each buffer of the data section.
+    uint32_t data_entries;
 } svo_info_section_t;
 
 typedef struct svo_page_header_t{
@@ -60,6 +80,7 @@ static inline void svo_set_nth_bit(child_descriptor_t* child_descriptor, size_t
 static inline bool svo_get_nth_bit(const child_descriptor_t* child_descriptor, size_t n);
 static inline uint64_t svo_nbits_uint64(size_t n);
 static inline fast_uint8_t svo_count_bits_uint8(uint8_t value);
+static inline fast_uint8_t svo_count_bits_uint8_check(uint8_t value);
 
 
 static inline void svo_init_cd(child_descriptor_t* child_descriptor);
@@ -88,6 +109,7 @@ static inline bool svo_get_nonleaf_bit(const child_descriptor_t* child_descripto
 
 ///get the index of the child within the parent. so if a parent has 3 children, the last child will have an index = 2.
 static inline fast_uint8_t svo_get_cd_child_index(const child_descriptor_t* child_descriptor, ccurve_t child_ccurve);
+static inline fast_uint8_t svo_get_cd_child_index_check(const child_descriptor_t* child_descriptor, ccurve_t child_ccurve);
 static inline fast_uint8_t svo_get_cd_valid_count(const child_descriptor_t* child_descriptor);
 static inline fast_uint8_t svo_get_cd_leaf_count(const child_descriptor_t* child_descriptor);
 static inline fast_uint8_t svo_get_cd_nonleaf_count(const child_descriptor_t* child_descriptor);
@@ -108,17 +130,68 @@ static inline goffset_t svo_get_ph_goffset(goffset_t cd_goffset);
 
 static inline svo_page_header_t* svo_get_ph(byte_t* address_space, goffset_t cd_goffset);
 static inline svo_info_section_t* info_section(byte_t* address_space, goffset_t cd_goffset);
+static inline goffset_t svo_get_info_section_goffset(const byte_t* address_space, goffset_t cd_goffset);
 static inline child_descriptor_t* svo_get_cd(byte_t* address_space, goffset_t cd_goffset);
 static inline const child_descriptor_t* svo_cget_cd(const byte_t* address_space, goffset_t cd_goffset);
 
+///the index of the data entry of the child @c ccurve of the CD at @c pcd_goffset, in the buffers of the
+/// block whose first CD slot is @c cd_start. Each CD slot of a block owns 8 consecutive entries, one per child.
+static inline uint32_t svo_get_data_index(goffset_t cd_start, goffset_t pcd_goffset, ccurve_t ccurve);
+/**
+ * The goffset of the data of the child @c ccurve of the CD at @c pcd_goffset, in a buffer of the CD's block.
+ *
+ * The buffers of a block's data section are laid out back to back; @c preceding_stride is the sum of the
+ *  strides of the buffers before the wanted one, and @c stride is its stride. Everything else is found
+ *  through the block's info section.
+ */
+static inline goffset_t svo_get_data_goffset(const byte_t* address_space, goffset_t pcd_goffset, ccurve_t ccurve
+                                            , uint32_t preceding_stride, uint32_t stride);
+
+
 
 
 
 
 
 
+///number of set bits in each possible byte; used by svo_count_bits_uint8() when there is no
+/// hardware popcount available (and usable from OpenCL as well).
+GLOBAL_STATIC_CONST uint8_t svo_popcount8_lut[256] =
+{
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8
+};
+
 
 static inline fast_uint8_t svo_count_bits_uint8(uint8_t value)
+{
+#if defined(__OPENCL_VERSION__) && __OPENCL_VERSION__ >= 120
+    return popcount(value);
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__POPCNT__) && !defined(SVO_NO_HW_POPCOUNT)
+    ///only when the target actually has a popcnt instruction; otherwise the builtin becomes a
+    /// libgcc call, and the table is faster.
+    return __builtin_popcount(value);
+#else
+    return svo_popcount8_lut[value];
+#endif
+}
+
+///Loop version of svo_count_bits_uint8(), used to double check it.
+static inline fast_uint8_t svo_count_bits_uint8_check(uint8_t value)
 {
     return (
           ((value >> 0) & 1)
@@ -136,8 +209,8 @@ static inline fast_uint8_t svo_count_bits_uint8(uint8_t value)
 
 static inline bool svo_get_nth_bit(const child_descriptor_t* child_descriptor, size_t n)
 {
-    assert(child_descriptor);
-    assert(n < sizeof(child_descriptor_t)*8);
+    SVO_CAPI_ASSERT(child_descriptor);
+    SVO_CAPI_ASSERT(n < sizeof(child_descriptor_t)*8);
 
     uint64_t data = child_descriptor->data;
 
@@ -149,8 +222,8 @@ static inline bool svo_get_nth_bit(const child_descriptor_t* child_descriptor, s
 static inline void svo_set_nth_bit(child_descriptor_t* child_descriptor, size_t n, bool value)
 {
     ///see http://stackoverflow.com/a/47990/586784
-    assert(child_descriptor);
-    assert(n < sizeof(child_descriptor_t)*8);
+    SVO_CAPI_ASSERT(child_descriptor);
+    SVO_CAPI_ASSERT(n < sizeof(child_descriptor_t)*8);
 
     uint64_t data = child_descriptor->data;
     uint64_t x = value ? 1 : 0;
@@ -161,7 +234,7 @@ static inline void svo_set_nth_bit(child_descriptor_t* child_descriptor, size_t
 
     child_descriptor->data = data;
 
-    assert(svo_get_nth_bit(child_descriptor, n) == value);
+    SVO_CAPI_FULL_ASSERT(svo_get_nth_bit(child_descriptor, n) == value);
 
 }
 
@@ -169,20 +242,20 @@ static inline void svo_set_nth_bit(child_descriptor_t* child_descriptor, size_t
 
 static inline void svo_copy_cd(child_descriptor_t* dst, const child_descriptor_t* src)
 {
-    assert(src);
-    assert(dst);
+    SVO_CAPI_ASSERT(src);
+    SVO_CAPI_ASSERT(dst);
     dst->data = src->data;
 }
 
 static inline void svo_init_cd(child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     child_descriptor->data = 0;
 }
 
 static inline void svo_set_far(child_descriptor_t* child_descriptor, bool value)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
 
     uint64_t farbit = ((uint64_t)(value ? 1 : 0)) << SVO_FAR_BIT_CD_POS;
 
@@ -193,9 +266,9 @@ static inline void svo_set_far(child_descriptor_t* child_descriptor, bool value)
 
 static inline void svo_set_child_ptr(child_descriptor_t* child_descriptor, uint16_t child_ptr)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
 
-    assert((child_ptr & SVO_CHILD_PTR_MASK) == child_ptr);
+    SVO_CAPI_ASSERT((child_ptr & SVO_CHILD_PTR_MASK) == child_ptr);
 
 
     ///erase the bits we gonna write.
@@ -205,17 +278,17 @@ static inline void svo_set_child_ptr(child_descriptor_t* child_descriptor, uint1
 
 static inline void svo_set_goffset_via_fp(byte_t* address_space, goffset_t pcd_goffset, child_descriptor_t* pcd, goffset_t cd_goffset)
 {
-    assert(address_space);
-    assert(pcd_goffset);
-    assert(pcd_goffset != invalid_goffset);
-    assert( (pcd_goffset & goffset_mask) == pcd_goffset );
-    assert(svo_get_cd(address_space, pcd_goffset) == pcd);
+    SVO_CAPI_ASSERT(address_space);
+    SVO_CAPI_ASSERT(pcd_goffset);
+    SVO_CAPI_ASSERT(pcd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (pcd_goffset & goffset_mask) == pcd_goffset );
+    SVO_CAPI_FULL_ASSERT(svo_get_cd(address_space, pcd_goffset) == pcd);
 
-    assert(svo_get_far(pcd));
+    SVO_CAPI_ASSERT(svo_get_far(pcd));
 
     offset4_t offset4 = svo_get_child_ptr_offset4(pcd);
 
-    assert(offset4 != 0);
+    SVO_CAPI_ASSERT(offset4 != 0);
 
     goffset_t far_ptr_goffset = pcd_goffset + offset4*4;
 
@@ -227,7 +300,7 @@ static inline void svo_set_goffset_via_fp(byte_t* address_space, goffset_t pcd_g
 
 static inline offset4_t svo_get_child_ptr_offset4(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     return (child_descriptor->data >> SVO_CHILD_PTR_CD_POS) & SVO_CHILD_PTR_MASK;
 }
 
@@ -235,11 +308,11 @@ static inline offset4_t svo_get_child_ptr_offset4(const child_descriptor_t* chil
 
 static inline goffset_t svo_get_child_ptr_goffset(const byte_t* address_space, goffset_t pcd_goffset, const child_descriptor_t* pcd)
 {
-    assert(address_space);
-    assert(pcd_goffset);
-    assert(pcd_goffset != invalid_goffset);
-    assert( (pcd_goffset & goffset_mask) == pcd_goffset );
-    assert(svo_cget_cd(address_space, pcd_goffset) == pcd);
+    SVO_CAPI_ASSERT(address_space);
+    SVO_CAPI_ASSERT(pcd_goffset);
+    SVO_CAPI_ASSERT(pcd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (pcd_goffset & goffset_mask) == pcd_goffset );
+    SVO_CAPI_FULL_ASSERT(svo_cget_cd(address_space, pcd_goffset) == pcd);
 
     offset4_t child_ptr_offset4 = svo_get_child_ptr_offset4(pcd);
     
@@ -249,7 +322,7 @@ static inline goffset_t svo_get_child_ptr_goffset(const byte_t* address_space, g
     bool farvalue = svo_get_far(pcd);
 
     goffset_t child_ptr_goffset = pcd_goffset + child_ptr_offset4*4;
-    assert( (child_ptr_goffset & goffset_mask) == child_ptr_goffset );
+    SVO_CAPI_ASSERT( (child_ptr_goffset & goffset_mask) == child_ptr_goffset );
 
     if (farvalue)
     {
@@ -257,27 +330,27 @@ static inline goffset_t svo_get_child_ptr_goffset(const byte_t* address_space, g
         child_ptr_goffset = *(far_ptr_t*)(address_space + far_ptr_goffset);
     }
 
-    assert( (child_ptr_goffset & goffset_mask) == child_ptr_goffset );
+    SVO_CAPI_ASSERT( (child_ptr_goffset & goffset_mask) == child_ptr_goffset );
     return child_ptr_goffset;
 }
 
 static inline goffset_t svo_get_child_cd_goffset(const byte_t* address_space, goffset_t pcd_goffset, const child_descriptor_t* pcd, ccurve_t child_ccurve)
 {
-    assert(address_space);
-    assert(pcd_goffset);
-    assert(pcd_goffset != invalid_goffset);
-    assert( (pcd_goffset & goffset_mask) == pcd_goffset );
-    assert( child_ccurve < 8 );
-    assert(svo_cget_cd(address_space, pcd_goffset) == pcd);
+    SVO_CAPI_ASSERT(address_space);
+    SVO_CAPI_ASSERT(pcd_goffset);
+    SVO_CAPI_ASSERT(pcd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (pcd_goffset & goffset_mask) == pcd_goffset );
+    SVO_CAPI_ASSERT( child_ccurve < 8 );
+    SVO_CAPI_FULL_ASSERT(svo_cget_cd(address_space, pcd_goffset) == pcd);
 
-    assert(svo_get_valid_bit(pcd, child_ccurve));
-    assert(!svo_get_leaf_bit(pcd, child_ccurve));
+    SVO_CAPI_ASSERT(svo_get_valid_bit(pcd, child_ccurve));
+    SVO_CAPI_ASSERT(!svo_get_leaf_bit(pcd, child_ccurve));
 
     goffset_t cd0_goffset = svo_get_child_ptr_goffset(address_space, pcd_goffset, pcd);
-    assert(cd0_goffset != 0 && cd0_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT(cd0_goffset != 0 && cd0_goffset != invalid_goffset);
 
     uint8_t child_index = svo_get_cd_child_index(pcd, child_ccurve);
-    assert(child_index < 8);
+    SVO_CAPI_ASSERT(child_index < 8);
 
     goffset_t child_cd_goffset = cd0_goffset + child_index * sizeof(child_descriptor_t);
 
@@ -287,7 +360,7 @@ static inline goffset_t svo_get_child_cd_goffset(const byte_t* address_space, go
         child_cd_goffset += sizeof(child_descriptor_t);
     }
 
-    assert(child_cd_goffset != 0 && child_cd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT(child_cd_goffset != 0 && child_cd_goffset != invalid_goffset);
 
     return child_cd_goffset;
 }
@@ -295,17 +368,17 @@ static inline goffset_t svo_get_child_cd_goffset(const byte_t* address_space, go
 static inline goffset_t svo_get_goffset_via_fp(const byte_t* address_space, goffset_t pcd_goffset, const child_descriptor_t* pcd)
 {
 
-    assert(address_space);
-    assert(pcd_goffset);
-    assert(pcd_goffset != invalid_goffset);
-    assert( (pcd_goffset & goffset_mask) == pcd_goffset );
-    assert(svo_cget_cd(address_space, pcd_goffset) == pcd);
+    SVO_CAPI_ASSERT(address_space);
+    SVO_CAPI_ASSERT(pcd_goffset);
+    SVO_CAPI_ASSERT(pcd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (pcd_goffset & goffset_mask) == pcd_goffset );
+    SVO_CAPI_FULL_ASSERT(svo_cget_cd(address_space, pcd_goffset) == pcd);
 
-    assert(svo_get_far(pcd));
+    SVO_CAPI_ASSERT(svo_get_far(pcd));
 
     offset4_t offset4 = svo_get_child_ptr_offset4(pcd);
 
-    assert(offset4 != 0);
+    SVO_CAPI_ASSERT(offset4 != 0);
 
     goffset_t far_ptr_goffset = pcd_goffset + offset4*4;
 
@@ -315,21 +388,21 @@ static inline goffset_t svo_get_goffset_via_fp(const byte_t* address_space, goff
 
 static inline bool svo_get_far(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     return (child_descriptor->data >> SVO_FAR_BIT_CD_POS) & 1;
 }
 
 static inline child_mask_t svo_get_valid_mask(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     return (child_descriptor->data >> SVO_VALID_MASK_CD_POS) & SVO_VALID_MASK_MASK;
 }
 
 
 static inline bool svo_get_leaf_bit(const child_descriptor_t* child_descriptor, ccurve_t ccurve)
 {
-    assert(child_descriptor);
-    assert(ccurve < 8);
+    SVO_CAPI_ASSERT(child_descriptor);
+    SVO_CAPI_ASSERT(ccurve < 8);
 
     child_mask_t leaf_mask = svo_get_leaf_mask(child_descriptor);
 
@@ -338,8 +411,8 @@ static inline bool svo_get_leaf_bit(const child_descriptor_t* child_descriptor,
 
 static inline bool svo_get_nonleaf_bit(const child_descriptor_t* child_descriptor, ccurve_t ccurve)
 {
-    assert(child_descriptor);
-    assert(ccurve < 8);
+    SVO_CAPI_ASSERT(child_descriptor);
+    SVO_CAPI_ASSERT(ccurve < 8);
 
     child_mask_t valid_mask = svo_get_valid_mask(child_descriptor);
     child_mask_t leaf_mask = svo_get_leaf_mask(child_descriptor);
@@ -352,10 +425,10 @@ static inline bool svo_get_nonleaf_bit(const child_descriptor_t* child_descripto
 
 static inline void svo_set_valid_mask(child_descriptor_t* child_descriptor, child_mask_t valid_mask)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
 
     ///should be 8 bits.
-    assert( (valid_mask & SVO_VALID_MASK_MASK) == valid_mask );
+    SVO_CAPI_ASSERT( (valid_mask & SVO_VALID_MASK_MASK) == valid_mask );
 
 
     ///erase the bits we gonna write.
@@ -364,25 +437,25 @@ static inline void svo_set_valid_mask(child_descriptor_t* child_descriptor, chil
     ///write the bits
     child_descriptor->data |= ((uint64_t)(valid_mask) << SVO_VALID_MASK_CD_POS) & SVO_VALID_MASK_CDMASK;
 
-    assert( svo_get_valid_mask(child_descriptor) == valid_mask );
+    SVO_CAPI_FULL_ASSERT( svo_get_valid_mask(child_descriptor) == valid_mask );
 }
 
 
 static inline void svo_set_valid_bit(child_descriptor_t* child_descriptor, ccurve_t ccurve, bool value)
 {
-    assert(child_descriptor);
-    assert(ccurve < 8);
+    SVO_CAPI_ASSERT(child_descriptor);
+    SVO_CAPI_ASSERT(ccurve < 8);
 
 
 
-#ifndef NDEBUG
+#if SVO_CHECK_LEVEL_CAPI >= SVO_CHECK_FULL && !defined(NDEBUG)
     uint64_t readonly_data0 = (child_descriptor->data & ~SVO_VALID_MASK_CDMASK);
 #endif
     svo_set_nth_bit(child_descriptor, (SVO_VALID_MASK_CD_POS + ccurve), value);
-#ifndef NDEBUG
-    assert( bool((svo_get_valid_mask(child_descriptor) >> ccurve) & 1) == value );
+#if SVO_CHECK_LEVEL_CAPI >= SVO_CHECK_FULL && !defined(NDEBUG)
+    SVO_CAPI_FULL_ASSERT( bool((svo_get_valid_mask(child_descriptor) >> ccurve) & 1) == value );
     uint64_t readonly_data1 = (child_descriptor->data & ~SVO_VALID_MASK_CDMASK);
-    assert( readonly_data0 == readonly_data1 );
+    SVO_CAPI_FULL_ASSERT( readonly_data0 == readonly_data1 );
 
 #endif
 }
@@ -390,19 +463,19 @@ static inline void svo_set_valid_bit(child_descriptor_t* child_descriptor, ccurv
 
 static inline child_mask_t svo_get_leaf_mask(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     return (child_descriptor->data >> SVO_LEAF_MASK_CD_POS) & SVO_LEAF_MASK_MASK;
 }
 
 
 static inline child_mask_t svo_get_nonleaf_mask(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     child_mask_t valid_mask = svo_get_valid_mask(child_descriptor);
     child_mask_t leaf_mask = svo_get_leaf_mask(child_descriptor);
 
     child_mask_t result = valid_mask & (~leaf_mask);
-    assert( (result & child_mask_mask) == result );
+    SVO_CAPI_ASSERT( (result & child_mask_mask) == result );
     return result;
 }
 
@@ -411,8 +484,8 @@ static inline child_mask_t svo_get_nonleaf_mask(const child_descriptor_t* child_
 
 static inline bool svo_get_valid_bit(const child_descriptor_t* child_descriptor, ccurve_t ccurve)
 {
-    assert(child_descriptor);
-    assert(ccurve < 8);
+    SVO_CAPI_ASSERT(child_descriptor);
+    SVO_CAPI_ASSERT(ccurve < 8);
 
     child_mask_t valid_mask = svo_get_valid_mask(child_descriptor);
 
@@ -422,10 +495,10 @@ static inline bool svo_get_valid_bit(const child_descriptor_t* child_descriptor,
 
 static inline void svo_set_leaf_mask(child_descriptor_t* child_descriptor, child_mask_t leaf_mask)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
 
     ///should be 8 bits.
-    assert( (leaf_mask & SVO_LEAF_MASK_MASK) == leaf_mask );
+    SVO_CAPI_ASSERT( (leaf_mask & SVO_LEAF_MASK_MASK) == leaf_mask );
 
     ///erase the bits we gonna write.
     child_descriptor->data &= ~SVO_LEAF_MASK_CDMASK;
@@ -433,49 +506,49 @@ static inline void svo_set_leaf_mask(child_descriptor_t* child_descriptor, child
     ///write the bits
     child_descriptor->data |= ((uint64_t)(leaf_mask) << SVO_LEAF_MASK_CD_POS) & SVO_LEAF_MASK_CDMASK;
 
-    assert(svo_get_leaf_mask(child_descriptor) == leaf_mask);
+    SVO_CAPI_FULL_ASSERT(svo_get_leaf_mask(child_descriptor) == leaf_mask);
 }
 
 
 
 static inline void svo_set_leaf_bit(child_descriptor_t* child_descriptor, ccurve_t ccurve, bool value)
 {
-    assert(child_descriptor);
-    assert(ccurve < 8);
+    SVO_CAPI_ASSERT(child_descriptor);
+    SVO_CAPI_ASSERT(ccurve < 8);
 
-#ifndef NDEBUG
+#if SVO_CHECK_LEVEL_CAPI >= SVO_CHECK_FULL && !defined(NDEBUG)
     uint64_t readonly_data0 = (child_descriptor->data & ~SVO_LEAF_MASK_CDMASK);
 #endif
     svo_set_nth_bit(child_descriptor, SVO_LEAF_MASK_CD_POS + ccurve, value);
-#ifndef NDEBUG
-    assert( bool((svo_get_leaf_mask(child_descriptor) >> ccurve) & 1) == value );
+#if SVO_CHECK_LEVEL_CAPI >= SVO_CHECK_FULL && !defined(NDEBUG)
+    SVO_CAPI_FULL_ASSERT( bool((svo_get_leaf_mask(child_descriptor) >> ccurve) & 1) == value );
     uint64_t readonly_data1 = (child_descriptor->data & ~SVO_LEAF_MASK_CDMASK);
-    assert( readonly_data0 == readonly_data1 );
+    SVO_CAPI_FULL_ASSERT( readonly_data0 == readonly_data1 );
 #endif
 }
 
 
 static inline uint32_t svo_get_contour_ptr(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     return (child_descriptor->data >> SVO_CONTOUR_PTR_CD_POS) & SVO_CONTOUR_PTR_MASK;
 }
 
 static inline child_mask_t svo_get_contour_mask(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     return (child_descriptor->data >> SVO_CONTOUR_MASK_CD_POS) & SVO_CONTOUR_MASK_MASK;
 }
 
 
 static inline goffset_t svo_get_ph_goffset(goffset_t goffset)
 {
-    assert(goffset != invalid_goffset);
-    assert( (goffset & goffset_mask) == goffset );
+    SVO_CAPI_ASSERT(goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (goffset & goffset_mask) == goffset );
 
     goffset_t result = (goffset_t)(goffset) & ~(goffset_t)(SVO_PAGE_SIZE-1);
-    assert((result & goffset_mask) == result);
-    assert(result != invalid_goffset);
+    SVO_CAPI_ASSERT((result & goffset_mask) == result);
+    SVO_CAPI_ASSERT(result != invalid_goffset);
 
     return result;
 }
@@ -484,10 +557,10 @@ static inline goffset_t svo_get_ph_goffset(goffset_t goffset)
 
 static inline svo_page_header_t* svo_get_ph(byte_t* address_space, goffset_t cd_goffset)
 {
-    assert(address_space);
-    assert(cd_goffset);
-    assert(cd_goffset != invalid_goffset);
-    assert( (cd_goffset & goffset_mask) == cd_goffset );
+    SVO_CAPI_ASSERT(address_space);
+    SVO_CAPI_ASSERT(cd_goffset);
+    SVO_CAPI_ASSERT(cd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (cd_goffset & goffset_mask) == cd_goffset );
 
     goffset_t ph_goffset = svo_get_ph_goffset(cd_goffset);
     svo_page_header_t* page_header = (svo_page_header_t*)(address_space + ph_goffset);
@@ -496,10 +569,10 @@ static inline svo_page_header_t* svo_get_ph(byte_t* address_space, goffset_t cd_
 
 static inline svo_info_section_t* info_section(byte_t* address_space, goffset_t cd_goffset)
 {
-    assert(address_space);
-    assert(cd_goffset);
-    assert(cd_goffset != invalid_goffset);
-    assert( (cd_goffset & goffset_mask) == cd_goffset );
+    SVO_CAPI_ASSERT(address_space);
+    SVO_CAPI_ASSERT(cd_goffset);
+    SVO_CAPI_ASSERT(cd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (cd_goffset & goffset_mask) == cd_goffset );
 
     const svo_page_header_t* page_header = svo_get_ph(address_space, cd_goffset);
     goffset_t ph_goffset = svo_get_ph_goffset(cd_goffset);
@@ -510,12 +583,48 @@ static inline svo_info_section_t* info_section(byte_t* address_space, goffset_t
     return (svo_info_section_t*)(info_ptr);
 }
 
+static inline goffset_t svo_get_info_section_goffset(const byte_t* address_space, goffset_t cd_goffset)
+{
+    SVO_CAPI_ASSERT(address_space);
+    SVO_CAPI_ASSERT(cd_goffset);
+    SVO_CAPI_ASSERT(cd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (cd_goffset & goffset_mask) == cd_goffset );
+
+    goffset_t ph_goffset = svo_get_ph_goffset(cd_goffset);
+    const svo_page_header_t* page_header = (const svo_page_header_t*)(address_space + ph_goffset);
+
+    return ph_goffset + page_header->info_offset;
+}
+
+static inline uint32_t svo_get_data_index(goffset_t cd_start, goffset_t pcd_goffset, ccurve_t ccurve)
+{
+    SVO_CAPI_ASSERT(ccurve < 8);
+    SVO_CAPI_ASSERT(pcd_goffset >= cd_start);
+    SVO_CAPI_ASSERT((pcd_goffset - cd_start) % sizeof(child_descriptor_t) == 0);
+
+    return (uint32_t)((pcd_goffset - cd_start) / sizeof(child_descriptor_t)) * 8 + ccurve;
+}
+
+static inline goffset_t svo_get_data_goffset(const byte_t* address_space, goffset_t pcd_goffset, ccurve_t ccurve
+                                            , uint32_t preceding_stride, uint32_t stride)
+{
+    goffset_t info_goffset = svo_get_info_section_goffset(address_space, pcd_goffset);
+    const svo_info_section_t* info = (const svo_info_section_t*)(address_space + info_goffset);
+
+    goffset_t cd_start = info_goffset - info->cd_start_offset;
+    goffset_t buffer_goffset = info_goffset + info->data_offset + info->data_entries * preceding_stride;
+    uint32_t data_index = svo_get_data_index(cd_start, pcd_goffset, ccurve);
+    SVO_CAPI_ASSERT(data_index < info->data_entries);
+
+    return buffer_goffset + data_index * stride;
+}
+
 static inline child_descriptor_t* svo_get_cd(byte_t* address_space, goffset_t cd_goffset)
 {
-    assert(address_space);
-    assert(cd_goffset);
-    assert(cd_goffset != invalid_goffset);
-    assert( (cd_goffset & goffset_mask) == cd_goffset );
+    SVO_CAPI_ASSERT(address_space);
+    SVO_CAPI_ASSERT(cd_goffset);
+    SVO_CAPI_ASSERT(cd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (cd_goffset & goffset_mask) == cd_goffset );
     child_descriptor_t* cd = (child_descriptor_t*)(address_space + cd_goffset);
 
     return cd;
@@ -524,28 +633,29 @@ static inline child_descriptor_t* svo_get_cd(byte_t* address_space, goffset_t cd
 
 static inline const child_descriptor_t* svo_cget_cd(const byte_t* address_space, goffset_t cd_goffset)
 {
-    assert(address_space);
-    assert(cd_goffset);
-    assert(cd_goffset != invalid_goffset);
-    assert( (cd_goffset & goffset_mask) == cd_goffset );
+    SVO_CAPI_ASSERT(address_space);
+    SVO_CAPI_ASSERT(cd_goffset);
+    SVO_CAPI_ASSERT(cd_goffset != invalid_goffset);
+    SVO_CAPI_ASSERT( (cd_goffset & goffset_mask) == cd_goffset );
     const child_descriptor_t* cd = (const child_descriptor_t*)(address_space + cd_goffset);
 
     return cd;
 }
 
 
-static inline fast_uint8_t svo_get_cd_child_index(const child_descriptor_t* child_descriptor, ccurve_t child_ccurve)
+
+
+static inline fast_uint8_t svo_get_cd_nonleaf_count_check(const child_descriptor_t* child_descriptor)
 {
-    ///sanity checks
-    assert(child_ccurve < 8);
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
 
     fast_uint8_t result = 0;
     child_mask_t valid_mask = svo_get_valid_mask(child_descriptor);
     child_mask_t leaf_mask = svo_get_leaf_mask(child_descriptor);
 
+
     ///for each bit that is set as valid but a non-leaf, we increment the result index.
-    for (ccurve_t ccurve = 0; ccurve < child_ccurve; ++ccurve)
+    for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
     {
         bool valid_bit = (valid_mask >> ccurve) & 1;
         bool leaf_bit = (leaf_mask >> ccurve) & 1;
@@ -557,30 +667,24 @@ static inline fast_uint8_t svo_get_cd_child_index(const child_descriptor_t* chil
         }
     }
 
-    ///also double check that the child requested actually exists.
-    assert( (valid_mask >> child_ccurve) & 1);
-    assert( !((leaf_mask >> child_ccurve) & 1));
-
     return result;
 }
 
 
-static inline fast_uint8_t svo_get_cd_nonleaf_count_check(const child_descriptor_t* child_descriptor)
+static inline fast_uint8_t svo_get_cd_valid_count_check(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
 
     fast_uint8_t result = 0;
     child_mask_t valid_mask = svo_get_valid_mask(child_descriptor);
-    child_mask_t leaf_mask = svo_get_leaf_mask(child_descriptor);
 
 
     ///for each bit that is set as valid but a non-leaf, we increment the result index.
     for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
     {
         bool valid_bit = (valid_mask >> ccurve) & 1;
-        bool leaf_bit = (leaf_mask >> ccurve) & 1;
 
-        if (valid_bit && !leaf_bit)
+        if (valid_bit)
         {
             ++result;
             continue;
@@ -589,22 +693,20 @@ static inline fast_uint8_t svo_get_cd_nonleaf_count_check(const child_descriptor
 
     return result;
 }
-
-
-static inline fast_uint8_t svo_get_cd_valid_count_check(const child_descriptor_t* child_descriptor)
+static inline fast_uint8_t svo_get_cd_leaf_count_check(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
 
     fast_uint8_t result = 0;
-    child_mask_t valid_mask = svo_get_valid_mask(child_descriptor);
+    child_mask_t leaf_mask = svo_get_leaf_mask(child_descriptor);
 
 
     ///for each bit that is set as valid but a non-leaf, we increment the result index.
     for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
     {
-        bool valid_bit = (valid_mask >> ccurve) & 1;
+        bool leaf_bit = (leaf_mask >> ccurve) & 1;
 
-        if (valid_bit)
+        if (leaf_bit)
         {
             ++result;
             continue;
@@ -613,55 +715,83 @@ static inline fast_uint8_t svo_get_cd_valid_count_check(const child_descriptor_t
 
     return result;
 }
-static inline fast_uint8_t svo_get_cd_leaf_count_check(const child_descriptor_t* child_descriptor)
+
+static inline fast_uint8_t svo_get_cd_child_index_check(const child_descriptor_t* child_descriptor, ccurve_t child_ccurve)
 {
-    assert(child_descriptor);
+    ///sanity checks
+    SVO_CAPI_ASSERT(child_ccurve < 8);
+    SVO_CAPI_ASSERT(child_descriptor);
 
     fast_uint8_t result = 0;
+    child_mask_t valid_mask = svo_get_valid_mask(child_descriptor);
     child_mask_t leaf_mask = svo_get_leaf_mask(child_descriptor);
 
-
     ///for each bit that is set as valid but a non-leaf, we increment the result index.
-    for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
+    for (ccurve_t ccurve = 0; ccurve < child_ccurve; ++ccurve)
     {
+        bool valid_bit = (valid_mask >> ccurve) & 1;
         bool leaf_bit = (leaf_mask >> ccurve) & 1;
 
-        if (leaf_bit)
+        if (valid_bit && !leaf_bit)
         {
             ++result;
             continue;
         }
     }
 
+    ///also double check that the child requested actually exists.
+    SVO_CAPI_ASSERT( (valid_mask >> child_ccurve) & 1);
+    SVO_CAPI_ASSERT( !((leaf_mask >> child_ccurve) & 1));
+
+    return result;
+}
+
+static inline fast_uint8_t svo_get_cd_child_index(const child_descriptor_t* child_descriptor, ccurve_t child_ccurve)
+{
+    ///sanity checks
+    SVO_CAPI_ASSERT(child_ccurve < 8);
+    SVO_CAPI_ASSERT(child_descriptor);
+
+    ///the nonleaf children are stored in ccurve order, so the index is the number of nonleaf
+    /// children before this one.
+    child_mask_t nonleaf_mask = svo_get_nonleaf_mask(child_descriptor);
+    child_mask_t preceding_mask = (child_mask_t)(nonleaf_mask & ((1U << child_ccurve) - 1));
+
+    fast_uint8_t result = svo_count_bits_uint8(preceding_mask);
+
+    ///also double check that the child requested actually exists.
+    SVO_CAPI_ASSERT( (nonleaf_mask >> child_ccurve) & 1 );
+    SVO_CAPI_FULL_ASSERT( result == svo_get_cd_child_index_check(child_descriptor, child_ccurve) );
+
     return result;
 }
 
 static inline fast_uint8_t svo_get_cd_nonleaf_count(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     child_mask_t nonleaf_mask = svo_get_nonleaf_mask(child_descriptor);
 
     fast_uint8_t result = svo_count_bits_uint8(nonleaf_mask);
-    assert( result == svo_get_cd_nonleaf_count_check(child_descriptor) );
+    SVO_CAPI_FULL_ASSERT( result == svo_get_cd_nonleaf_count_check(child_descriptor) );
     return result;
 }
 static inline fast_uint8_t svo_get_cd_valid_count(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     child_mask_t valid_mask = svo_get_valid_mask(child_descriptor);
 
     fast_uint8_t result = svo_count_bits_uint8(valid_mask);
-    assert( result == svo_get_cd_valid_count_check(child_descriptor) );
+    SVO_CAPI_FULL_ASSERT( result == svo_get_cd_valid_count_check(child_descriptor) );
     return result;
 }
 
 static inline fast_uint8_t svo_get_cd_leaf_count(const child_descriptor_t* child_descriptor)
 {
-    assert(child_descriptor);
+    SVO_CAPI_ASSERT(child_descriptor);
     child_mask_t leaf_mask = svo_get_leaf_mask(child_descriptor);
 
     fast_uint8_t result = svo_count_bits_uint8(leaf_mask);
-    assert( result == svo_get_cd_leaf_count_check(child_descriptor) );
+    SVO_CAPI_FULL_ASSERT( result == svo_get_cd_leaf_count_check(child_descriptor) );
     return result;
 }
 
@@ -21,6 +21,7 @@ struct volume_of_slices_t;
 struct svo_slice_child_group_t;
 struct svo_block_sanity_error_t;
 struct svo_slice_sanity_error_t;
+struct svo_arena_t;
 
 } //namespace svo
 
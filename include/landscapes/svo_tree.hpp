@@ -61,8 +61,17 @@ static inline T ilog2(T value);
 ////////////////////////////////////////////////////////////////////////////////
 
 
-svo_slice_t* svo_init_slice(std::size_t level, vside_t side, void* userdata=0);
-svo_slice_t* svo_clone_slice(const svo_slice_t* slice, bool recursive=true);
+/**
+ * Creates an empty slice.
+ *
+ * If @c arena is not null, the slice, its @c pos_data and @c children vector objects, and the storage
+ *  of its buffers are allocated from it; svo_uninit_slice() then only destroys them, and the memory is
+ *  freed with the arena. The elements of @c pos_data and @c children are still on the heap, and are
+ *  freed when the vectors are destroyed. Slices split from the slice are allocated from the same arena.
+ */
+svo_slice_t* svo_init_slice(std::size_t level, vside_t side, void* userdata=0, svo_arena_t* arena=0);
+///clones @c slice, and its children if @c recursive, allocating the clones from @c arena (see svo_init_slice()).
+svo_slice_t* svo_clone_slice(const svo_slice_t* slice, bool recursive=true, svo_arena_t* arena=0);
 void svo_uninit_slice(svo_slice_t* slice, bool recursive=true);
 /**
  * Attaches a child slice to a parent slice.
@@ -87,7 +96,25 @@ void svo_slice_attach_child(svo_slice_t* parent, svo_slice_t* child, vcurve_t po
 
 void svo_slice_detatch(svo_slice_t* slice);
 
-void svo_split_slice(const svo_slice_t* src_slice, std::vector<svo_slice_t*>& dst_slices);
+/**
+ * Splits a slice into its 8 octants, the reverse of @c svo_join_slices().
+ *
+ * Each destination slice is half the side of the src slice, at the same level. Its pos_data is
+ *  rebased to the octant, and its buffers are views of the src slice's buffers; see svo_cpu_buffer_t.
+ *  If the src slice has a parent, the destination slices replace it there. The children of the src
+ *  slice are moved to the destination slice of their octant; a child that spans several octants is
+ *  split as well.
+ *
+ * @param src_slice
+ *          The slice to split; its side must be at least 2, and at least 4 if it has a parent.
+ * @param dst_slices
+ *          The destination slices, in morton order of their octant; an octant with no voxels and no
+ *           children has no slice, and is null.
+ *
+ * Afterwards @c src_slice has no parent and no children, but keeps its data; it is not freed, you must do
+ *  this yourself after calling this function.
+ */
+void svo_split_slice(svo_slice_t* src_slice, std::array<svo_slice_t*, 8>& dst_slices);
 /**
  * Joins 8 sibling slices into one larger slice.
  *
@@ -221,7 +248,7 @@ struct svo_block_t{
     void reset();
     std::size_t size() const{ return block_end - block_start; }
     std::size_t freesize() const{
-        return (cdspace_end - cd_end) + (block_end - (info_goffset+sizeof(svo_info_section_t)));
+        return (cdspace_end - cd_end) + (dataspace_end - data_end);
     }
 
     bool is_in_block(goffset_t goffset, std::size_t size = 1) const;
@@ -235,6 +262,14 @@ struct svo_block_t{
     bool has_root_children_goffset() const;
     bool check_parent_root_cd(std::vector<std::string>& issues) const;
     bool check_parent_root_cd() const;
+
+    ///the number of entries the buffers need to hold the data of every CD slot in [cd_start, cd_end),
+    /// i.e. 8 per slot; see svo_get_data_index().
+    std::size_t data_slots() const;
+    ///resizes the buffers to data_slots() entries.
+    void fit_data();
+    ///writes the block's layout into the info section at @c info_goffset.
+    void update_info_section();
     
     
     svo_tree_t* tree;
@@ -256,6 +291,8 @@ struct svo_block_t{
     goffset_t cd_end;
     goffset_t cdspace_end;
 
+    ///the data section holds the buffers, back to back; the entry of a voxel is found from its
+    /// parent's CD, see svo_get_data_goffset().
     goffset_t data_start;
     goffset_t data_end;
     goffset_t dataspace_end;
@@ -317,8 +354,22 @@ struct svo_tree_t{
 
 
     svo_tree_t(std::size_t size, std::size_t block_size);
+    /**
+     * Creates a tree over an existing, page aligned address space, without any blocks.
+     *
+     * The tree does not own @c address_space. This is for loaders that restore the blocks themselves
+     *  with adopt_block(), see svo_block_image.hpp.
+     */
+    svo_tree_t(byte_t* address_space, std::size_t size);
     svo_block_t* allocate_block(std::size_t size);
     void deallocate_block(svo_block_t* block);
+    /**
+     * Registers a block over the existing memory @c [block_start,block_end), which must be free.
+     *
+     * Only the bounds and @c tree of the returned block are set; the caller fills in the rest, and
+     *  then calls update_block_lookup_info().
+     */
+    svo_block_t* adopt_block(goffset_t block_start, goffset_t block_end);
 
     void update_block_lookup_info(svo_block_t* block);
 
@@ -362,6 +413,7 @@ private:
 
 
     mem_range_t mem_malloc(std::size_t size);
+    void mem_reserve(mem_range_t mem_range);
 
     std::size_t mem_range_size(mem_range_t mem_range);
     mem_range_t find_freemem_range(std::size_t size);
@@ -426,7 +478,7 @@ struct svo_slice_t{
     /// world-space as the parent cube, then @c side would be double of parent_slice->side,
     /// as this level has double the resolution of the parent level.
     ///This value must be a power of 2, and less than or equal to twice the side of the parent slice.
-    ///Maximum value right now is also 256; any more and the morton encoding functions break.
+    ///Maximum value is SVO_VSIDE_LIMIT; 256, or 2^21 with 64 bit vcurves (SVO_VCURVE_64).
     vside_t side;
 
     ///This is the position of this cube within the parent cube (at the parent slice's resolution).
@@ -460,6 +512,9 @@ struct svo_slice_t{
     children_t* children;
 
     void* userdata;
+
+    ///the arena the slice was allocated from, or null for the heap; see svo_init_slice().
+    svo_arena_t* arena;
 };
 
 
@@ -2,12 +2,50 @@
 #define SVO_TREE_INL_HPP 1
 
 #include "debug_macro.h"
+#include "svo_inttypes.h"
 
+#include <algorithm>
+#include <stdexcept>
 
 //#include "prettyprint.hpp"
 
 namespace svo{
 
+namespace detail{
+    /**
+     * A stack of at most @c N items, stored inline; used by the traversals below, whose stacks are bounded
+     *  by the depth of the tree, so that they do not allocate.
+     */
+    template<typename T, std::size_t N>
+    struct fixed_stack_t{
+        fixed_stack_t() : m_size(0) {}
+
+        bool empty() const{ return m_size == 0; }
+        std::size_t size() const{ return m_size; }
+
+        ///throws if the stack is full, i.e. the tree is deeper than MAXIMUM_TREE_DEPTH, e.g. if it is corrupt.
+        void push(const T& item){
+            if (m_size == N)
+                throw std::runtime_error("traversal deeper than MAXIMUM_TREE_DEPTH");
+            m_items[m_size++] = item;
+        }
+        void pop(){
+            assert(m_size > 0);
+            --m_size;
+        }
+        T& top(){
+            assert(m_size > 0);
+            return m_items[m_size - 1];
+        }
+
+        T* begin(){ return m_items; }
+        T* end(){ return m_items + m_size; }
+    private:
+        T m_items[N];
+        std::size_t m_size;
+    };
+} // namespace detail
+
 template<typename T>
 static inline bool overlap(T x1, T x2, T y1, T y2)
 {
@@ -202,97 +240,80 @@ inline void z_preorder_traverse_block_cds(const byte_t* address_space, const svo
     if (block->root_shadow_cd_goffset == invalid_goffset)
         return;
 
-    typedef std::tuple<goffset_t, goffset_t, ccurve_t, metadata_t> node_t;
-    typedef std::vector< node_t > stack_t;
+    ///(cd goffset, metadata) of the CDs whose children are still to be visited. Each CD pushes at most
+    /// its 8 children and pops itself, so the stack grows by at most 7 per level.
+    typedef std::tuple<goffset_t, metadata_t> node_t;
+    detail::fixed_stack_t<node_t, 8*MAXIMUM_TREE_DEPTH> parent_stack;
 
     ///put the root node into the parent stack, we already visited it.
-    stack_t parent_stack{ std::make_tuple(invalid_goffset, block->root_shadow_cd_goffset, block->root_ccurve, root_meta_data) };
+    parent_stack.push(node_t(block->root_shadow_cd_goffset, root_meta_data));
+
+    while (!parent_stack.empty())
+    {
+        goffset_t cd_goffset; metadata_t metadata;
+        std::tie(cd_goffset, metadata) = parent_stack.top(); parent_stack.pop();
 
-    node_t node;
-    bool node_valid = false;
+        SCAFFOLDING{
+            if (debug)
+                std::cout << "cd_goffset: " << cd_goffset << std::endl;
+        }
 
+        assert(cd_goffset != 0 && cd_goffset != invalid_goffset);
+        assert(block->is_valid_cd_goffset(cd_goffset));
+        const auto* cd = svo_cget_cd(address_space, cd_goffset);
 
-    while (parent_stack.size() > 0 || node_valid)
-    {
-        if (node_valid)
-        {
-            auto cd_goffset = std::get<1>(node);
-            auto metadata = std::get<3>(node);
+        child_mask_t valid_mask = svo_get_valid_mask(cd);
+        child_mask_t leaf_mask = svo_get_leaf_mask(cd);
+
+        assert(((~valid_mask) & leaf_mask) == 0);
 
+        if (valid_mask == 0)
+        {
             SCAFFOLDING{
                 if (debug)
-                    std::cout << "cd_goffset: " << cd_goffset << std::endl;
+                    std::cout << "nope, no children, moving on" << std::endl;
             }
+            continue;
+        }
 
-            assert(cd_goffset != 0 && cd_goffset != invalid_goffset);
-            assert(block->is_valid_cd_goffset(cd_goffset));
-            const auto* cd = svo_get_cd(block->tree->address_space, cd_goffset);
-            
-            
-            assert((((~svo_get_valid_mask(cd)) & svo_get_leaf_mask(cd)) == 0));
-            
-            if (svo_get_cd_valid_count(cd) == 0) {
-                node_valid = false;
+        SCAFFOLDING{
+            if (debug)
+                std::cout << "ok going through the children" << std::endl;
+        }
 
-                SCAFFOLDING{
-                    if (debug)
-                        std::cout << "nope, no children, moving on" << std::endl;
-                }
-                
+        std::size_t siblings_begin = parent_stack.size();
+        for (ccurve_t child_ccurve = 0; child_ccurve < 8; ++child_ccurve)
+        {
+            bool valid_bit = (valid_mask >> child_ccurve) & 1;
+            bool leaf_bit = (leaf_mask >> child_ccurve) & 1;
+
+            SCAFFOLDING{
+                if (debug)
+                    std::cout << "valid_bit: " << (valid_bit ? "true" : "false")
+                              << ", leaf_bit: " << (leaf_bit ? "true" : "false") << std::endl;
+            }
+            if (!valid_bit)
                 continue;
-            } else {
 
-                SCAFFOLDING{
-                    if (debug)
-                        std::cout << "ok going through the children" << std::endl;
-                }
-                
-                stack_t sibling_stack;
-                for (ccurve_t child_ccurve = 0; child_ccurve < 8; ++child_ccurve)
-                {
-                    assert(child_ccurve < 8);
-
-                    bool valid_bit = svo_get_valid_bit(cd, child_ccurve);
-                    bool leaf_bit = svo_get_leaf_bit(cd, child_ccurve);
-
-                    SCAFFOLDING{
-                        if (debug)
-                            std::cout << "valid_bit: " << (valid_bit ? "true" : "false")
-                                      << ", leaf_bit: " << (leaf_bit ? "true" : "false") << std::endl;
-                    }
-                    if (valid_bit)
-                    {
-                        if (!leaf_bit)
-                        {
-                            goffset_t child_cd_goffset = svo_get_child_cd_goffset(block->tree->address_space, cd_goffset, cd, child_ccurve);
-                            assert(child_cd_goffset != 0 && child_cd_goffset != invalid_goffset);
-
-                            if (!(block->is_valid_cd_goffset(child_cd_goffset)))
-                            {
-                                continue;
-                            }
-
-                            auto child_meta_data = visitor(cd_goffset, child_cd_goffset, child_ccurve, metadata);
-                            sibling_stack.push_back( std::make_tuple(cd_goffset, child_cd_goffset, child_ccurve, child_meta_data) );
-                        } else {
-                            ///add a leaf voxel; current cd will be the parent, and no cd is specified.
-
-                            auto child_meta_data = visitor(cd_goffset, invalid_goffset, child_ccurve, metadata);
-                            UNUSED(child_meta_data);
-                            //sibling_stack.push_back( std::make_tuple(cd_goffset, invalid_goffset, child_ccurve, child_meta_data) );
-                        }
-                    }
+            if (!leaf_bit)
+            {
+                goffset_t child_cd_goffset = svo_get_child_cd_goffset(address_space, cd_goffset, cd, child_ccurve);
+                assert(child_cd_goffset != 0 && child_cd_goffset != invalid_goffset);
 
-                }
+                if (!(block->is_valid_cd_goffset(child_cd_goffset)))
+                    continue;
 
-                ///put the children in the stack in the right order.
-                parent_stack.insert(parent_stack.end(), sibling_stack.rbegin(), sibling_stack.rend());
-                node_valid = false;
+                auto child_meta_data = visitor(cd_goffset, child_cd_goffset, child_ccurve, metadata);
+                parent_stack.push(node_t(child_cd_goffset, child_meta_data));
+            } else {
+                ///a leaf voxel; current cd is the parent, and no cd is specified.
+                auto child_meta_data = visitor(cd_goffset, invalid_goffset, child_ccurve, metadata);
+                UNUSED(child_meta_data);
             }
-        } else {
-            node = parent_stack.back(); parent_stack.pop_back();
-            node_valid = true;
         }
+
+        ///put the children in the stack in the right order, so that the first is popped first.
+        std::reverse(parent_stack.begin() + siblings_begin, parent_stack.end());
     }
 
 }
@@ -351,35 +372,33 @@ inline void levelorder_traverse_block_cds(byte_t* address_space, svo_block_t* bl
 template<typename svo_block_type, typename metadata_t, typename visitor_f>
 inline void preorder_traverse_blocks(svo_block_type* block0, metadata_t metadata0, visitor_f visitor)
 {
+    assert(block0);
 
-    {
-        std::vector< std::tuple<svo_block_type*, svo_block_type*, metadata_t> > stack{ std::make_tuple(nullptr, block0, metadata0) };
-        while (stack.size() > 0)
-        {
-            svo_block_type* parent_block;
-            svo_block_type* current_block;
-            metadata_t current_metadata;
-            std::tie(parent_block, current_block, current_metadata) = stack.back();stack.pop_back();
-            assert(current_block);
-
-            metadata_t next_metadata = visitor(parent_block, current_block, current_metadata);
-
-            assert(current_block->child_blocks);
-
-            auto wend = current_block->child_blocks->crend();
-            //for ( svo_slice_t* child : *current_slice->children )
-            for (auto w = current_block->child_blocks->rbegin(); w != wend; ++w)
-            {
-                svo_block_type* child = *w;
+    ///(block, metadata for its children, index of the next child to visit); a child block is at least a
+    /// level below its parent, so there is at most a frame per level.
+    typedef std::tuple<svo_block_type*, metadata_t, std::size_t> frame_t;
+    detail::fixed_stack_t<frame_t, MAXIMUM_TREE_DEPTH + 1> stack;
 
-                assert(child);
-                assert(child->parent_block == current_block);
+    stack.push(frame_t(block0, visitor(nullptr, block0, metadata0), 0));
+    while (!stack.empty())
+    {
+        frame_t& frame = stack.top();
+        svo_block_type* current_block = std::get<0>(frame);
+        assert(current_block);
+        assert(current_block->child_blocks);
 
-                stack.push_back( std::make_tuple(parent_block, child, next_metadata) );
-            }
+        std::size_t child_index = std::get<2>(frame)++;
+        if (child_index == current_block->child_blocks->size())
+        {
+            stack.pop();
+            continue;
+        }
 
+        svo_block_type* child = (*current_block->child_blocks)[child_index];
+        assert(child);
+        assert(child->parent_block == current_block);
 
-        }
+        stack.push(frame_t(child, visitor(current_block, child, std::get<1>(frame)), 0));
     }
 }
 
@@ -388,33 +407,34 @@ inline void preorder_traverse_blocks(svo_block_type* block0, metadata_t metadata
 template<typename MetaDataT, typename VisitorF>
 inline void preorder_traverse_slices(svo_slice_t* root_slice, MetaDataT metadata0, VisitorF visitor)
 {
+    assert(root_slice);
 
-    {
-        std::vector< std::tuple<svo_slice_t*, MetaDataT> > stack{ std::make_tuple(root_slice, metadata0) };
-        while (stack.size() > 0)
-        {
-            svo_slice_t* current_slice; MetaDataT current_metadata;
-            std::tie(current_slice, current_metadata) = stack.back();stack.pop_back();
-            assert(current_slice);
-
-            MetaDataT next_metadata = visitor(current_slice, current_metadata);
+    ///(slice, metadata for its children, index of the next child to visit); a child slice is at least a
+    /// level below its parent, so there is at most a frame per level. The children of a slice are read
+    /// after it is visited, so the visitor may change them.
+    typedef std::tuple<svo_slice_t*, MetaDataT, std::size_t> frame_t;
+    detail::fixed_stack_t<frame_t, MAXIMUM_TREE_DEPTH + 1> stack;
 
-            assert(current_slice->children);
-
-            auto wend = current_slice->children->crend();
-            //for ( svo_slice_t* child : *current_slice->children )
-            for (auto w = current_slice->children->rbegin(); w != wend; ++w)
-            {
-                svo_slice_t* child = *w;
-
-                assert(child);
-                assert(child->parent_slice == current_slice);
+    stack.push(frame_t(root_slice, visitor(root_slice, metadata0), 0));
+    while (!stack.empty())
+    {
+        frame_t& frame = stack.top();
+        svo_slice_t* current_slice = std::get<0>(frame);
+        assert(current_slice);
+        assert(current_slice->children);
 
-                stack.push_back( std::make_tuple(child, next_metadata) );
-            }
+        std::size_t child_index = std::get<2>(frame)++;
+        if (child_index == current_slice->children->size())
+        {
+            stack.pop();
+            continue;
+        }
 
+        svo_slice_t* child = (*current_slice->children)[child_index];
+        assert(child);
+        assert(child->parent_slice == current_slice);
 
-        }
+        stack.push(frame_t(child, visitor(child, std::get<1>(frame)), 0));
     }
 }
 
@@ -0,0 +1,35 @@
+#ifndef SVO_TREE_LOD_H
+#define SVO_TREE_LOD_H 1
+
+#include "svo_inttypes.h"
+#include "opencl.shim.h"
+
+#ifndef __OPENCL_VERSION__
+#include <math.h>
+#endif
+
+/**
+ * Inverse of svo_voxelpixelerror(); the deepest level that can still be larger than a pixel at
+ * @c distance, i.e. the level past which the traversal will never descend for this @c rayScale2.
+ *
+ * Useful for deciding which levels of a block have to be resident.
+ */
+static inline
+uint32_t svo_lod_max_level(float distance, float rayScale2)
+{
+    if (!(distance > 0))
+        return MAXIMUM_TREE_DEPTH;
+
+    ///svo_voxelpixelerror() descends while (q^2 * rayScale2) > distance^2, where q = 1/2^level;
+    /// so it stops at the first level where 2^level >= sqrt(rayScale2) / distance.
+    float ratio = sqrt(rayScale2) / distance;
+    if (!(ratio > 1))
+        return 0;
+
+    float level = ceil(log2(ratio));
+    if (level >= MAXIMUM_TREE_DEPTH)
+        return MAXIMUM_TREE_DEPTH;
+    return (uint32_t)level;
+}
+
+#endif
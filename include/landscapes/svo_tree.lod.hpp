@@ -0,0 +1,58 @@
+#ifndef SVO_TREE_LOD_HPP
+#define SVO_TREE_LOD_HPP 1
+
+#include "svo_tree.lod.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace svo{
+
+/**
+ * Adaptive LOD controller for the renderer.
+ *
+ * svo_voxelpixelerror() stops descending once a voxel projects smaller than a pixel, using
+ * @c rayScale2. This controller scales @c rayScale2 every frame to keep the frame time near a
+ * budget: a lower @c rayScale2 makes the traversal stop at coarser levels. It can also tell the
+ * block streamer the deepest level the traversal can reach at a given distance.
+ */
+struct svo_lod_controller_t{
+    /**
+     * @param base_ray_scale2
+     *          The "exact" @c rayScale2, i.e. (1/(2 tan(fov_per_pixel/2)))^2; never exceeded.
+     * @param target_frame_ms
+     *          The frame time budget.
+     * @param min_quality
+     *          The lowest fraction of @c base_ray_scale2 we are allowed to fall to; in (0,1].
+     */
+    svo_lod_controller_t(float base_ray_scale2, double target_frame_ms, float min_quality = 1.f/64);
+
+    ///feed the time of the last frame; returns the @c rayScale2 to use for the next frame.
+    float update(double frame_ms);
+
+    ///the current @c rayScale2 to pass to svo_tree_raymarch().
+    float ray_scale2() const;
+
+    ///deepest level needed by anything at @c distance (in root-cube units) from the camera.
+    uint32_t max_level(float distance) const;
+
+    void reset();
+
+    float base_ray_scale2;
+    double target_frame_ms;
+    float min_quality;
+
+    ///frame times within +/- this fraction of the budget do not change the quality.
+    double dead_band;
+    ///how aggressively to react; 1 would try to fix the whole error in one frame.
+    double gain;
+    ///weight of the newest frame in the smoothed frame time, in (0,1].
+    double smoothing;
+
+    ///current fraction of @c base_ray_scale2 in use, in [min_quality, 1].
+    float quality;
+    double smoothed_frame_ms;
+};
+
+} // namespace svo
+
+#endif
@@ -6,8 +6,8 @@
 #include "opencl.shim.h"
 #include "common.math.cl.h"
 #include "svo_tree.capi.h"
-
-#define MAXIMUM_TREE_DEPTH 30
+#include "svo_tree.raymarch.stats.h"
+#include "svo_tree.lod.h"
 
 #ifdef __OPENCL_VERSION__
 
@@ -796,7 +796,8 @@ svo_locate_node(svo_stack_t* stack
         
         corner_t child_corner = get_corner_by_int3(xcorneridx, ycorneridx, zcorneridx);
         
-        if (!svo_tree_has_children(address_space, current_node))
+        ///stop at an empty child too; the traversal will advance out of it.
+        if (!svo_tree_voxelexists(address_space, current_node) || !svo_tree_has_children(address_space, current_node))
             break;
         
         node_info_t child = svo_tree_get_child(address_space, current_node, child_corner);
@@ -956,20 +957,13 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
     , float3_t raypos, float3_t raydir, float rayScale2
     , float3_t* out_normal
     , float* out_t
-#ifdef RAYMARCH_COMPUTE_ITERATIONS
-    , int* out_iterations
-#endif
-#ifdef RAYMARCH_COMPUTE_LEVELS
-    , int* out_levels
-#endif
+    , svo_raymarch_stats_t* out_stats
     )
 {
 #ifdef __cplusplus
     using namespace svo;
 #endif
-#ifdef RAYMARCH_COMPUTE_ITERATIONS
-        int iterations = 0;
-#endif
+    svo_raymarch_stats_init(out_stats);
 
 
     
@@ -1044,6 +1038,10 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
 #endif
         ///the starting position is inside the root node
 
+        ///the root itself sits at the bottom of the stack, as in the outside case, so that the
+        /// children of the root are at level 1.
+        svo_stack_push(&stack, &current);
+
         located_node_t located_node = svo_locate_node(&stack, address_space, root_lower, root_scale, raypos, raydir, raydirinv, root_cd_goffset, MAXIMUM_TREE_DEPTH);
         //std::tie(current.parent,current.corner,lower) = locate_node(stack, tree, raypos, tree.root(), null_corner);
         current = located_node.node;
@@ -1285,9 +1283,7 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
 
         uint32_t level = stack.size;
 
-#ifdef RAYMARCH_COMPUTE_ITERATIONS
-        iterations++;
-#endif
+        svo_raymarch_stats_iteration(out_stats, level);
 
         ///if the corner is invalid, it means we are outside of the parent.
         if (rayisoutside)
@@ -1305,6 +1301,7 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
             node_info_t next = svo_stack_back(&stack);
             assert(stack.size > 0);
             svo_stack_pop(&stack);
+            svo_raymarch_stats_pop(out_stats);
 
 
             {
@@ -1384,6 +1381,7 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
 
         //node_descriptor_t current_node = svo_tree_get_child(address_space, current.parent,current.corner);
 
+        svo_raymarch_stats_cd_fetch(out_stats);
         if (svo_tree_voxelexists(address_space,current))
         {
 
@@ -1399,12 +1397,6 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
                     {
 #ifdef RAYMARCHDEBUGRAYMARCH
                         std::cout << "!voxelpixelerror" << std::endl;
-#endif
-#ifdef RAYMARCH_COMPUTE_ITERATIONS
-                        *out_iterations = iterations;
-#endif
-#ifdef RAYMARCH_COMPUTE_LEVELS
-                        *out_levels = level;
 #endif
                         *out_t = minraylength2 + sdistancef3(raypos, dir_lower);
                         face_t inface = opposite_face(outface);
@@ -1413,6 +1405,7 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
 
                         *out_normal = glm_normalize(make_float3(get_direction_x(inface), get_direction_y(inface), get_direction_z(inface)));
 
+                        svo_raymarch_stats_hit(out_stats, level);
                         return true;
                     }
                 }
@@ -1421,18 +1414,13 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
                 {
 #ifdef RAYMARCHDEBUGRAYMARCH
                     std::cout << "svo_tree_isleaf_f3()" << std::endl;
-#endif
-#ifdef RAYMARCH_COMPUTE_ITERATIONS
-                    *out_iterations = iterations;
-#endif
-#ifdef RAYMARCH_COMPUTE_LEVELS
-                    *out_levels = level;
 #endif
                     face_t inface = opposite_face(outface);
                     //float shade = .5;
                     *out_normal = glm_normalize(make_float3(get_direction_x(inface), get_direction_y(inface), get_direction_z(inface)));
 
                     *out_t = minraylength2 + sdistancef3(raypos, dir_lower);
+                    svo_raymarch_stats_hit(out_stats, level);
                     return true;
                 }
 
@@ -1446,7 +1434,9 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
                     float scale = 1.0 / (1 << level);
                     float child_scale = 1.0 / (1 << next_level);
 
+                    svo_raymarch_stats_child_fetch(out_stats, svo_cget_cd(address_space, current.parent));
                     svo_stack_push(&stack,&current);
+                    svo_raymarch_stats_push(out_stats);
 
 
                     ///calculate next corner corner
@@ -1589,4 +1579,243 @@ bool svo_tree_raymarch(const uint8_t* address_space, goffset_t root_cd_goffset
 }
 
 
+
+/**
+ * Any-hit variant of svo_tree_raymarch(), meant for shadow rays and occlusion queries.
+ *
+ * The traversal is the same front-to-back descent, but it only answers "is anything in the way";
+ * it terminates on the first voxel that is a leaf or that passes the pixel-error test, and it
+ * never computes a normal or an exact hit distance. The front-to-back order is only used as a
+ * heuristic to reach a blocker early, and to stop once the ray has gone past @c max_t2.
+ *
+ * @param max_t2
+ *          The squared distance along the ray past which hits do not count (i.e. the squared
+ *          distance to the light); pass @c fposinf for an unbounded ray.
+ * @return true if the ray is occluded within @c max_t2.
+ */
+static inline
+bool svo_tree_raymarch_anyhit(const uint8_t* address_space, goffset_t root_cd_goffset
+    , float3_t raypos, float3_t raydir, float rayScale2
+    , float max_t2)
+{
+#ifdef __cplusplus
+    using namespace svo;
+#endif
+
+    float3_t raydirinv = make_float3(1.0) / raydir;
+
+    svo_stack_t stack;
+    stack.size = 0;
+    stack.capacity = MAXIMUM_TREE_DEPTH;
+
+    float root_scale = 1.0;
+
+    float3_t root_lower = make_float3(0,0,0);
+    float3_t root_upper = make_float3(1,1,1);
+
+    float3_t cube_normalized_dir = make_float3( raydir.x < 0 ? -1 : 1, raydir.y < 0 ? -1 : 1, raydir.z < 0 ? -1 : 1);
+
+    node_info_t current = tree_null();
+    face_t outface = null_face;
+    bool rayisoutside = false;
+    float3_t t1 = make_float3(0,0,0);
+    float3_t lower = make_float3(0,0,0);
+
+    ///squared distance from @c raypos to the point where the ray enters the current node; a lower
+    /// bound for anything we can still hit, since we march front-to-back.
+    float entry_t2 = 0;
+
+    if (!svo_fast_forward_intersects_f3(root_lower, root_upper, raypos, raydirinv))
+        return false;
+
+    if (containsf3(root_lower, root_upper, raypos))
+    {
+        ///the root itself sits at the bottom of the stack, as in the outside case, so that the
+        /// children of the root are at level 1.
+        svo_stack_push(&stack, &current);
+
+        located_node_t located_node = svo_locate_node(&stack, address_space, root_lower, root_scale, raypos, raydir, raydirinv, root_cd_goffset, MAXIMUM_TREE_DEPTH);
+        current = located_node.node;
+        lower = located_node.lower;
+
+        assert (current.parent != 0);
+
+        uint32_t level = stack.size;
+        float scale = 1.0 / (1 << level);
+        dir_bounds_t dir_bounds = svo_calculate_dir_bounds_f3(lower,lower+scale, raydir);
+
+        ///Point of exit
+        cube_hit_t t1_result = calculate_t1_f3(raypos, raydir, dir_bounds.upper);
+        t1 = t1_result.position;
+        outface = t1_result.face;
+    } else {
+        svo_stack_push(&stack, &current);
+
+        first_node_t first_node = svo_select_first_node_f3(root_cd_goffset, root_lower, root_scale, raypos, raydir, raydirinv);
+        current = first_node.node;
+        lower = first_node.lower;
+
+        if (is_null_corner(current.corner))
+            return false;
+
+        uint32_t level = stack.size;
+        float scale = 1.0 / (1 << level);
+        dir_bounds_t dir_bounds = svo_calculate_dir_bounds_f3(lower,lower+scale, raydir);
+
+        ///Point of entry
+        cube_hit_t t0_hit = calculate_t0_f3(raypos, raydir, dir_bounds.lower);
+        t1 = t0_hit.position;
+        assert(!is_null_face(t0_hit.face));
+
+        outface = opposite_face(t0_hit.face);
+        entry_t2 = sdistancef3(raypos, t1);
+    }
+
+    while (stack.size > 0)
+    {
+        assert(current.parent);
+
+        uint32_t level = stack.size;
+
+        if (rayisoutside)
+        {
+            ///POP
+            assert(!is_null_corner(current.corner));
+            assert(!is_null_face(outface));
+
+            node_info_t next = svo_stack_back(&stack);
+            svo_stack_pop(&stack);
+
+            {
+                float scale = 1.0 / (1 << level);
+                float3_t corner_increment0 = make_float3(  get_corner_unitx(current.corner)
+                                                        , get_corner_unity(current.corner)
+                                                        , get_corner_unitz(current.corner) );
+                lower -= corner_increment0*scale;
+            }
+
+            corner_t next_corner0 = next.corner;
+            corner_t next_corner1 = move_corner(next_corner0, outface);
+
+            if (is_null_corner(next_corner1))
+            {
+                ///we need to POP again
+                rayisoutside = true;
+                current.parent = next.parent;
+                current.corner = next.corner;
+            } else {
+                rayisoutside = false;
+                current.parent = next.parent;
+                current.corner = next_corner1;
+
+                level = stack.size;
+                float scale = 1.0 / (1 << level);
+
+                float3_t corner_increment0 = make_float3(  get_corner_unitx(next_corner0)
+                                                        , get_corner_unity(next_corner0)
+                                                        , get_corner_unitz(next_corner0) );
+                float3_t corner_increment1 = make_float3(  get_corner_unitx(next_corner1)
+                                                        , get_corner_unity(next_corner1)
+                                                        , get_corner_unitz(next_corner1) );
+                lower += (corner_increment1 - corner_increment0)*scale;
+            }
+            continue;
+        }
+
+        ///everything from here on is farther than the light; nothing left can occlude.
+        if (entry_t2 > max_t2)
+            return false;
+
+        float scale = 1.0 / (1 << level);
+
+        if (svo_tree_voxelexists(address_space,current) && svo_intersects_voxel_data_f3(address_space, current, raypos, raydir))
+        {
+            dir_bounds_t dir_bounds = svo_calculate_dir_bounds_f3(lower, lower+scale, raydir);
+
+            ///any voxel that is smaller than a pixel, or any leaf, is a blocker; no ordering needed.
+            if (!svo_voxelpixelerror(sdistancef3(raypos, dir_bounds.lower), rayScale2, level))
+                return true;
+
+            if (!svo_tree_has_children(address_space,current))
+                return true;
+
+            ///PUSH
+            uint32_t next_level = stack.size + 1;
+            float child_scale = 1.0 / (1 << next_level);
+
+            svo_stack_push(&stack,&current);
+
+            corner_t next_corner = svo_push_calculate_next_corner_f3(cube_normalized_dir, dir_bounds.lower, scale, t1);
+
+            float3_t corner_increment = make_float3( get_corner_unitx(next_corner)
+                                                  , get_corner_unity(next_corner)
+                                                  , get_corner_unitz(next_corner));
+
+            current = svo_tree_get_child(address_space, current, next_corner);
+            lower = lower + (corner_increment * child_scale);
+            continue;
+        }
+
+        ///Point of exit
+        dir_bounds_t dir_bounds = svo_calculate_dir_bounds_f3(lower,lower + scale, raydir);
+        cube_hit_t cube_hit = calculate_t1_f3(raypos, raydir, dir_bounds.upper);
+        t1 = cube_hit.position;
+        outface = cube_hit.face;
+        entry_t2 = sdistancef3(raypos, t1);
+
+        assert(!is_null_face(outface));
+
+        corner_t next_corner = move_corner(current.corner, outface);
+
+        if (!is_null_corner(next_corner))
+        {
+            ///ADVANCE
+            float3_t corner_increment0 = make_float3(  get_corner_unitx(current.corner)
+                                                    , get_corner_unity(current.corner)
+                                                    , get_corner_unitz(current.corner));
+            float3_t corner_increment1 = make_float3(  get_corner_unitx(next_corner)
+                                                    , get_corner_unity(next_corner)
+                                                    , get_corner_unitz(next_corner));
+
+            lower += (corner_increment1 - corner_increment0) * scale;
+            current.corner = next_corner;
+        } else {
+            ///POP, will complete at the top of the loop
+            rayisoutside = true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Occlusion-only batch query; runs svo_tree_raymarch_anyhit() over @c count rays.
+ *
+ * @param max_t2s
+ *          Per-ray squared maximum distances; may be null, in which case every ray is unbounded.
+ * @param out_occluded
+ *          Receives 1 for each ray that is occluded, 0 otherwise.
+ * @return the number of occluded rays.
+ */
+static inline
+size_t svo_tree_occluded_n(const uint8_t* address_space, goffset_t root_cd_goffset
+    , const float3_t* rayposs, const float3_t* raydirs, const float* max_t2s
+    , float rayScale2
+    , size_t count
+    , uint8_t* out_occluded)
+{
+    size_t occluded_count = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        float max_t2 = max_t2s ? max_t2s[i] : (float)(fposinf);
+        bool occluded = svo_tree_raymarch_anyhit(address_space, root_cd_goffset
+                                                , rayposs[i], raydirs[i], rayScale2
+                                                , max_t2);
+        out_occluded[i] = occluded ? 1 : 0;
+        occluded_count += occluded ? 1 : 0;
+    }
+    return occluded_count;
+}
+
+
 #endif
@@ -0,0 +1,92 @@
+#ifndef SVO_TREE_RAYMARCH_STATS_H
+#define SVO_TREE_RAYMARCH_STATS_H 1
+
+#include "svo_inttypes.h"
+#include "opencl.shim.h"
+#include "svo_tree.capi.h"
+
+///Per-ray traversal counters, filled in by svo_tree_raymarch() when it is given a non-null
+/// @c svo_raymarch_stats_t*. Passing null turns the instrumentation off at runtime.
+typedef struct svo_raymarch_stats_t{
+    ///number of iterations of the main traversal loop (POP/PUSH/ADVANCE steps).
+    uint32_t iterations;
+    ///deepest stack size reached by the traversal.
+    uint32_t max_depth;
+    ///number of child descriptors read from the address space.
+    uint32_t cd_fetches;
+    ///number of child pointers that had to be resolved through a far pointer.
+    uint32_t far_ptr_follows;
+    ///number of times the traversal descended into a child (PUSH).
+    uint32_t pushes;
+    ///number of times the traversal climbed back out to a parent (POP).
+    uint32_t pops;
+    ///1 if the ray hit something.
+    uint32_t hit;
+    ///stack size at the voxel that was hit; 0 on a miss.
+    uint32_t hit_depth;
+} svo_raymarch_stats_t;
+
+
+static inline void svo_raymarch_stats_init(svo_raymarch_stats_t* stats)
+{
+    if (!stats)
+        return;
+    stats->iterations = 0;
+    stats->max_depth = 0;
+    stats->cd_fetches = 0;
+    stats->far_ptr_follows = 0;
+    stats->pushes = 0;
+    stats->pops = 0;
+    stats->hit = 0;
+    stats->hit_depth = 0;
+}
+
+static inline void svo_raymarch_stats_iteration(svo_raymarch_stats_t* stats, uint32_t depth)
+{
+    if (!stats)
+        return;
+    stats->iterations++;
+    if (depth > stats->max_depth)
+        stats->max_depth = depth;
+}
+
+static inline void svo_raymarch_stats_cd_fetch(svo_raymarch_stats_t* stats)
+{
+    if (!stats)
+        return;
+    stats->cd_fetches++;
+}
+
+///records fetching the child CD of @c pcd, including the far pointer indirection if @c pcd uses one.
+static inline void svo_raymarch_stats_child_fetch(svo_raymarch_stats_t* stats, const child_descriptor_t* pcd)
+{
+    if (!stats)
+        return;
+    stats->cd_fetches++;
+    if (svo_get_far(pcd))
+        stats->far_ptr_follows++;
+}
+
+static inline void svo_raymarch_stats_push(svo_raymarch_stats_t* stats)
+{
+    if (!stats)
+        return;
+    stats->pushes++;
+}
+
+static inline void svo_raymarch_stats_pop(svo_raymarch_stats_t* stats)
+{
+    if (!stats)
+        return;
+    stats->pops++;
+}
+
+static inline void svo_raymarch_stats_hit(svo_raymarch_stats_t* stats, uint32_t depth)
+{
+    if (!stats)
+        return;
+    stats->hit = 1;
+    stats->hit_depth = depth;
+}
+
+#endif
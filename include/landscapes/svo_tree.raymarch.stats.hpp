@@ -0,0 +1,99 @@
+#ifndef SVO_TREE_RAYMARCH_STATS_HPP
+#define SVO_TREE_RAYMARCH_STATS_HPP 1
+
+#include "svo_tree.raymarch.stats.h"
+#include <iosfwd>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace svo{
+
+///Which counter of @c svo_raymarch_stats_t to aggregate or visualize.
+enum class svo_raymarch_metric_t{
+      iterations
+    , max_depth
+    , cd_fetches
+    , far_ptr_follows
+    , pushes
+    , pops
+};
+
+static const std::size_t svo_raymarch_metric_count = 6;
+
+uint32_t svo_raymarch_stats_get(const svo_raymarch_stats_t& stats, svo_raymarch_metric_t metric);
+
+
+/**
+ * A histogram of one counter over many rays. Values are binned exactly; anything at or above
+ * the last bin is clamped into the last bin.
+ */
+struct svo_raymarch_histogram_t{
+    explicit svo_raymarch_histogram_t(std::size_t bin_count=256);
+
+    void add(uint32_t value);
+    void reset();
+
+    double mean() const;
+    ///smallest value such that at least @c fraction of the samples are <= it; @c fraction in [0,1].
+    uint32_t percentile(double fraction) const;
+
+    std::vector<std::size_t> bins;
+    std::size_t samples;
+    uint64_t sum;
+    uint32_t max;
+};
+
+
+/**
+ * Aggregates the per-ray counters of a frame into one histogram per metric.
+ *
+ * Call add() for each traced ray, inspect/print the result, and reset() at the start of the next frame.
+ */
+struct svo_raymarch_frame_stats_t{
+    explicit svo_raymarch_frame_stats_t(std::size_t bin_count=256);
+
+    void add(const svo_raymarch_stats_t& stats);
+    void reset();
+
+    const svo_raymarch_histogram_t& histogram(svo_raymarch_metric_t metric) const;
+
+    std::size_t rays;
+    std::size_t hits;
+    std::vector<svo_raymarch_histogram_t> histograms;
+};
+
+::std::ostream& operator<<(::std::ostream& out, const svo_raymarch_frame_stats_t& frame_stats);
+
+
+/**
+ * Keeps the per-ray counters of every pixel of a frame, so that a metric can be dumped as an image
+ * to find which parts of the world are pathological for the traversal.
+ */
+struct svo_raymarch_heatmap_t{
+    svo_raymarch_heatmap_t(std::size_t width, std::size_t height);
+
+    svo_raymarch_stats_t& at(std::size_t x, std::size_t y);
+    const svo_raymarch_stats_t& at(std::size_t x, std::size_t y) const;
+
+    void reset();
+
+    ///accumulates every pixel into @c frame_stats.
+    void aggregate(svo_raymarch_frame_stats_t& frame_stats) const;
+
+    /**
+     * Writes @c metric as a binary PPM (P6) image, using a blue (cheap) to red (expensive) ramp.
+     *
+     * @param max_value
+     *          The value mapped to full red; 0 scales to the largest value in the frame.
+     */
+    void write_ppm(std::ostream& out, svo_raymarch_metric_t metric, uint32_t max_value=0) const;
+
+    std::size_t width;
+    std::size_t height;
+    std::vector<svo_raymarch_stats_t> pixels;
+};
+
+} // namespace svo
+
+#endif
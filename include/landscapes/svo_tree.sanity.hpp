@@ -5,6 +5,8 @@
 #include "svo_tree.fwd.hpp"
 #include <iosfwd>
 #include <string>
+#include <vector>
+#include <future>
 
 
 namespace svo{
@@ -96,6 +98,46 @@ svo_slice_sanity_error_t svo_slice_sanity(
 
 svo_block_sanity_error_t svo_block_sanity_check(const svo_block_t* block, int recurse=0);
 
+
+
+
+/**
+ * Result of a validation pass; unlike the inline checks, which stop at the first error, a pass
+ * collects every error it finds.
+ */
+struct svo_sanity_report_t
+{
+    svo_sanity_report_t()
+        : blocks_checked(0), slices_checked(0)
+    {}
+
+    operator bool() const { return !block_errors.empty() || !slice_errors.empty(); }
+
+    std::vector<svo_block_sanity_error_t> block_errors;
+    std::vector<svo_slice_sanity_error_t> slice_errors;
+    std::size_t blocks_checked;
+    std::size_t slices_checked;
+};
+
+::std::ostream& operator<<(::std::ostream& out, const svo::svo_sanity_report_t& report);
+
+///runs svo_block_sanity_check() on every block in the tree rooted at @c root_block.
+svo_sanity_report_t svo_validate_blocks(const svo_block_t* root_block);
+
+///runs svo_slice_sanity() on every slice in the tree rooted at @c root_slice.
+svo_sanity_report_t svo_validate_slices(const svo_slice_t* root_slice
+    , svo_sanity_type_t sanity_type = svo_sanity_type_t::default_sanity);
+
+/**
+ * Opt-in background validation pass; runs svo_validate_blocks() and svo_validate_slices() on
+ * another thread, so that full validation can be enabled (e.g. in staging) without running the
+ * checks inline. Either root can be null.
+ *
+ * The trees must not be modified until the returned future is ready.
+ */
+std::future<svo_sanity_report_t> svo_validate_async(const svo_block_t* root_block, const svo_slice_t* root_slice
+    , svo_sanity_type_t sanity_type = svo_sanity_type_t::default_sanity);
+
 } //namespace svo
 
 
@@ -11,9 +11,17 @@ namespace svo{
 
 struct svo_slice_t;
 struct volume_of_slices_t;
+struct svo_arena_t;
 
 
-svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::size_t max_voxels_per_slice, std::size_t root_level=0);
+/**
+ * Builds a hierarchy of slices from @c volume_of_slices, which is not modified.
+ *
+ * If @c arena is not null, every slice of the hierarchy is allocated from it (see svo_init_slice()), so
+ *  that the whole hierarchy can be freed at once by uninitializing the root and releasing the arena.
+ */
+svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::size_t max_voxels_per_slice, std::size_t root_level=0
+                                , svo_arena_t* arena=0);
 
 
 void svo_downsample_slice(svo_slice_t* parent_slice, const svo_slice_t* child_slice);
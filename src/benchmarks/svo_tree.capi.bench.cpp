@@ -0,0 +1,95 @@
+#include "landscapes/svo_tree.capi.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Microbenchmarks for the child descriptor accessors in svo_tree.capi.h; compares the constant time
+ * popcount/table versions against the bit-by-bit loops they replaced (the @c *_check variants).
+ *
+ * Build with -DNDEBUG, otherwise every accessor also runs its @c *_check loop.
+ */
+
+static const std::size_t cd_count = 1 << 16;
+static const std::size_t rounds = 256;
+
+static std::vector<child_descriptor_t> make_cds()
+{
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<uint32_t> dist(0, 255);
+
+    std::vector<child_descriptor_t> cds(cd_count);
+    for (auto& cd : cds)
+    {
+        svo_init_cd(&cd);
+        child_mask_t valid_mask = dist(gen);
+        ///make sure there is at least one nonleaf child, so every CD has a child index to look up
+        valid_mask |= 1;
+        child_mask_t leaf_mask = dist(gen) & valid_mask & ~1;
+        svo_set_valid_mask(&cd, valid_mask);
+        svo_set_leaf_mask(&cd, leaf_mask);
+    }
+    return cds;
+}
+
+template<typename func_t>
+static void bench(const std::string& name, const std::vector<child_descriptor_t>& cds, func_t func)
+{
+    uint64_t sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (std::size_t round = 0; round < rounds; ++round)
+        for (const auto& cd : cds)
+            sink += func(&cd);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    double ns_per_op = ns / double(rounds * cds.size());
+
+    std::cout << std::left << std::setw(36) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(3) << ns_per_op << " ns/op"
+              << "  (sink: " << sink << ")" << std::endl;
+}
+
+///index of the last nonleaf child; that is the worst case for the loop version.
+static ccurve_t last_nonleaf_ccurve(const child_descriptor_t* cd)
+{
+    child_mask_t nonleaf_mask = svo_get_nonleaf_mask(cd);
+    ccurve_t result = 0;
+    for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
+        if ((nonleaf_mask >> ccurve) & 1)
+            result = ccurve;
+    return result;
+}
+
+int main()
+{
+    auto cds = make_cds();
+
+    std::vector<ccurve_t> ccurves(cds.size());
+    for (std::size_t i = 0; i < cds.size(); ++i)
+        ccurves[i] = last_nonleaf_ccurve(&cds[i]);
+
+    auto ccurve_of = [&cds, &ccurves](const child_descriptor_t* cd) { return ccurves[cd - cds.data()]; };
+
+#ifndef NDEBUG
+    std::cout << "warning: built without NDEBUG; the fast accessors also run their checks" << std::endl;
+#endif
+
+    bench("svo_count_bits_uint8_check", cds, [](const child_descriptor_t* cd) { return svo_count_bits_uint8_check(svo_get_valid_mask(cd)); });
+    bench("svo_count_bits_uint8", cds, [](const child_descriptor_t* cd) { return svo_count_bits_uint8(svo_get_valid_mask(cd)); });
+
+    bench("svo_get_cd_valid_count_check", cds, [](const child_descriptor_t* cd) { return svo_get_cd_valid_count_check(cd); });
+    bench("svo_get_cd_valid_count", cds, [](const child_descriptor_t* cd) { return svo_get_cd_valid_count(cd); });
+
+    bench("svo_get_cd_nonleaf_count_check", cds, [](const child_descriptor_t* cd) { return svo_get_cd_nonleaf_count_check(cd); });
+    bench("svo_get_cd_nonleaf_count", cds, [](const child_descriptor_t* cd) { return svo_get_cd_nonleaf_count(cd); });
+
+    bench("svo_get_cd_child_index_check", cds, [&ccurve_of](const child_descriptor_t* cd) { return svo_get_cd_child_index_check(cd, ccurve_of(cd)); });
+    bench("svo_get_cd_child_index", cds, [&ccurve_of](const child_descriptor_t* cd) { return svo_get_cd_child_index(cd, ccurve_of(cd)); });
+
+    return 0;
+}
@@ -1,3 +1,4 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_MCLOADER
 
 #include "landscapes/mcloader.hpp"
 #include "nbt.h"
@@ -5,6 +6,7 @@
 #include "format.h"
 #include "ThreadPool.h"
 #include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_morton.hpp"
 
 #include <stdio.h>
 #include <iostream>
@@ -523,8 +525,8 @@ void extract_chunk(chunk_id_t chunk_id, const uint8_t* compressed_buffer_ptr, st
         ///setup the data buffers
         dst_buffers.copy_schema(buffer_schema, dst_pos_data.size());
         
-        auto color_element = dst_buffers.get_element_view("color");
-        auto normal_element = dst_buffers.get_element_view("normal");
+        auto color_element = dst_buffers.get_element_view(dst_buffers.get_element_handle<float3_t>("color"));
+        auto normal_element = dst_buffers.get_element_view(dst_buffers.get_element_handle<float3_t>("normal"));
         
         
         std::size_t out_data_index = 0;
@@ -541,8 +543,8 @@ void extract_chunk(chunk_id_t chunk_id, const uint8_t* compressed_buffer_ptr, st
             float3_t color = float3_t(block_info.color[0], block_info.color[1], block_info.color[2]);
             float3_t normal = float3_t(0);
 
-            color_element.template get<float3_t>(out_data_index) = color;
-            normal_element.template get<float3_t>(out_data_index) = normal;
+            color_element[out_data_index] = color;
+            normal_element[out_data_index] = normal;
             ++out_data_index;
         };
         
@@ -733,6 +735,21 @@ inline void iterate_blocks_and_add_data(
     iterate_blocks(side, blocks_data, blocks_data_len, inner_visitor);
 }
 
+///the coordinates of every vcurve of a chunk section, decoded once in a batch.
+static const std::vector<vside_t>& section_coords()
+{
+    static const std::vector<vside_t> coords = [](){
+        std::vector<vcurve_t> vcurves(vcurvesize(base_slice_side));
+        for (vcurve_t vcurve = 0; vcurve < vcurves.size(); ++vcurve)
+            vcurves[vcurve] = vcurve;
+
+        std::vector<vside_t> result(vcurves.size() * 3);
+        svo_morton_decode_n(vcurves.data(), result.data(), vcurves.size());
+        return result;
+    }();
+    return coords;
+}
+
 template<typename visitor_f>
 inline void iterate_blocks(
       vside_t side
@@ -740,10 +757,12 @@ inline void iterate_blocks(
     , visitor_f visitor)
 {
     
+    assert(side == base_slice_side);
+    const auto& coords = section_coords();
+
     for (vcurve_t vcurve = 0; vcurve < vcurvesize(side); ++vcurve)
     {
-        vside_t x, y, z;
-        vcurve2coords(vcurve, side, &x,&y,&z);
+        vside_t x = coords[3*vcurve + 0], y = coords[3*vcurve + 1], z = coords[3*vcurve + 2];
 
         //x = index % 16;
         //y = (index / 16) % 16;
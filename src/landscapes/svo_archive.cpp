@@ -0,0 +1,416 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SERIALIZATION
+
+#include "landscapes/svo_archive.hpp"
+#include "landscapes/svo_serialization.detail.hpp"
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/debug_macro.h"
+#include "format.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+
+namespace svo{
+
+
+static const char ARCHIVE_MAGIC[4] = {'S','V','O','A'};
+static const uint32_t ARCHIVE_VERSION = 2;
+///same as ARCHIVE_VERSION, with u64 parent_vcurve_begin in the index; only written when a slice needs it.
+static const uint32_t ARCHIVE_VERSION_WIDE = 3;
+
+///magic, version, index offset.
+static const std::size_t ARCHIVE_HEADER_SIZE = 4 + 4 + 8;
+
+
+svo_archive_entry_t::svo_archive_entry_t()
+    : offset(0), size(0)
+    , level(0), side(0), parent_vcurve_begin(0)
+    , parent_id(invalid_slice_id)
+{
+
+}
+
+
+static svo_slice_id_t write_archive_slices(std::ostream& out, uint64_t archive_begin
+                                            , const svo_slice_t* slice, svo_slice_id_t parent_id
+                                            , std::vector<svo_archive_entry_t>& entries
+                                            , const svo_serialization_options_t& options)
+{
+    assert(slice);
+    assert(slice->children);
+
+    svo_slice_id_t slice_id = entries.size();
+    entries.push_back(svo_archive_entry_t());
+
+    {
+        auto& entry = entries.back();
+        entry.level = slice->level;
+        entry.side = slice->side;
+        entry.parent_vcurve_begin = slice->parent_vcurve_begin;
+        entry.parent_id = parent_id;
+        entry.offset = uint64_t(out.tellp()) - archive_begin;
+    }
+
+    serialize_slice_v2(out, slice, options);
+
+    ///@c entries may reallocate while recursing, so index it each time.
+    entries[slice_id].size = uint64_t(out.tellp()) - archive_begin - entries[slice_id].offset;
+
+    for (const svo_slice_t* child : *slice->children)
+    {
+        svo_slice_id_t child_id = write_archive_slices(out, archive_begin, child, slice_id, entries, options);
+        entries[slice_id].children.push_back(child_id);
+    }
+
+    return slice_id;
+}
+
+///the archive version needed by @c entries: wide if a slice has more than 2^32 voxels, see svo_vcurve_bytes().
+static uint32_t archive_version(const std::vector<svo_archive_entry_t>& entries)
+{
+    for (const auto& entry : entries)
+        if (svo_vcurve_bytes(vside_t(entry.side)) == 8)
+            return ARCHIVE_VERSION_WIDE;
+    return ARCHIVE_VERSION;
+}
+
+static void write_archive_index(std::ostream& out, const std::vector<svo_archive_entry_t>& entries)
+{
+    bool wide = archive_version(entries) == ARCHIVE_VERSION_WIDE;
+
+    std::ostringstream index;
+    serialize_uint<uint32_t>(index, uint32_t(entries.size()));
+    for (const auto& entry : entries)
+    {
+        serialize_uint<uint64_t>(index, entry.offset);
+        serialize_uint<uint64_t>(index, entry.size);
+        serialize_uint<uint32_t>(index, uint32_t(entry.level));
+        serialize_uint<uint32_t>(index, uint32_t(entry.side));
+        if (wide)
+            serialize_uint<uint64_t>(index, uint64_t(entry.parent_vcurve_begin));
+        else
+            serialize_uint<uint32_t>(index, uint32_t(entry.parent_vcurve_begin));
+        serialize_uint<uint32_t>(index, entry.parent_id);
+        serialize_uint<uint32_t>(index, uint32_t(entry.children.size()));
+        for (svo_slice_id_t child_id : entry.children)
+            serialize_uint<uint32_t>(index, child_id);
+    }
+    svo_write_section(out, index.str());
+}
+
+///points the header at the index; the last write of an update, so the old index stays valid until then.
+static void patch_archive_header(std::ostream& out, uint64_t archive_begin, uint32_t version, uint64_t index_offset)
+{
+    uint64_t archive_end = uint64_t(out.tellp());
+
+    out.seekp(archive_begin + 4);
+    serialize_uint<uint32_t>(out, version);
+    serialize_uint<uint64_t>(out, index_offset);
+    out.seekp(archive_end);
+}
+
+void svo_write_archive(std::ostream& out, const svo_slice_t* root_slice, const svo_serialization_options_t& options)
+{
+    assert(root_slice);
+
+    uint64_t archive_begin = uint64_t(out.tellp());
+
+    out.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    ///patched once the index offset is known.
+    serialize_uint<uint32_t>(out, ARCHIVE_VERSION);
+    serialize_uint<uint64_t>(out, 0);
+
+    std::vector<svo_archive_entry_t> entries;
+    write_archive_slices(out, archive_begin, root_slice, invalid_slice_id, entries, options);
+
+    uint64_t index_offset = uint64_t(out.tellp()) - archive_begin;
+    write_archive_index(out, entries);
+    patch_archive_header(out, archive_begin, archive_version(entries), index_offset);
+
+    if (!out)
+        throw std::runtime_error("Failed writing slice archive");
+}
+
+void svo_archive_update_slices(std::iostream& io, const std::map<svo_slice_id_t, const svo_slice_t*>& slices
+                                , const svo_serialization_options_t& options)
+{
+    uint64_t archive_begin = uint64_t(io.tellg());
+
+    std::vector<svo_archive_entry_t> entries;
+    {
+        svo_archive_t archive(io);
+        entries = archive.entries();
+    }
+
+    io.clear();
+    io.seekp(0, std::ios::end);
+
+    for (const auto& id_slice : slices)
+    {
+        svo_slice_id_t slice_id = id_slice.first;
+        const svo_slice_t* slice = id_slice.second;
+
+        if (slice_id >= entries.size())
+            throw std::runtime_error(fmt::format("Invalid slice id: {}", slice_id));
+
+        auto& entry = entries[slice_id];
+
+        assert(slice);
+        assert(slice->children);
+        if (slice->level != entry.level || std::size_t(slice->side) != std::size_t(entry.side)
+            || slice->children->size() != entry.children.size())
+            throw std::runtime_error(fmt::format("Slice {} does not match the shape of its archive entry", slice_id));
+
+        entry.offset = uint64_t(io.tellp()) - archive_begin;
+        serialize_slice_v2(io, slice, options);
+        entry.size = uint64_t(io.tellp()) - archive_begin - entry.offset;
+    }
+
+    uint64_t index_offset = uint64_t(io.tellp()) - archive_begin;
+    write_archive_index(io, entries);
+
+    ///the new slices and index must be on disk before the header points at them.
+    io.flush();
+    patch_archive_header(io, archive_begin, archive_version(entries), index_offset);
+    io.flush();
+
+    if (!io)
+        throw std::runtime_error("Failed updating slice archive");
+}
+
+
+
+
+void svo_rewrite_archive(std::istream& in, std::ostream& out, bool verify_checksums)
+{
+    svo_archive_t archive(in, verify_checksums);
+    std::vector<svo_archive_entry_t> entries = archive.entries();
+
+    uint64_t archive_begin = uint64_t(out.tellp());
+
+    out.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    ///patched once the index offset is known.
+    serialize_uint<uint32_t>(out, ARCHIVE_VERSION);
+    serialize_uint<uint64_t>(out, 0);
+
+    ///in id order, so the slices stay in pre-order.
+    std::string data;
+    for (svo_slice_id_t slice_id = 0; slice_id < entries.size(); ++slice_id)
+    {
+        archive.read_slice_data(slice_id, data);
+
+        entries[slice_id].offset = uint64_t(out.tellp()) - archive_begin;
+        out.write(data.data(), data.size());
+    }
+
+    uint64_t index_offset = uint64_t(out.tellp()) - archive_begin;
+    write_archive_index(out, entries);
+    patch_archive_header(out, archive_begin, archive_version(entries), index_offset);
+
+    if (!out)
+        throw std::runtime_error("Failed rewriting slice archive");
+}
+
+
+svo_archive_t::svo_archive_t(std::istream& in, bool verify_checksums)
+    : m_in(in), m_begin(uint64_t(in.tellg())), m_verify_checksums(verify_checksums)
+{
+    char magic[sizeof(ARCHIVE_MAGIC)];
+    m_in.read(magic, sizeof(magic));
+    if (std::size_t(m_in.gcount()) != sizeof(magic) || std::memcmp(magic, ARCHIVE_MAGIC, sizeof(magic)) != 0)
+        throw std::runtime_error("Not a slice archive");
+
+    auto version = unserialize_uint<uint32_t>(m_in);
+    if (version != ARCHIVE_VERSION && version != ARCHIVE_VERSION_WIDE)
+        throw std::runtime_error(fmt::format("Unsupported slice archive version: {}, expected {} or {}"
+                                            , version, ARCHIVE_VERSION, ARCHIVE_VERSION_WIDE));
+    bool wide = version == ARCHIVE_VERSION_WIDE;
+
+    auto index_offset = unserialize_uint<uint64_t>(m_in);
+    if (index_offset < ARCHIVE_HEADER_SIZE)
+        throw std::runtime_error(fmt::format("Invalid slice archive index offset: {}", index_offset));
+
+    m_in.seekg(m_begin + index_offset);
+
+    std::string index_data;
+    svo_read_section(m_in, index_data, verify_checksums, "archive index");
+
+    svo_memory_streambuf_t index_buf(index_data.data(), index_data.size());
+    std::istream index(&index_buf);
+
+    ///offset, size, level, side, parent_vcurve_begin, parent id and children count.
+    static const std::size_t ENTRY_MIN_SIZE = 8 + 8 + 4*5;
+
+    std::size_t slice_count = unserialize_uint<uint32_t>(index);
+    if (slice_count > index_buf.remaining() / ENTRY_MIN_SIZE)
+        throw std::runtime_error(fmt::format("Invalid slice count in slice archive: {}", slice_count));
+
+    m_entries.resize(slice_count);
+    for (auto& entry : m_entries)
+    {
+        entry.offset = unserialize_uint<uint64_t>(index);
+        entry.size = unserialize_uint<uint64_t>(index);
+        entry.level = unserialize_uint<uint32_t>(index);
+        entry.side = unserialize_uint<uint32_t>(index);
+        if (wide)
+        {
+            uint64_t parent_vcurve_begin = unserialize_uint<uint64_t>(index);
+            if (parent_vcurve_begin > uint64_t(vcurve_t(-1)))
+                throw std::runtime_error("Slice archive needs 64 bit vcurves; rebuild with SVO_VCURVE_64");
+            entry.parent_vcurve_begin = vcurve_t(parent_vcurve_begin);
+        }
+        else
+            entry.parent_vcurve_begin = unserialize_uint<uint32_t>(index);
+        entry.parent_id = unserialize_uint<uint32_t>(index);
+
+        std::size_t children_count = unserialize_uint<uint32_t>(index);
+        if (children_count > slice_count)
+            throw std::runtime_error(fmt::format("Invalid children count in slice archive: {}", children_count));
+
+        entry.children.resize(children_count);
+        for (auto& child_id : entry.children)
+        {
+            child_id = unserialize_uint<uint32_t>(index);
+            if (child_id >= slice_count)
+                throw std::runtime_error(fmt::format("Invalid child id in slice archive: {}", child_id));
+        }
+
+        if (entry.offset < ARCHIVE_HEADER_SIZE || entry.offset + entry.size > index_offset)
+            throw std::runtime_error(fmt::format("Invalid slice extent in slice archive: {}+{}", entry.offset, entry.size));
+    }
+
+    if (index_buf.remaining() != 0)
+        throw std::runtime_error("Trailing bytes in slice archive index");
+
+    ///the slices are numbered in pre-order (see write_archive_slices()): every link points from a
+    /// lower id to a higher one and back, so walking the tree always terminates.
+    for (svo_slice_id_t slice_id = 0; slice_id < m_entries.size(); ++slice_id)
+    {
+        const auto& entry = m_entries[slice_id];
+
+        if ((slice_id == 0) != (entry.parent_id == invalid_slice_id)
+            || (slice_id > 0 && entry.parent_id >= slice_id))
+            throw std::runtime_error(fmt::format("Invalid parent of slice {} in slice archive", slice_id));
+
+        if (entry.side == 0 || (entry.side & (entry.side - 1)) != 0 || entry.side > SVO_VSIDE_LIMIT)
+            throw std::runtime_error(fmt::format("Invalid side of slice {} in slice archive: {}", slice_id, entry.side));
+
+        ///a child is one level below its parent, and covers whole voxels within the parent's cube.
+        if (slice_id > 0)
+        {
+            const auto& parent_entry = m_entries[entry.parent_id];
+
+            if (entry.level != parent_entry.level + 1)
+                throw std::runtime_error(fmt::format("Invalid level of slice {} in slice archive: {}, its parent is at level {}"
+                                                    , slice_id, entry.level, parent_entry.level));
+            if (entry.side < 2 || entry.side > uint64_t(parent_entry.side) * 2)
+                throw std::runtime_error(fmt::format("Invalid side of slice {} in slice archive: {}, its parent's side is {}"
+                                                    , slice_id, entry.side, parent_entry.side));
+
+            vcurvesize_t parent_size = vcurvesize(parent_entry.side);
+            vcurvesize_t size_in_parent = vcurvesize(entry.side) / 8;
+            if (entry.parent_vcurve_begin >= parent_size || entry.parent_vcurve_begin % size_in_parent != 0
+                || parent_size - entry.parent_vcurve_begin < size_in_parent)
+                throw std::runtime_error(fmt::format("Invalid position of slice {} in slice archive: {}, its parent's side is {}"
+                                                    , slice_id, entry.parent_vcurve_begin, parent_entry.side));
+        }
+
+        for (svo_slice_id_t child_id : entry.children)
+        {
+            if (child_id <= slice_id || m_entries[child_id].parent_id != slice_id)
+                throw std::runtime_error(fmt::format("Invalid child {} of slice {} in slice archive", child_id, slice_id));
+        }
+    }
+}
+
+bool svo_archive_t::verify_checksums() const
+{
+    return m_verify_checksums;
+}
+
+std::size_t svo_archive_t::size() const
+{
+    return m_entries.size();
+}
+
+const svo_archive_entry_t& svo_archive_t::entry(svo_slice_id_t slice_id) const
+{
+    if (slice_id >= m_entries.size())
+        throw std::runtime_error(fmt::format("Invalid slice id: {}", slice_id));
+    return m_entries[slice_id];
+}
+
+const std::vector<svo_archive_entry_t>& svo_archive_t::entries() const
+{
+    return m_entries;
+}
+
+void svo_archive_t::load_slice(svo_slice_id_t slice_id, svo_slice_t* slice, bool load_empty_children
+                                , const svo_slice_load_filter_t& filter)
+{
+    const auto& entry = this->entry(slice_id);
+
+    assert(slice);
+    assert(slice->level == entry.level);
+
+    m_in.clear();
+    m_in.seekg(m_begin + entry.offset);
+
+    unserialize_slice_v2(m_in, slice, load_empty_children, filter, m_verify_checksums);
+
+    if (std::size_t(slice->side) != std::size_t(entry.side))
+        throw std::runtime_error(fmt::format("Slice {} does not match its archive entry", slice_id));
+}
+
+void svo_archive_t::read_slice_data(svo_slice_id_t slice_id, std::string& data)
+{
+    const auto& entry = this->entry(slice_id);
+
+    data.resize(entry.size);
+
+    m_in.clear();
+    m_in.seekg(m_begin + entry.offset);
+    m_in.read(&data[0], data.size());
+
+    if (std::size_t(m_in.gcount()) != data.size())
+        throw std::runtime_error(fmt::format("Archive is truncated, slice {} is missing data", slice_id));
+}
+
+svo_slice_t* svo_archive_t::load_subtree(svo_slice_id_t slice_id, std::size_t max_depth
+                                        , const svo_slice_load_filter_t& filter)
+{
+    const auto& entry = this->entry(slice_id);
+
+    svo_slice_t* slice = svo_init_slice(entry.level, entry.side);
+    try {
+        load_slice(slice_id, slice, false, filter);
+
+        if (max_depth > 0)
+        {
+            for (svo_slice_id_t child_id : entry.children)
+            {
+                svo_slice_t* child = load_subtree(child_id, max_depth - 1, filter);
+                svo_slice_attach_child(slice, child, m_entries[child_id].parent_vcurve_begin);
+            }
+        }
+    } catch (...) {
+        svo_uninit_slice(slice, true);
+        throw;
+    }
+
+    return slice;
+}
+
+svo_slice_id_t svo_archive_t::find_child(svo_slice_id_t slice_id, vcurve_t parent_vcurve_begin) const
+{
+    for (svo_slice_id_t child_id : entry(slice_id).children)
+    {
+        if (m_entries[child_id].parent_vcurve_begin == parent_vcurve_begin)
+            return child_id;
+    }
+    return invalid_slice_id;
+}
+
+
+} //namespace svo
@@ -0,0 +1,86 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SLICE_MGMT
+
+#include "landscapes/svo_arena.hpp"
+#include "landscapes/debug_macro.h"
+#include "format.h"
+
+#include <stdexcept>
+#include <cassert>
+
+namespace svo{
+
+
+const std::size_t svo_arena_t::DEFAULT_CHUNK_BYTES;
+
+svo_arena_t::svo_arena_t(std::size_t chunk_bytes)
+    : m_chunk_bytes(chunk_bytes)
+    , m_next(nullptr)
+    , m_end(nullptr)
+    , m_bytes_allocated(0)
+{
+    if (chunk_bytes == 0)
+        throw std::runtime_error("Arena chunks cannot be empty");
+}
+
+svo_arena_t::~svo_arena_t()
+{
+    release();
+}
+
+void* svo_arena_t::allocate(std::size_t bytes, std::size_t alignment)
+{
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    if (bytes == 0)
+        bytes = 1;
+
+    ///a large allocation gets a chunk of its own; the current chunk stays current.
+    if (bytes > m_chunk_bytes / 4)
+    {
+        std::unique_ptr<uint8_t[]> chunk(new uint8_t[bytes + alignment - 1]);
+        uintptr_t address = reinterpret_cast<uintptr_t>(chunk.get());
+        uintptr_t aligned = (address + alignment - 1) & ~uintptr_t(alignment - 1);
+
+        m_chunks.push_back(std::move(chunk));
+        m_bytes_allocated += bytes;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    uintptr_t next = reinterpret_cast<uintptr_t>(m_next);
+    uintptr_t aligned = (next + alignment - 1) & ~uintptr_t(alignment - 1);
+    if (!m_next || aligned + bytes > reinterpret_cast<uintptr_t>(m_end))
+    {
+        m_chunks.emplace_back(new uint8_t[m_chunk_bytes + alignment - 1]);
+        m_next = m_chunks.back().get();
+        m_end = m_next + m_chunk_bytes + alignment - 1;
+
+        next = reinterpret_cast<uintptr_t>(m_next);
+        aligned = (next + alignment - 1) & ~uintptr_t(alignment - 1);
+    }
+
+    assert(aligned + bytes <= reinterpret_cast<uintptr_t>(m_end));
+    m_next = reinterpret_cast<uint8_t*>(aligned + bytes);
+    m_bytes_allocated += bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void svo_arena_t::release()
+{
+    m_chunks.clear();
+    m_next = nullptr;
+    m_end = nullptr;
+    m_bytes_allocated = 0;
+}
+
+std::size_t svo_arena_t::chunks() const
+{
+    return m_chunks.size();
+}
+
+std::size_t svo_arena_t::bytes_allocated() const
+{
+    return m_bytes_allocated;
+}
+
+
+} //namespace svo
@@ -0,0 +1,505 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_BLOCK_MGMT
+
+#include "landscapes/svo_block_image.hpp"
+#include "landscapes/svo_serialization.v1.hpp"
+#include "landscapes/svo_serialization.v2.hpp"
+#include "landscapes/svo_serialization.detail.hpp"
+#include "landscapes/svo_crc32c.hpp"
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_buffer.hpp"
+#include "landscapes/debug_macro.h"
+#include "format.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <tuple>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SVO_HAVE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace svo{
+
+
+static const char IMAGE_MAGIC[4] = {'S','V','O','I'};
+static const uint32_t IMAGE_VERSION = 2;
+///written in host order; reads back as this value only on a host with the same byte order.
+static const uint32_t IMAGE_BYTE_ORDER_MARK = 0x01020304;
+
+///magic, version, byte order mark, page size, address space size, data offset, block count.
+static const std::size_t IMAGE_HEADER_SIZE = 4 + 4 + 4 + 4 + 8 + 8 + 4;
+///length and checksum in front of the block table.
+static const std::size_t IMAGE_TABLE_HEADER_SIZE = 4 + 4;
+
+static const uint32_t invalid_block_index = uint32_t(-1);
+
+
+struct svo_block_image_entry_t{
+    uint32_t parent_index;
+
+    goffset_t block_start, block_end;
+    goffset_t cd_start, cd_end, cdspace_end;
+    goffset_t data_start, data_end, dataspace_end;
+    goffset_t info_goffset;
+    goffset_t root_shadow_cd_goffset, parent_root_cd_goffset;
+
+    uint32_t root_level, height, side, root_ccurve;
+    uint8_t trunk, root_valid_bit, root_leaf_bit;
+    uint64_t leaf_count, cd_count;
+
+    ///of the block's pages, relative to the image's data offset.
+    uint64_t file_offset;
+    ///CRC-32C of the block's pages.
+    uint32_t pages_crc;
+
+    svo_schema_t schema;
+    std::vector<uint32_t> buffer_entries;
+};
+
+struct svo_block_image_header_t{
+    uint64_t size;
+    uint64_t data_offset;
+    std::vector<svo_block_image_entry_t> entries;
+};
+
+
+static void collect_blocks(const svo_block_t* block, uint32_t parent_index, std::vector< std::tuple<const svo_block_t*, uint32_t> >& blocks)
+{
+    assert(block);
+    assert(block->child_blocks);
+
+    uint32_t block_index = blocks.size();
+    blocks.push_back(std::make_tuple(block, parent_index));
+
+    for (const svo_block_t* child_block : *block->child_blocks)
+        collect_blocks(child_block, block_index, blocks);
+}
+
+static void write_padding(std::ostream& out, std::size_t bytes)
+{
+    static const char zeros[256] = {0};
+    while (bytes > 0)
+    {
+        std::size_t chunk = std::min(bytes, sizeof(zeros));
+        out.write(zeros, chunk);
+        bytes -= chunk;
+    }
+}
+
+void svo_write_block_image(std::ostream& out, const svo_tree_t* tree)
+{
+    assert(tree);
+    assert(tree->root_block);
+    assert(tree->address_space);
+
+    std::vector< std::tuple<const svo_block_t*, uint32_t> > blocks;
+    collect_blocks(tree->root_block, invalid_block_index, blocks);
+
+    ///the block table; the pages of each block follow each other in table order.
+    std::ostringstream table;
+    uint64_t file_offset = 0;
+    for (const auto& block_parent : blocks)
+    {
+        const svo_block_t* block; uint32_t parent_index;
+        std::tie(block, parent_index) = block_parent;
+
+        serialize_uint<uint32_t>(table, parent_index);
+
+        for (goffset_t goffset : {block->block_start, block->block_end
+                                , block->cd_start, block->cd_end, block->cdspace_end
+                                , block->data_start, block->data_end, block->dataspace_end
+                                , block->info_goffset
+                                , block->root_shadow_cd_goffset, block->parent_root_cd_goffset})
+            serialize_uint<uint32_t>(table, goffset);
+
+        serialize_uint<uint32_t>(table, uint32_t(block->root_level));
+        serialize_uint<uint32_t>(table, uint32_t(block->height));
+        serialize_uint<uint32_t>(table, uint32_t(block->side));
+        serialize_uint<uint32_t>(table, uint32_t(block->root_ccurve));
+        serialize_uint<uint8_t>(table, block->trunk ? 1 : 0);
+        serialize_uint<uint8_t>(table, block->root_valid_bit ? 1 : 0);
+        serialize_uint<uint8_t>(table, block->root_leaf_bit ? 1 : 0);
+        serialize_uint<uint64_t>(table, block->leaf_count);
+        serialize_uint<uint64_t>(table, block->cd_count);
+        serialize_uint<uint64_t>(table, file_offset);
+        serialize_uint<uint32_t>(table, svo_crc32c(tree->address_space + block->block_start, block->size()));
+
+        assert(block->buffers);
+        serialize_schema(table, block->buffers->schema());
+        for (const auto& buffer : block->buffers->buffers())
+            serialize_uint<uint32_t>(table, uint32_t(buffer.entries()));
+
+        assert(block->size() % SVO_PAGE_SIZE == 0);
+        file_offset += block->size();
+    }
+
+    std::string table_data = table.str();
+    uint64_t table_end = IMAGE_HEADER_SIZE + IMAGE_TABLE_HEADER_SIZE + table_data.size();
+    uint64_t data_offset = iceil<uint64_t>(table_end, SVO_PAGE_SIZE);
+
+    out.write(IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    serialize_uint<uint32_t>(out, IMAGE_VERSION);
+    out.write(reinterpret_cast<const char*>(&IMAGE_BYTE_ORDER_MARK), sizeof(IMAGE_BYTE_ORDER_MARK));
+    serialize_uint<uint32_t>(out, SVO_PAGE_SIZE);
+    serialize_uint<uint64_t>(out, tree->size);
+    serialize_uint<uint64_t>(out, data_offset);
+    serialize_uint<uint32_t>(out, uint32_t(blocks.size()));
+    svo_write_section(out, table_data);
+    write_padding(out, data_offset - table_end);
+
+    for (const auto& block_parent : blocks)
+    {
+        const svo_block_t* block = std::get<0>(block_parent);
+        out.write(reinterpret_cast<const char*>(tree->address_space + block->block_start), block->size());
+    }
+
+    if (!out)
+        throw std::runtime_error("Failed writing block image");
+}
+
+
+
+
+static svo_block_image_header_t read_block_image_header(std::istream& in, svo_block_image_validation_t validation)
+{
+    char magic[sizeof(IMAGE_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (std::size_t(in.gcount()) != sizeof(magic) || std::memcmp(magic, IMAGE_MAGIC, sizeof(magic)) != 0)
+        throw std::runtime_error("Not a block image");
+
+    auto version = unserialize_uint<uint32_t>(in);
+    if (version != IMAGE_VERSION)
+        throw std::runtime_error(fmt::format("Unsupported block image version: {}, expected {}", version, IMAGE_VERSION));
+
+    uint32_t byte_order_mark = 0;
+    in.read(reinterpret_cast<char*>(&byte_order_mark), sizeof(byte_order_mark));
+    if (byte_order_mark != IMAGE_BYTE_ORDER_MARK)
+        throw std::runtime_error("Block image was written on a host with a different byte order");
+
+    auto page_size = unserialize_uint<uint32_t>(in);
+    if (page_size != SVO_PAGE_SIZE)
+        throw std::runtime_error(fmt::format("Block image page size {} does not match SVO_PAGE_SIZE {}", page_size, SVO_PAGE_SIZE));
+
+    svo_block_image_header_t header;
+    header.size = unserialize_uint<uint64_t>(in);
+    header.data_offset = unserialize_uint<uint64_t>(in);
+    std::size_t block_count = unserialize_uint<uint32_t>(in);
+
+    if (header.size % SVO_PAGE_SIZE != 0 || header.data_offset % SVO_PAGE_SIZE != 0)
+        throw std::runtime_error("Block image is not page aligned");
+    if (block_count == 0)
+        throw std::runtime_error("Block image has no blocks");
+
+    std::string table_data;
+    svo_read_section(in, table_data, validation != svo_block_image_validation_t::structure, "block table");
+
+    svo_memory_streambuf_t table_buf(table_data.data(), table_data.size());
+    std::istream table(&table_buf);
+
+    ///parent, goffsets, levels and bits, counts, file offset, pages checksum.
+    static const std::size_t ENTRY_MIN_SIZE = 4 + 11*4 + 4*4 + 3 + 8*3 + 4;
+    if (block_count > table_data.size() / ENTRY_MIN_SIZE)
+        throw std::runtime_error(fmt::format("Invalid block count in block image: {}", block_count));
+
+    header.entries.resize(block_count);
+    for (std::size_t block_index = 0; block_index < block_count; ++block_index)
+    {
+        auto& entry = header.entries[block_index];
+
+        entry.parent_index = unserialize_uint<uint32_t>(table);
+        if ((block_index == 0) != (entry.parent_index == invalid_block_index)
+            || (block_index > 0 && entry.parent_index >= block_index))
+            throw std::runtime_error(fmt::format("Invalid parent of block {} in block image", block_index));
+
+        for (goffset_t* goffset : {&entry.block_start, &entry.block_end
+                                , &entry.cd_start, &entry.cd_end, &entry.cdspace_end
+                                , &entry.data_start, &entry.data_end, &entry.dataspace_end
+                                , &entry.info_goffset
+                                , &entry.root_shadow_cd_goffset, &entry.parent_root_cd_goffset})
+            *goffset = unserialize_uint<uint32_t>(table);
+
+        entry.root_level = unserialize_uint<uint32_t>(table);
+        entry.height = unserialize_uint<uint32_t>(table);
+        entry.side = unserialize_uint<uint32_t>(table);
+        entry.root_ccurve = unserialize_uint<uint32_t>(table);
+        entry.trunk = unserialize_uint<uint8_t>(table);
+        entry.root_valid_bit = unserialize_uint<uint8_t>(table);
+        entry.root_leaf_bit = unserialize_uint<uint8_t>(table);
+        entry.leaf_count = unserialize_uint<uint64_t>(table);
+        entry.cd_count = unserialize_uint<uint64_t>(table);
+        entry.file_offset = unserialize_uint<uint64_t>(table);
+        entry.pages_crc = unserialize_uint<uint32_t>(table);
+
+        entry.schema = unserialize_schema(table);
+        for (std::size_t buffer_index = 0; buffer_index < entry.schema.size(); ++buffer_index)
+            entry.buffer_entries.push_back(unserialize_uint<uint32_t>(table));
+
+        if (entry.block_start >= entry.block_end || entry.block_end > header.size
+            || entry.block_start % SVO_PAGE_SIZE != 0 || entry.block_end % SVO_PAGE_SIZE != 0
+            || entry.file_offset % SVO_PAGE_SIZE != 0)
+            throw std::runtime_error(fmt::format("Invalid bounds of block {} in block image", block_index));
+
+        ///the sections must nest in the order svo_tree_t::make_block() lays them out, or restoring the
+        /// buffers will write the info section and data outside of the block.
+        if (!(entry.block_start <= entry.cd_start && entry.cd_start <= entry.cd_end
+                && entry.cd_end <= entry.cdspace_end && entry.cdspace_end <= entry.info_goffset)
+            || entry.info_goffset > entry.block_end - sizeof(svo_info_section_t)
+            || !(entry.info_goffset + sizeof(svo_info_section_t) <= entry.data_start
+                && entry.data_start <= entry.data_end && entry.data_end <= entry.dataspace_end
+                && entry.dataspace_end <= entry.block_end))
+            throw std::runtime_error(fmt::format("Invalid section layout of block {} in block image", block_index));
+
+        if (!(entry.cd_start <= entry.root_shadow_cd_goffset
+                && entry.root_shadow_cd_goffset + sizeof(child_descriptor_t) <= entry.cd_end))
+            throw std::runtime_error(fmt::format("Invalid root shadow CD of block {} in block image", block_index));
+
+        ///a block that is not linked into its parent's CDs yet has no parent root CD.
+        if (entry.parent_root_cd_goffset != invalid_goffset)
+        {
+            if (block_index == 0)
+                throw std::runtime_error("Invalid parent root CD of the root block in block image");
+
+            const auto& parent_entry = header.entries[entry.parent_index];
+            if (!(parent_entry.cd_start <= entry.parent_root_cd_goffset
+                    && entry.parent_root_cd_goffset + sizeof(child_descriptor_t) <= parent_entry.cd_end))
+                throw std::runtime_error(fmt::format("Invalid parent root CD of block {} in block image", block_index));
+        }
+    }
+
+    if (table_buf.remaining() != 0)
+        throw std::runtime_error("Trailing bytes in block image table");
+
+    return header;
+}
+
+static void verify_block_pages(const byte_t* address_space, const svo_block_image_header_t& header)
+{
+    for (std::size_t block_index = 0; block_index < header.entries.size(); ++block_index)
+    {
+        const auto& entry = header.entries[block_index];
+
+        uint32_t crc = svo_crc32c(address_space + entry.block_start, entry.block_end - entry.block_start);
+        if (crc != entry.pages_crc)
+            throw std::runtime_error(fmt::format("Checksum mismatch in the pages of block {} in block image", block_index));
+    }
+}
+
+///rebuilds the blocks of @c tree from the block table, without looking at the pages.
+static void restore_blocks(svo_tree_t* tree, const svo_block_image_header_t& header)
+{
+    std::vector<svo_block_t*> blocks;
+
+    for (const auto& entry : header.entries)
+    {
+        svo_block_t* block = tree->adopt_block(entry.block_start, entry.block_end);
+        blocks.push_back(block);
+
+        block->cd_start = entry.cd_start;
+        block->cd_end = entry.cd_end;
+        block->cdspace_end = entry.cdspace_end;
+        block->data_start = entry.data_start;
+        block->data_end = entry.data_end;
+        block->dataspace_end = entry.dataspace_end;
+        block->info_goffset = entry.info_goffset;
+        block->root_shadow_cd_goffset = entry.root_shadow_cd_goffset;
+        block->parent_root_cd_goffset = entry.parent_root_cd_goffset;
+
+        block->root_level = entry.root_level;
+        block->height = entry.height;
+        block->side = entry.side;
+        block->root_ccurve = entry.root_ccurve;
+        block->trunk = entry.trunk != 0;
+        block->root_valid_bit = entry.root_valid_bit != 0;
+        block->root_leaf_bit = entry.root_leaf_bit != 0;
+        block->leaf_count = entry.leaf_count;
+        block->cd_count = entry.cd_count;
+
+        ///the buffers are laid out back to back from data_start, so adding them again in order
+        /// places them exactly where they were.
+        if (entry.schema.size() > 0)
+        {
+            block->data_end = block->data_start;
+            for (std::size_t buffer_index = 0; buffer_index < entry.schema.size(); ++buffer_index)
+                block->buffers->add_buffer(entry.schema[buffer_index], entry.buffer_entries[buffer_index]);
+
+            if (block->data_end != entry.data_end)
+                throw std::runtime_error("Block image buffers do not match the block's data section");
+        }
+
+        if (entry.parent_index != invalid_block_index)
+        {
+            svo_block_t* parent_block = blocks[entry.parent_index];
+            block->parent_block = parent_block;
+            parent_block->child_blocks->push_back(block);
+        }
+
+        tree->update_block_lookup_info(block);
+    }
+
+    tree->root_block = blocks[0];
+}
+
+
+
+
+svo_block_image_t::svo_block_image_t()
+    : m_memory(nullptr), m_memory_size(0), m_mapped(false)
+{
+
+}
+
+svo_block_image_t::~svo_block_image_t()
+{
+    if (m_tree)
+    {
+        for (const auto& block_info : m_tree->blocks)
+            delete block_info.first;
+        m_tree.reset();
+    }
+
+    if (!m_memory)
+        return;
+
+#ifdef SVO_HAVE_MMAP
+    if (m_mapped)
+    {
+        munmap(m_memory, m_memory_size);
+        return;
+    }
+#endif
+    std::free(m_memory);
+}
+
+svo_tree_t* svo_block_image_t::tree() const
+{
+    return m_tree.get();
+}
+
+bool svo_block_image_t::mapped() const
+{
+    return m_mapped;
+}
+
+static inline byte_t* page_align(void* memory)
+{
+    return reinterpret_cast<byte_t*>(iceil<uintptr_t>(uintptr_t(memory), SVO_PAGE_SIZE));
+}
+
+std::unique_ptr<svo_block_image_t> svo_load_block_image(std::istream& in, svo_block_image_validation_t validation)
+{
+    uint64_t image_begin = uint64_t(in.tellg());
+
+    auto header = read_block_image_header(in, validation);
+
+    std::unique_ptr<svo_block_image_t> image(new svo_block_image_t());
+    image->m_memory_size = header.size + SVO_PAGE_SIZE - 1;
+    image->m_memory = std::calloc(image->m_memory_size, 1);
+    if (!image->m_memory)
+        throw std::bad_alloc();
+
+    byte_t* address_space = page_align(image->m_memory);
+    image->m_tree.reset(new svo_tree_t(address_space, header.size));
+    restore_blocks(image->m_tree.get(), header);
+
+    for (const auto& entry : header.entries)
+    {
+        std::size_t bytes = entry.block_end - entry.block_start;
+        in.seekg(image_begin + header.data_offset + entry.file_offset);
+        in.read(reinterpret_cast<char*>(address_space + entry.block_start), bytes);
+        if (std::size_t(in.gcount()) != bytes)
+            throw std::runtime_error("Truncated block image");
+    }
+
+    if (validation == svo_block_image_validation_t::full)
+        verify_block_pages(address_space, header);
+
+    return image;
+}
+
+std::unique_ptr<svo_block_image_t> svo_map_block_image(const std::string& path, svo_block_image_validation_t validation)
+{
+#ifdef SVO_HAVE_MMAP
+    long os_page_size = sysconf(_SC_PAGESIZE);
+    if (os_page_size > 0 && SVO_PAGE_SIZE % os_page_size == 0)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error(fmt::format("Cannot open block image: {}", path));
+        auto header = read_block_image_header(in, validation);
+        in.close();
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error(fmt::format("Cannot open block image: {}", path));
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0)
+        {
+            close(fd);
+            throw std::runtime_error(fmt::format("Cannot stat block image: {}", path));
+        }
+
+        std::unique_ptr<svo_block_image_t> image(new svo_block_image_t());
+
+        ///reserve the whole address space, so that the unused pages stay writable and zeroed.
+        image->m_memory_size = header.size + SVO_PAGE_SIZE;
+        void* memory = mmap(nullptr, image->m_memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            close(fd);
+            throw std::bad_alloc();
+        }
+        image->m_memory = memory;
+        image->m_mapped = true;
+
+        byte_t* address_space = page_align(memory);
+
+        ///then map each block's pages over the reservation, copy-on-write.
+        for (const auto& entry : header.entries)
+        {
+            std::size_t bytes = entry.block_end - entry.block_start;
+            uint64_t file_offset = header.data_offset + entry.file_offset;
+            if (file_offset + bytes > uint64_t(file_stat.st_size))
+            {
+                close(fd);
+                throw std::runtime_error("Truncated block image");
+            }
+
+            void* block_memory = mmap(address_space + entry.block_start, bytes
+                                        , PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED
+                                        , fd, off_t(file_offset));
+            if (block_memory == MAP_FAILED)
+            {
+                close(fd);
+                throw std::runtime_error(fmt::format("Cannot map block image: {}", path));
+            }
+        }
+        close(fd);
+
+        if (validation == svo_block_image_validation_t::full)
+            verify_block_pages(address_space, header);
+
+        image->m_tree.reset(new svo_tree_t(address_space, header.size));
+        restore_blocks(image->m_tree.get(), header);
+        return image;
+    }
+#endif
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error(fmt::format("Cannot open block image: {}", path));
+    return svo_load_block_image(in, validation);
+}
+
+
+} //namespace svo
@@ -4,6 +4,8 @@
 #include "landscapes/svo_tree.hpp"
 
 #include <exception>
+#include <algorithm>
+#include <cstring>
 #include "format.h"
 #include "landscapes/unused.h"
 
@@ -15,7 +17,11 @@ svo_base_buffer_t(const svo_declaration_t& declaration, std::size_t initial_entr
     : m_declaration(declaration)
     , m_entries(initial_entries)
     , m_rawdata(rawdata)
-{}
+{
+    if (declaration.layout() == svo_layout_t::PLANAR)
+        throw std::runtime_error(fmt::format("A buffer cannot hold a planar declaration; add its planes as separate buffers"
+                                             ", declaration: {}", declaration));
+}
 
 namespace detail{
     template<typename dst_buffer_t, typename src_buffer_t>
@@ -37,6 +43,40 @@ namespace detail{
     }
 }
 
+template<typename svo_buffer_t>
+void
+svo_base_buffer_t<svo_buffer_t>::
+copy_from_buffer(const svo_cpu_buffer_t& src_buffer, std::size_t src_start, std::size_t copy_entries, std::size_t dst_start)
+{
+    svo::detail::copy_from_buffer(self(), src_buffer, src_start, copy_entries, dst_start);
+}
+
+template<typename svo_buffer_t>
+void
+svo_base_buffer_t<svo_buffer_t>::
+copy_from_buffer(const svo_gpu_buffer_t& src_buffer, std::size_t src_start, std::size_t copy_entries, std::size_t dst_start)
+{
+    svo::detail::copy_from_buffer(self(), src_buffer, src_start, copy_entries, dst_start);
+}
+
+template<typename svo_buffer_t>
+void
+svo_base_buffer_t<svo_buffer_t>::
+copy_from_buffer(const svo_cpu_buffer_t& src_buffer, std::size_t src_element_index, std::size_t dst_element_index
+                , std::size_t src_start, std::size_t copy_entries, std::size_t dst_start)
+{
+    svo::detail::copy_element_from_buffer(self(), src_buffer, src_element_index, dst_element_index, src_start, copy_entries, dst_start);
+}
+
+template<typename svo_buffer_t>
+void
+svo_base_buffer_t<svo_buffer_t>::
+copy_from_buffer(const svo_gpu_buffer_t& src_buffer, std::size_t src_element_index, std::size_t dst_element_index
+                , std::size_t src_start, std::size_t copy_entries, std::size_t dst_start)
+{
+    svo::detail::copy_element_from_buffer(self(), src_buffer, src_element_index, dst_element_index, src_start, copy_entries, dst_start);
+}
+
 template<typename svo_buffer_t>
 void
 svo_base_buffer_t<svo_buffer_t>::
@@ -60,25 +100,119 @@ append_buffer(const svo_gpu_buffer_t& src_buffer)
 
 
 
-svo_cpu_buffer_t::svo_cpu_buffer_t(const svo_declaration_t& declaration, std::size_t initial_entries)
+svo_cpu_buffer_t::svo_cpu_buffer_t(const svo_declaration_t& declaration, std::size_t initial_entries, svo_arena_t* arena)
     : super_type(declaration, initial_entries, nullptr)
+    , m_storage(make_storage(arena, initial_entries*declaration.stride()))
+    , m_storage_offset(0)
+    , m_arena(arena)
 {
-    m_data.resize(initial_entries*m_declaration.stride());
-    
-    if (initial_entries)
-        m_rawdata = reinterpret_cast<uint8_t*>(&m_data[0]);
-    else
-        m_rawdata = nullptr;
-    
+    m_rawdata = m_storage->data();
     self().assert_invariants();
 }
 
+svo_cpu_buffer_t::svo_cpu_buffer_t(const svo_cpu_buffer_t& other)
+    : super_type(other.m_declaration, other.m_entries, nullptr)
+    , m_storage(make_storage(other.m_arena, other.bytes()))
+    , m_storage_offset(0)
+    , m_arena(other.m_arena)
+{
+    m_rawdata = m_storage->data();
+    if (other.bytes() > 0)
+        std::memcpy(m_rawdata, other.m_rawdata, other.bytes());
+    self().assert_invariants();
+}
+
+svo_cpu_buffer_t::svo_cpu_buffer_t(const svo_cpu_buffer_t& other, share_t)
+    : super_type(other.m_declaration, other.m_entries, other.m_rawdata)
+    , m_storage(other.m_storage)
+    , m_storage_offset(other.m_storage_offset)
+    , m_arena(other.m_arena)
+{
+    self().assert_invariants();
+}
+
+svo_cpu_buffer_t& svo_cpu_buffer_t::operator=(const svo_cpu_buffer_t& other)
+{
+    if (this != &other)
+        *this = svo_cpu_buffer_t(other);
+    return *this;
+}
+
+svo_cpu_buffer_t svo_cpu_buffer_t::view(std::size_t start, std::size_t entries) const
+{
+    self().assert_invariants();
+    if (start > m_entries || entries > m_entries - start)
+        throw std::runtime_error(fmt::format("Invalid buffer view: {}+{}, the buffer has {} entries", start, entries, m_entries));
+
+    svo_cpu_buffer_t result(*this, share_t());
+    result.m_entries = entries;
+    result.m_storage_offset = m_storage_offset + start*stride();
+    result.m_rawdata = result.m_storage->data() + result.m_storage_offset;
+    result.assert_invariants();
+    return result;
+}
+
+bool svo_cpu_buffer_t::shared() const
+{
+    return m_storage.use_count() > 1;
+}
+
+void svo_cpu_buffer_t::make_writable()
+{
+    if (!shared())
+        return;
+
+    copy_storage();
+}
+
+svo_arena_t* svo_cpu_buffer_t::arena() const
+{
+    return m_arena;
+}
+
+void svo_cpu_buffer_t::set_arena(svo_arena_t* arena)
+{
+    m_arena = arena;
+    if (m_storage->get_allocator().arena() != arena)
+        copy_storage();
+}
+
+void svo_cpu_buffer_t::copy_storage()
+{
+    auto storage = make_storage(m_arena, bytes());
+    std::memcpy(storage->data(), m_rawdata, bytes());
+    m_storage.swap(storage);
+    m_storage_offset = 0;
+    m_rawdata = m_storage->data();
+    self().assert_invariants();
+}
+
+std::shared_ptr<svo_cpu_buffer_t::storage_t> svo_cpu_buffer_t::make_storage(svo_arena_t* arena, std::size_t bytes)
+{
+    ///the control block lives in the arena as well.
+    return std::allocate_shared<storage_t>(svo_arena_allocator_t<storage_t>(arena), bytes, svo_arena_allocator_t<uint8_t>(arena));
+}
+
 void svo_cpu_buffer_t::resize(std::size_t new_size)
 {
     self().assert_invariants();
+
+    std::size_t new_bytes = new_size*m_declaration.stride();
+    if (!shared() && m_storage_offset == 0)
+    {
+        m_storage->resize(new_bytes);
+    }
+    else
+    {
+        ///a shared or partial storage; copy the entries that are kept into a storage of our own.
+        auto storage = make_storage(m_arena, new_bytes);
+        std::memcpy(storage->data(), m_rawdata, std::min(new_bytes, bytes()));
+        m_storage.swap(storage);
+        m_storage_offset = 0;
+    }
+
     m_entries = new_size;
-    m_data.resize(new_size*m_declaration.stride());
-    m_rawdata = reinterpret_cast<uint8_t*>(&m_data[0]);
+    m_rawdata = m_storage->data();
     self().assert_invariants();
 }
 
@@ -108,10 +242,40 @@ svo_gpu_buffer_t::svo_gpu_buffer_t(const svo_declaration_t& declaration, std::si
 void svo_gpu_buffer_t::resize(std::size_t new_size)
 {
     self().assert_invariants();
-    throw std::runtime_error("svo_gpu_buffer_t::resize(): NOT IMPLEMENTED");
+
+    if (m_end != m_block->data_end)
+        throw std::runtime_error("svo_gpu_buffer_t::resize(): only the last buffer of a block can be resized"
+                                 "; resize the block's buffers instead");
+
+    goffset_t new_end = m_start + new_size*m_declaration.stride();
+    if (new_end > m_block->dataspace_end)
+        throw svo_bad_alloc();
+
+    if (new_end > m_end)
+        std::memset(m_block->tree->address_space + m_end, 0, new_end - m_end);
+
+    relocate(m_start, new_size);
+    m_block->data_end = m_end;
     self().assert_invariants();
 }
 
+goffset_t svo_gpu_buffer_t::start() const
+{
+    return m_start;
+}
+
+void svo_gpu_buffer_t::relocate(goffset_t start, std::size_t entries)
+{
+    m_start = start;
+    m_end = start + entries*m_declaration.stride();
+    m_entries = entries;
+    m_rawdata = reinterpret_cast<uint8_t*>(m_block->tree->address_space + m_start);
+}
+
+
+void svo_gpu_buffer_t::make_writable()
+{
+}
 
 void svo_gpu_buffer_t::assert_invariants() const
 {
@@ -157,24 +321,11 @@ copy_schema(const svo_schema_t& other, std::size_t new_entries)
     assert(entries() == new_entries);
 }
 
-
-
-////////////////////////////////////////////////////////////////////////////////
-
-svo_cpu_buffers_t::svo_cpu_buffers_t()
-{
-    self().assert_invariants();
-}
-
-
-
-
-svo_cpu_buffer_t&
-svo_cpu_buffers_t::
-add_buffer(const svo_declaration_t& declaration, std::size_t initial_entries)
+template<typename svo_buffer_t, typename svo_buffers_t>
+void
+svo_base_buffers_t<svo_buffer_t, svo_buffers_t>::
+add_element_mappings(const svo_declaration_t& declaration)
 {
-    self().assert_invariants();
-    
     for (const auto& element : declaration.elements())
     {
         if (m_buffer_element_mappings.count(element.name()) > 0)
@@ -203,9 +354,58 @@ add_buffer(const svo_declaration_t& declaration, std::size_t initial_entries)
     
     
     m_buffer_element_mappings.insert(new_buffer_element_mappings.begin(), new_buffer_element_mappings.end());
+}
+
+template<typename svo_buffer_t, typename svo_buffers_t>
+svo_buffer_t&
+svo_base_buffers_t<svo_buffer_t, svo_buffers_t>::
+add_planar_buffers(const svo_declaration_t& declaration, std::size_t initial_entries)
+{
+    assert(declaration.layout() == svo_layout_t::PLANAR);
+
+    ///check all the planes first, so that a bad declaration adds none of them.
+    for (const auto& element : declaration.elements())
+    {
+        if (m_buffer_element_mappings.count(element.name()) > 0)
+            throw std::runtime_error(fmt::format("cannot add buffer containing element named {}; buffers already contains this element."
+                                                 " buffers.schema(): {}, new buffer.declaration(): {}",
+                                                 quote(element.name()), this->schema(), declaration));
+    }
+
+    std::size_t first_buffer_index = m_buffers.size();
+    for (const auto& plane : declaration.planes())
+        self().add_buffer(plane, initial_entries);
+
+    if (first_buffer_index == m_buffers.size())
+        throw std::runtime_error("cannot add a planar declaration without elements");
+    return m_buffers[first_buffer_index];
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+svo_cpu_buffers_t::svo_cpu_buffers_t(svo_arena_t* arena)
+    : m_arena(arena)
+{
+    self().assert_invariants();
+}
+
+
+
+
+svo_cpu_buffer_t&
+svo_cpu_buffers_t::
+add_buffer(const svo_declaration_t& declaration, std::size_t initial_entries)
+{
+    self().assert_invariants();
+
+    if (declaration.layout() == svo_layout_t::PLANAR)
+        return add_planar_buffers(declaration, initial_entries);
     
+    add_element_mappings(declaration);
     
-    m_buffers.push_back(svo_cpu_buffer_t(declaration,initial_entries));
+    m_buffers.push_back(svo_cpu_buffer_t(declaration,initial_entries,m_arena));
     m_schema.push_back(declaration);
 
     self().assert_invariants();
@@ -213,6 +413,31 @@ add_buffer(const svo_declaration_t& declaration, std::size_t initial_entries)
     return m_buffers.back();
 }
 
+void
+svo_cpu_buffers_t::
+share_buffers(const svo_cpu_buffers_t& other)
+{
+    reset();
+    copy_schema(other);
+
+    assert(m_buffers.size() == other.m_buffers.size());
+    for (std::size_t buffer_index = 0; buffer_index < m_buffers.size(); ++buffer_index)
+    {
+        const auto& other_buffer = other.m_buffers[buffer_index];
+        m_buffers[buffer_index] = other_buffer.view(0, other_buffer.entries());
+        m_buffers[buffer_index].set_arena(m_arena);
+    }
+
+    self().assert_invariants();
+}
+
+svo_arena_t*
+svo_cpu_buffers_t::
+arena() const
+{
+    return m_arena;
+}
+
 void
 svo_cpu_buffers_t::
 reset()
@@ -241,19 +466,26 @@ svo_gpu_buffers_t::
 add_buffer(const svo_declaration_t& declaration, std::size_t initial_entries)
 {
     self().assert_invariants();
+
+    if (declaration.layout() == svo_layout_t::PLANAR)
+        return add_planar_buffers(declaration, initial_entries);
     
     goffset_t data_start = m_block->data_end;
     goffset_t data_end = data_start + initial_entries*declaration.stride();
     assert(data_start <= data_end);
     
-    if (data_end >= m_block->dataspace_end)
+    if (data_end > m_block->dataspace_end)
         throw svo_bad_alloc();
     
     
+    add_element_mappings(declaration);
+    
     svo_gpu_buffer_t buffer(declaration, initial_entries, m_block, data_start, data_end);
     m_buffers.push_back(buffer);
+    m_schema.push_back(declaration);
     
     m_block->data_end = data_end;
+    m_block->update_info_section();
     
     buffer.assert_invariants();
     
@@ -262,15 +494,86 @@ add_buffer(const svo_declaration_t& declaration, std::size_t initial_entries)
     return m_buffers.back();
 }
 
+void
+svo_gpu_buffers_t::
+resize(std::size_t new_entries)
+{
+    self().assert_invariants();
+
+    std::size_t old_entries = entries();
+    std::size_t entry_bytes = 0;
+    for (const auto& buffer : m_buffers)
+        entry_bytes += buffer.stride();
+
+    goffset_t data_start = m_block->data_start;
+    if (data_start + new_entries*entry_bytes > m_block->dataspace_end)
+        throw svo_bad_alloc();
+
+    ///buffer i moves from data_start + old_entries*(strides before i) to data_start + new_entries*(strides
+    /// before i); when growing, every buffer moves up, so they are moved from the last, and vice versa.
+    auto move_buffer = [this, data_start, old_entries, new_entries](svo_gpu_buffer_t& buffer, std::size_t preceding_stride)
+    {
+        assert(buffer.start() == data_start + old_entries*preceding_stride);
+        byte_t* address_space = m_block->tree->address_space;
+        goffset_t new_start = data_start + new_entries*preceding_stride;
+        std::size_t kept_bytes = std::min(old_entries, new_entries)*buffer.stride();
+
+        std::memmove(address_space + new_start, address_space + buffer.start(), kept_bytes);
+        if (new_entries > old_entries)
+            std::memset(address_space + new_start + kept_bytes, 0, (new_entries - old_entries)*buffer.stride());
+
+        buffer.relocate(new_start, new_entries);
+    };
+
+    std::size_t preceding_stride = entry_bytes;
+    if (new_entries > old_entries)
+    {
+        for (std::size_t buffer_index = m_buffers.size(); buffer_index-- > 0; )
+        {
+            preceding_stride -= m_buffers[buffer_index].stride();
+            move_buffer(m_buffers[buffer_index], preceding_stride);
+        }
+    }
+    else
+    {
+        preceding_stride = 0;
+        for (auto& buffer : m_buffers)
+        {
+            move_buffer(buffer, preceding_stride);
+            preceding_stride += buffer.stride();
+        }
+    }
+
+    m_block->data_end = data_start + new_entries*entry_bytes;
+    m_block->update_info_section();
+
+    assert(entries() == new_entries || m_buffers.empty());
+    self().assert_invariants();
+}
+
 void
 svo_gpu_buffers_t::
 assert_invariants() const
 {
     super_type::assert_invariants();
 
-    ///TODO check the block pointers match m_block,
-    /// and that they are in the dataspace of the block,
-    /// and that they do not overlap etc.
+#ifndef NDEBUG
+    ///the buffers are back to back from the block's data_start. Nothing else is checked while there are
+    /// none, as this is also called from the base constructor, before m_block is set.
+    if (m_buffers.empty())
+        return;
+
+    assert(m_block);
+    goffset_t next_start = m_block->data_start;
+    for (const auto& buffer : m_buffers)
+    {
+        assert(buffer.m_block == m_block);
+        assert(buffer.m_start == next_start);
+        next_start = buffer.m_end;
+    }
+    assert(next_start == m_block->data_end);
+    assert(m_block->data_end <= m_block->dataspace_end);
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,153 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SERIALIZATION
+
+#include "landscapes/svo_crc32c.hpp"
+#include "landscapes/debug_macro.h"
+
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define SVO_CRC32C_HW_GNU 1
+    #include <nmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #define SVO_CRC32C_HW_MSVC 1
+    #include <nmmintrin.h>
+    #include <intrin.h>
+#endif
+
+namespace svo{
+
+
+///reflected Castagnoli polynomial.
+static const uint32_t CRC32C_POLY = 0x82F63B78;
+
+struct crc32c_tables_t{
+    crc32c_tables_t()
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (std::size_t bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+            table[0][i] = crc;
+        }
+
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            for (std::size_t slice = 1; slice < 8; ++slice)
+                table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+        }
+    }
+
+    uint32_t table[8][256];
+};
+
+static const crc32c_tables_t& crc32c_tables()
+{
+    static const crc32c_tables_t tables;
+    return tables;
+}
+
+uint32_t svo_crc32c_sw(const void* data, std::size_t bytes, uint32_t crc)
+{
+    const auto& table = crc32c_tables().table;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+
+    crc = ~crc;
+
+    ///slicing-by-8; the words are assembled bytewise, so this is independent of the host byte order.
+    while (bytes >= 8)
+    {
+        uint32_t lo = crc ^ (uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24);
+        crc = table[7][lo & 0xFF] ^ table[6][(lo >> 8) & 0xFF] ^ table[5][(lo >> 16) & 0xFF] ^ table[4][lo >> 24]
+            ^ table[3][p[4]] ^ table[2][p[5]] ^ table[1][p[6]] ^ table[0][p[7]];
+        p += 8;
+        bytes -= 8;
+    }
+
+    while (bytes--)
+        crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xFF];
+
+    return ~crc;
+}
+
+
+#if defined(SVO_CRC32C_HW_GNU) || defined(SVO_CRC32C_HW_MSVC)
+
+#if defined(SVO_CRC32C_HW_GNU)
+__attribute__((target("sse4.2")))
+#endif
+static uint32_t crc32c_hw(const void* data, std::size_t bytes, uint32_t crc)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+
+    crc = ~crc;
+
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t crc64 = crc;
+    while (bytes >= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        bytes -= 8;
+    }
+    crc = uint32_t(crc64);
+#endif
+
+    while (bytes >= 4)
+    {
+        uint32_t word;
+        std::memcpy(&word, p, 4);
+        crc = _mm_crc32_u32(crc, word);
+        p += 4;
+        bytes -= 4;
+    }
+
+    while (bytes--)
+        crc = _mm_crc32_u8(crc, *p++);
+
+    return ~crc;
+}
+
+static bool detect_crc32c_hw()
+{
+#if defined(SVO_CRC32C_HW_GNU)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#else
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#endif
+}
+
+bool svo_crc32c_hw_available()
+{
+    static const bool available = detect_crc32c_hw();
+    return available;
+}
+
+uint32_t svo_crc32c(const void* data, std::size_t bytes, uint32_t crc)
+{
+    if (svo_crc32c_hw_available())
+        return crc32c_hw(data, bytes, crc);
+    return svo_crc32c_sw(data, bytes, crc);
+}
+
+#else
+
+bool svo_crc32c_hw_available()
+{
+    return false;
+}
+
+uint32_t svo_crc32c(const void* data, std::size_t bytes, uint32_t crc)
+{
+    return svo_crc32c_sw(data, bytes, crc);
+}
+
+#endif
+
+
+} //namespace svo
@@ -11,8 +11,8 @@ int main(){
 
     std::string dim2str[] = {"x", "y", "z"};
 
-    auto K = SVO_VSIDE_LIMIT;
-    typedef std::vector<vcurve_t> mortonK_table_t;
+    auto K = SVO_MORTON_TABLE_SIDE;
+    typedef std::vector<uint32_t> mortonK_table_t;
 
     std::vector< mortonK_table_t > tables;
 
@@ -22,24 +22,24 @@ int main(){
         tables.push_back(mortonK_table_t());
         auto& table = tables.back();
 
-        for (vside_t u = 0; u < SVO_VSIDE_LIMIT; ++u)
+        for (vside_t u = 0; u < SVO_MORTON_TABLE_SIDE; ++u)
         {
             vcurve_t xyz[] = {0,0,0};
             xyz[primary_dimension] = u;
 
             vcurve_t x = xyz[0], y = xyz[1], z = xyz[2];
 
-            vcurve_t vcurve = coords2vcurve_brute(x,y,z,SVO_VSIDE_LIMIT);
+            vcurve_t vcurve = coords2vcurve_brute(x,y,z,SVO_MORTON_TABLE_SIDE);
 
-            table.push_back(vcurve);
+            table.push_back(uint32_t(vcurve));
         }
     }
 
-    for (vside_t x = 0; x < SVO_VSIDE_LIMIT; ++x)
-    for (vside_t y = 0; y < SVO_VSIDE_LIMIT; ++y)
-    for (vside_t z = 0; z < SVO_VSIDE_LIMIT; ++z)
+    for (vside_t x = 0; x < SVO_MORTON_TABLE_SIDE; ++x)
+    for (vside_t y = 0; y < SVO_MORTON_TABLE_SIDE; ++y)
+    for (vside_t z = 0; z < SVO_MORTON_TABLE_SIDE; ++z)
     {
-        vcurve_t vcurve0 = coords2vcurve_brute(x,y,z,SVO_VSIDE_LIMIT);
+        vcurve_t vcurve0 = coords2vcurve_brute(x,y,z,SVO_MORTON_TABLE_SIDE);
         vcurve_t vcurve1 = tables.at(0).at(x) | tables.at(1).at(y) | tables.at(2).at(z);
 
         assert(vcurve0 == vcurve1);
@@ -59,15 +59,15 @@ int main(){
         std::cout << "GLOBAL_STATIC_CONST uint32_t morton" << K << "_" << dimname << "[" << K << "] = {" << std::endl;
         std::cout << "{" << std::endl;
 
-        for (vside_t u = 0; u < SVO_VSIDE_LIMIT; ++u)
+        for (vside_t u = 0; u < SVO_MORTON_TABLE_SIDE; ++u)
         {
-            std::size_t vcurve_hex_digits = sizeof(vcurve_t)*2;
+            std::size_t vcurve_hex_digits = sizeof(uint32_t)*2;
             
             std::cout << (u == 0 || ((u + 7) % 8 == 0) ? "    " : " ")
                       << "0x" << std::hex << std::setfill('0') << std::setw(vcurve_hex_digits) << table.at(u) << std::dec
-                      << (u == SVO_VSIDE_LIMIT-1 ? "" : ",");
+                      << (u == SVO_MORTON_TABLE_SIDE-1 ? "" : ",");
 
-            if (u % 8 == 0 || u == SVO_VSIDE_LIMIT-1)
+            if (u % 8 == 0 || u == SVO_MORTON_TABLE_SIDE-1)
                 std::cout << std::endl;
         }
 
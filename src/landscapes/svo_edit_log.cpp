@@ -0,0 +1,625 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SERIALIZATION
+
+#include "landscapes/svo_edit_log.hpp"
+#include "landscapes/svo_serialization.v1.hpp"
+#include "landscapes/svo_serialization.v2.hpp"
+#include "landscapes/svo_serialization.detail.hpp"
+#include "landscapes/svo_crc32c.hpp"
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/debug_macro.h"
+#include "format.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <cstdio>
+#include <map>
+#include <tuple>
+#include <limits>
+#include <algorithm>
+
+namespace svo{
+
+
+static const char EDIT_LOG_MAGIC[4] = {'S','V','O','E'};
+///version 2 widened the vcurve of the records to u64; version 1 logs are upgraded when opened.
+static const uint32_t EDIT_LOG_VERSION = 2;
+static const uint32_t EDIT_LOG_VERSION_VCURVE32 = 1;
+///written in host order; reads back as this value only on a host with the same byte order.
+static const uint32_t EDIT_LOG_BYTE_ORDER_MARK = 0x01020304;
+
+///magic, version, byte order mark.
+static const std::size_t EDIT_LOG_HEADER_SIZE = 4 + 4 + 4;
+///length and checksum of each record.
+static const std::size_t EDIT_RECORD_HEADER_SIZE = 4 + 4;
+
+
+svo_edit_t::svo_edit_t()
+    : op(svo_edit_op_t::erase), slice_id(invalid_slice_id), vcurve(0)
+{
+
+}
+
+
+static void write_edit_log_header(std::ostream& out)
+{
+    out.write(EDIT_LOG_MAGIC, sizeof(EDIT_LOG_MAGIC));
+    serialize_uint<uint32_t>(out, EDIT_LOG_VERSION);
+    out.write(reinterpret_cast<const char*>(&EDIT_LOG_BYTE_ORDER_MARK), sizeof(EDIT_LOG_BYTE_ORDER_MARK));
+}
+
+///returns the version of the log.
+static uint32_t read_edit_log_header(std::istream& in)
+{
+    char magic[sizeof(EDIT_LOG_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (std::size_t(in.gcount()) != sizeof(magic) || std::memcmp(magic, EDIT_LOG_MAGIC, sizeof(magic)) != 0)
+        throw std::runtime_error("Not an edit log");
+
+    auto version = unserialize_uint<uint32_t>(in);
+    if (version != EDIT_LOG_VERSION && version != EDIT_LOG_VERSION_VCURVE32)
+        throw std::runtime_error(fmt::format("Unsupported edit log version: {}, expected {}", version, EDIT_LOG_VERSION));
+
+    uint32_t byte_order_mark = 0;
+    in.read(reinterpret_cast<char*>(&byte_order_mark), sizeof(byte_order_mark));
+    if (byte_order_mark != EDIT_LOG_BYTE_ORDER_MARK)
+        throw std::runtime_error("Edit log was written on a host with a different byte order");
+    return version;
+}
+
+static std::string serialize_edit(const svo_edit_t& edit)
+{
+    std::ostringstream record;
+    serialize_uint<uint8_t>(record, uint8_t(edit.op));
+    serialize_uint<uint32_t>(record, edit.slice_id);
+    serialize_uint<uint64_t>(record, uint64_t(edit.vcurve));
+
+    switch (edit.op)
+    {
+        case svo_edit_op_t::erase:
+            break;
+        case svo_edit_op_t::update:
+            serialize_string(record, edit.element);
+            serialize_uint<uint32_t>(record, uint32_t(edit.data.size()));
+            record.write(reinterpret_cast<const char*>(edit.data.data()), edit.data.size());
+            break;
+        case svo_edit_op_t::insert:
+            serialize_uint<uint32_t>(record, uint32_t(edit.data.size()));
+            record.write(reinterpret_cast<const char*>(edit.data.data()), edit.data.size());
+            break;
+    }
+    return record.str();
+}
+
+static svo_edit_t unserialize_edit(std::istream& in, uint32_t version)
+{
+    svo_edit_t edit;
+
+    auto op = unserialize_uint<uint8_t>(in);
+    if (op > uint8_t(svo_edit_op_t::update))
+        throw std::runtime_error(fmt::format("Invalid edit op: {}", uint32_t(op)));
+    edit.op = svo_edit_op_t(op);
+    edit.slice_id = unserialize_uint<uint32_t>(in);
+    if (version == EDIT_LOG_VERSION_VCURVE32)
+        edit.vcurve = unserialize_uint<uint32_t>(in);
+    else
+    {
+        uint64_t vcurve = unserialize_uint<uint64_t>(in);
+        if (vcurve > uint64_t(vcurve_t(-1)))
+            throw std::runtime_error(fmt::format("Edit of vcurve {} needs 64 bit vcurves; rebuild with SVO_VCURVE_64", vcurve));
+        edit.vcurve = vcurve_t(vcurve);
+    }
+
+    if (edit.op == svo_edit_op_t::update)
+        edit.element = unserialize_string(in);
+
+    if (edit.op != svo_edit_op_t::erase)
+    {
+        std::size_t bytes = unserialize_uint<uint32_t>(in);
+        edit.data.resize(bytes);
+        in.read(reinterpret_cast<char*>(edit.data.data()), bytes);
+        if (std::size_t(in.gcount()) != bytes)
+            throw std::runtime_error("Truncated edit data");
+    }
+    return edit;
+}
+
+/**
+ * Reads the records starting at the current position, up to the offset @c limit from the start of the
+ *  log (@c log_begin), in the format of @c version. Returns the offset past the last complete record.
+ */
+static uint64_t read_edit_records(std::istream& in, uint64_t log_begin, uint64_t limit, uint32_t version
+                                    , std::vector<svo_edit_t>& edits)
+{
+    uint64_t offset = uint64_t(in.tellg()) - log_begin;
+
+    std::string record;
+    while (offset < limit)
+    {
+        char frame[EDIT_RECORD_HEADER_SIZE];
+        in.read(frame, sizeof(frame));
+        if (std::size_t(in.gcount()) != sizeof(frame))
+            break;
+
+        std::size_t bytes = 0;
+        uint32_t expected_crc = 0;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            bytes = (bytes << 8) | uint8_t(frame[i]);
+            expected_crc = (expected_crc << 8) | uint8_t(frame[4 + i]);
+        }
+
+        ///read in bounded chunks, so that a torn length does not turn into a huge allocation.
+        static const std::size_t CHUNK_SIZE = 1 << 16;
+        record.clear();
+        while (record.size() < bytes && in)
+        {
+            std::size_t chunk_offset = record.size();
+            std::size_t chunk = std::min(CHUNK_SIZE, bytes - chunk_offset);
+            record.resize(chunk_offset + chunk);
+            in.read(&record[chunk_offset], chunk);
+            record.resize(chunk_offset + std::size_t(in.gcount()));
+        }
+        if (record.size() != bytes)
+            break;
+
+        ///a bad record is torn if nothing follows it; anywhere else the log is corrupt.
+        bool last = in.peek() == std::char_traits<char>::eof();
+        in.clear();
+
+        try {
+            if (svo_crc32c(record.data(), record.size()) != expected_crc)
+                throw std::runtime_error(fmt::format("Checksum mismatch in edit log record at offset {}", offset));
+
+            svo_memory_streambuf_t record_buf(record.data(), record.size());
+            std::istream record_in(&record_buf);
+            edits.push_back(unserialize_edit(record_in, version));
+
+            if (record_buf.remaining() != 0)
+                throw std::runtime_error(fmt::format("Trailing bytes in edit log record at offset {}", offset));
+        } catch (const std::runtime_error&) {
+            if (last)
+                break;
+            throw;
+        }
+
+        offset += EDIT_RECORD_HEADER_SIZE + bytes;
+    }
+
+    in.clear();
+    return offset;
+}
+
+std::vector<svo_edit_t> svo_read_edit_log(std::istream& in, uint64_t* valid_end)
+{
+    uint64_t log_begin = uint64_t(in.tellg());
+    uint32_t version = read_edit_log_header(in);
+
+    std::vector<svo_edit_t> edits;
+    uint64_t end = read_edit_records(in, log_begin, std::numeric_limits<uint64_t>::max(), version, edits);
+
+    if (valid_end)
+        *valid_end = end;
+    return edits;
+}
+
+
+
+
+namespace{
+    ///where an element lives, within a buffer and within an insert edit's entry.
+    struct element_location_t{
+        std::size_t buffer_index;
+        std::size_t buffer_offset;
+        std::size_t entry_offset;
+        std::size_t bytes;
+    };
+
+    ///the net effect of the edits to one vcurve.
+    struct folded_edit_t{
+        folded_edit_t() : op(svo_edit_op_t::update) {}
+
+        ///insert (with @c entry), erase, or update of an existing voxel (with @c updates).
+        svo_edit_op_t op;
+        std::vector<uint8_t> entry;
+        std::vector<const svo_edit_t*> updates;
+    };
+} //namespace
+
+
+void svo_apply_edits(svo_slice_t* slice, const std::vector<const svo_edit_t*>& edits)
+{
+    assert(slice);
+    assert(slice->pos_data);
+    assert(slice->buffers);
+
+    auto& pos_data = *slice->pos_data;
+    auto& buffers = *slice->buffers;
+    auto& buffer_list = buffers.buffers();
+
+    std::vector<std::size_t> entry_offsets;
+    std::map<std::string, element_location_t> elements;
+    std::size_t entry_bytes = 0;
+    for (std::size_t buffer_index = 0; buffer_index < buffer_list.size(); ++buffer_index)
+    {
+        const auto& declaration = buffer_list[buffer_index].declaration();
+
+        entry_offsets.push_back(entry_bytes);
+        for (std::size_t element_index = 0; element_index < declaration.elements().size(); ++element_index)
+        {
+            const auto& element = declaration.elements()[element_index];
+
+            element_location_t location;
+            location.buffer_index = buffer_index;
+            location.buffer_offset = declaration.offset(element_index);
+            location.entry_offset = entry_bytes + declaration.offset(element_index);
+            location.bytes = element.bytes();
+            elements[element.name()] = location;
+        }
+        entry_bytes += declaration.stride();
+    }
+
+    auto find_element = [&elements](const svo_edit_t& edit) -> const element_location_t& {
+        auto w = elements.find(edit.element);
+        if (w == elements.end())
+            throw std::runtime_error(fmt::format("Edit of unknown element: {}", edit.element));
+        if (w->second.bytes != edit.data.size())
+            throw std::runtime_error(fmt::format("Edit of element {} has {} bytes, expected {}"
+                                                , edit.element, edit.data.size(), w->second.bytes));
+        return w->second;
+    };
+
+    ///fold the edits of each vcurve into their net effect.
+    std::map<vcurve_t, folded_edit_t> folded;
+    for (const svo_edit_t* edit : edits)
+    {
+        assert(edit);
+        if (edit->vcurve >= vcurvesize(slice->side))
+            throw std::runtime_error(fmt::format("Edit of vcurve {} is outside of the slice", edit->vcurve));
+
+        auto& folded_edit = folded[edit->vcurve];
+        switch (edit->op)
+        {
+            case svo_edit_op_t::insert:
+                if (edit->data.size() != entry_bytes)
+                    throw std::runtime_error(fmt::format("Insert edit has {} bytes, expected {}", edit->data.size(), entry_bytes));
+                folded_edit.op = svo_edit_op_t::insert;
+                folded_edit.entry = edit->data;
+                folded_edit.updates.clear();
+                break;
+            case svo_edit_op_t::erase:
+                folded_edit.op = svo_edit_op_t::erase;
+                folded_edit.entry.clear();
+                folded_edit.updates.clear();
+                break;
+            case svo_edit_op_t::update:
+            {
+                const auto& location = find_element(*edit);
+                if (folded_edit.op == svo_edit_op_t::insert)
+                    std::memcpy(folded_edit.entry.data() + location.entry_offset, edit->data.data(), location.bytes);
+                else if (folded_edit.op == svo_edit_op_t::update)
+                    folded_edit.updates.push_back(edit);
+                break;
+            }
+        }
+    }
+
+    ///merge the slice with the folded edits, both sorted by vcurve.
+    std::vector<vcurve_t> new_pos_data;
+    new_pos_data.reserve(pos_data.size() + folded.size());
+    std::vector< std::vector<uint8_t> > new_data(buffer_list.size());
+    for (std::size_t buffer_index = 0; buffer_index < buffer_list.size(); ++buffer_index)
+        new_data[buffer_index].reserve((pos_data.size() + folded.size()) * buffer_list[buffer_index].stride());
+
+    auto copy_old = [&](std::size_t begin, std::size_t end){
+        new_pos_data.insert(new_pos_data.end(), pos_data.begin() + begin, pos_data.begin() + end);
+        for (std::size_t buffer_index = 0; buffer_index < buffer_list.size(); ++buffer_index)
+        {
+            const auto& buffer = buffer_list[buffer_index];
+            const uint8_t* src = buffer.rawdata() + begin * buffer.stride();
+            new_data[buffer_index].insert(new_data[buffer_index].end(), src, src + (end - begin) * buffer.stride());
+        }
+    };
+
+    auto append_entry = [&](vcurve_t vcurve, const std::vector<uint8_t>& entry){
+        new_pos_data.push_back(vcurve);
+        for (std::size_t buffer_index = 0; buffer_index < buffer_list.size(); ++buffer_index)
+        {
+            const uint8_t* src = entry.data() + entry_offsets[buffer_index];
+            new_data[buffer_index].insert(new_data[buffer_index].end(), src, src + buffer_list[buffer_index].stride());
+        }
+    };
+
+    std::size_t pos_index = 0;
+    for (const auto& vcurve_edit : folded)
+    {
+        vcurve_t vcurve = vcurve_edit.first;
+        const auto& folded_edit = vcurve_edit.second;
+
+        ///the untouched voxels before this one, in one go.
+        std::size_t run_end = std::lower_bound(pos_data.begin() + pos_index, pos_data.end(), vcurve) - pos_data.begin();
+        copy_old(pos_index, run_end);
+        pos_index = run_end;
+
+        bool exists = pos_index < pos_data.size() && pos_data[pos_index] == vcurve;
+
+        switch (folded_edit.op)
+        {
+            case svo_edit_op_t::insert:
+                append_entry(vcurve, folded_edit.entry);
+                break;
+            case svo_edit_op_t::erase:
+                break;
+            case svo_edit_op_t::update:
+                if (!exists)
+                    break;
+                copy_old(pos_index, pos_index + 1);
+                for (const svo_edit_t* update : folded_edit.updates)
+                {
+                    const auto& location = find_element(*update);
+                    auto& data = new_data[location.buffer_index];
+                    std::size_t stride = buffer_list[location.buffer_index].stride();
+                    std::memcpy(data.data() + data.size() - stride + location.buffer_offset, update->data.data(), location.bytes);
+                }
+                break;
+        }
+
+        if (exists)
+            ++pos_index;
+    }
+    copy_old(pos_index, pos_data.size());
+
+    pos_data.swap(new_pos_data);
+    buffers.resize(pos_data.size());
+    for (std::size_t buffer_index = 0; buffer_index < buffer_list.size(); ++buffer_index)
+    {
+        auto& buffer = buffer_list[buffer_index];
+        assert(buffer.bytes() == new_data[buffer_index].size());
+        if (buffer.bytes() > 0)
+            std::memcpy(buffer.rawdata(), new_data[buffer_index].data(), buffer.bytes());
+    }
+}
+
+
+
+
+static void replace_file(const std::string& from, const std::string& to)
+{
+    if (std::rename(from.c_str(), to.c_str()) == 0)
+        return;
+
+    ///some platforms do not rename over an existing file.
+    std::remove(to.c_str());
+    if (std::rename(from.c_str(), to.c_str()) != 0)
+        throw std::runtime_error(fmt::format("Cannot replace {} with {}", to, from));
+}
+
+///writes a new log at @c path holding the header and the bytes [@c begin, @c end) of @c in.
+static void rewrite_edit_log(const std::string& path, std::istream& in, uint64_t begin, uint64_t end)
+{
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        write_edit_log_header(out);
+
+        in.clear();
+        in.seekg(begin);
+
+        std::vector<char> chunk(1 << 16);
+        for (uint64_t remaining = end - begin; remaining > 0; )
+        {
+            std::size_t bytes = std::size_t(std::min<uint64_t>(remaining, chunk.size()));
+            in.read(chunk.data(), bytes);
+            if (std::size_t(in.gcount()) != bytes)
+                throw std::runtime_error(fmt::format("Truncated edit log: {}", path));
+            out.write(chunk.data(), bytes);
+            remaining -= bytes;
+        }
+
+        if (!out.flush())
+            throw std::runtime_error(fmt::format("Failed writing edit log: {}", tmp_path));
+    }
+    replace_file(tmp_path, path);
+}
+
+///writes a new log at @c path holding @c edits, in the current format; returns its size.
+static uint64_t upgrade_edit_log(const std::string& path, const std::vector<svo_edit_t>& edits)
+{
+    std::string tmp_path = path + ".tmp";
+    uint64_t end = EDIT_LOG_HEADER_SIZE;
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        write_edit_log_header(out);
+        for (const auto& edit : edits)
+        {
+            std::string record = serialize_edit(edit);
+            svo_write_section(out, record);
+            end += EDIT_RECORD_HEADER_SIZE + record.size();
+        }
+
+        if (!out.flush())
+            throw std::runtime_error(fmt::format("Failed writing edit log: {}", tmp_path));
+    }
+    replace_file(tmp_path, path);
+    return end;
+}
+
+svo_edit_log_t::svo_edit_log_t(const std::string& path)
+    : m_path(path), m_end(EDIT_LOG_HEADER_SIZE), m_size(0)
+{
+    std::ifstream in(m_path, std::ios::binary);
+    bool exists = in && in.peek() != std::char_traits<char>::eof();
+    in.clear();
+
+    if (!exists)
+    {
+        in.close();
+        std::ofstream out(m_path, std::ios::binary | std::ios::trunc);
+        write_edit_log_header(out);
+        if (!out.flush())
+            throw std::runtime_error(fmt::format("Cannot create edit log: {}", m_path));
+    }
+    else
+    {
+        uint32_t version = read_edit_log_header(in);
+
+        std::vector<svo_edit_t> edits;
+        m_end = read_edit_records(in, 0, std::numeric_limits<uint64_t>::max(), version, edits);
+        m_size = edits.size();
+
+        in.clear();
+        in.seekg(0, std::ios::end);
+        uint64_t file_size = uint64_t(in.tellg());
+
+        if (version != EDIT_LOG_VERSION)
+        {
+            in.close();
+            m_end = upgrade_edit_log(m_path, edits);
+        }
+        ///cut off a torn record.
+        else if (file_size != m_end)
+            rewrite_edit_log(m_path, in, EDIT_LOG_HEADER_SIZE, m_end);
+    }
+
+    open_for_append();
+}
+
+void svo_edit_log_t::open_for_append()
+{
+    m_out.open(m_path, std::ios::binary | std::ios::app);
+    if (!m_out)
+        throw std::runtime_error(fmt::format("Cannot open edit log: {}", m_path));
+}
+
+void svo_edit_log_t::append(const svo_edit_t& edit)
+{
+    std::string record = serialize_edit(edit);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    svo_write_section(m_out, record);
+    if (!m_out)
+        throw std::runtime_error(fmt::format("Failed appending to edit log: {}", m_path));
+
+    m_end += EDIT_RECORD_HEADER_SIZE + record.size();
+    ++m_size;
+}
+
+void svo_edit_log_t::insert(svo_slice_id_t slice_id, vcurve_t vcurve, const std::vector<uint8_t>& entry)
+{
+    svo_edit_t edit;
+    edit.op = svo_edit_op_t::insert;
+    edit.slice_id = slice_id;
+    edit.vcurve = vcurve;
+    edit.data = entry;
+    append(edit);
+}
+
+void svo_edit_log_t::erase(svo_slice_id_t slice_id, vcurve_t vcurve)
+{
+    svo_edit_t edit;
+    edit.op = svo_edit_op_t::erase;
+    edit.slice_id = slice_id;
+    edit.vcurve = vcurve;
+    append(edit);
+}
+
+void svo_edit_log_t::update(svo_slice_id_t slice_id, vcurve_t vcurve, const std::string& element, const void* data, std::size_t bytes)
+{
+    svo_edit_t edit;
+    edit.op = svo_edit_op_t::update;
+    edit.slice_id = slice_id;
+    edit.vcurve = vcurve;
+    edit.element = element;
+    edit.data.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + bytes);
+    append(edit);
+}
+
+void svo_edit_log_t::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_out.flush();
+}
+
+std::size_t svo_edit_log_t::size() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+void svo_edit_log_t::compact(std::iostream& archive, const svo_serialization_options_t& options)
+{
+    std::unique_lock<std::mutex> compact_lock(m_compact_mutex);
+
+    ///the records up to here are folded; later appends stay in the log.
+    uint64_t snapshot_end;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_out.flush();
+        snapshot_end = m_end;
+    }
+
+    std::vector<svo_edit_t> edits;
+    {
+        std::ifstream in(m_path, std::ios::binary);
+        uint32_t version = read_edit_log_header(in);
+        if (read_edit_records(in, 0, snapshot_end, version, edits) != snapshot_end)
+            throw std::runtime_error(fmt::format("Edit log changed while compacting: {}", m_path));
+    }
+
+    if (!edits.empty())
+    {
+        std::map<svo_slice_id_t, std::vector<const svo_edit_t*> > slice_edits;
+        for (const auto& edit : edits)
+            slice_edits[edit.slice_id].push_back(&edit);
+
+        uint64_t archive_begin = uint64_t(archive.tellg());
+
+        std::map<svo_slice_id_t, const svo_slice_t*> slices;
+        try {
+            svo_archive_t reader(archive);
+            for (const auto& id_edits : slice_edits)
+            {
+                const auto& entry = reader.entry(id_edits.first);
+
+                svo_slice_t* slice = svo_init_slice(entry.level, entry.side);
+                slices[id_edits.first] = slice;
+
+                ///with empty children, so that the child info is written back unchanged.
+                reader.load_slice(id_edits.first, slice, true);
+                svo_apply_edits(slice, id_edits.second);
+            }
+
+            archive.clear();
+            archive.seekg(archive_begin);
+            svo_archive_update_slices(archive, slices, options);
+        } catch (...) {
+            for (const auto& id_slice : slices)
+                svo_uninit_slice(const_cast<svo_slice_t*>(id_slice.second), true);
+            throw;
+        }
+
+        for (const auto& id_slice : slices)
+            svo_uninit_slice(const_cast<svo_slice_t*>(id_slice.second), true);
+    }
+
+    ///drop the folded records, keeping the ones appended meanwhile.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_out.flush();
+    m_out.close();
+    {
+        std::ifstream in(m_path, std::ios::binary);
+        rewrite_edit_log(m_path, in, snapshot_end, m_end);
+    }
+    m_end = EDIT_LOG_HEADER_SIZE + (m_end - snapshot_end);
+    m_size -= edits.size();
+    open_for_append();
+}
+
+std::future<void> svo_edit_log_t::compact_async(std::iostream& archive, const svo_serialization_options_t& options)
+{
+    return std::async(std::launch::async, [this, &archive, options](){ compact(archive, options); });
+}
+
+
+} //namespace svo
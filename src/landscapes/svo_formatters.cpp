@@ -58,6 +58,8 @@ std::ostream& operator<<(std::ostream& out, const std::vector<svo::svo_element_t
 std::ostream& operator<<(std::ostream& out, const svo::svo_declaration_t& declaration)
 {
     out << "<(svo_declaration_t stride=" << declaration.stride();
+    if (declaration.layout() == svo::svo_layout_t::PLANAR)
+        out << ", layout=planar";
 
     out << ", elements=[";
 
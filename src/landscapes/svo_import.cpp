@@ -0,0 +1,289 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_MCLOADER
+
+#include "landscapes/svo_import.hpp"
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_buffer.hpp"
+#include "landscapes/svo_morton.hpp"
+#include "landscapes/svo_sort.hpp"
+#include "landscapes/svo_parallel.detail.hpp"
+#include "landscapes/svo_tree.sanity.hpp"
+#include "landscapes/debug_macro.h"
+#include "format.h"
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+namespace svo{
+
+
+namespace{
+    ///the voxels of one slice, a range of the sorted records.
+    struct slice_run_t{
+        vcurve_t slice_vcurve;
+        std::size_t begin;
+        std::size_t end;
+    };
+} //namespace
+
+
+///number of bits of the Morton codes of a volume of slices.
+static std::size_t volume_key_bits(const volume_of_slices_t& volume)
+{
+    uint64_t max_key = uint64_t(vcurvesize(volume.volume_side)) * vcurvesize(volume.slice_side) - 1;
+
+    std::size_t bits = 0;
+    while (bits < 64 && (max_key >> bits) != 0)
+        ++bits;
+    return bits;
+}
+
+/**
+ * Both sides must be powers of two, and the volume, @c volume_side slices of @c slice_side voxels across,
+ *  must fit in a vcurve; volume_key_bits() relies on both.
+ */
+static void check_volume(const volume_of_slices_t& volume)
+{
+    auto is_valid_side = [](std::size_t side){ return side > 0 && side <= SVO_VSIDE_LIMIT && (side & (side - 1)) == 0; };
+
+    if (!is_valid_side(volume.volume_side) || !is_valid_side(volume.slice_side)
+        || uint64_t(volume.volume_side) * volume.slice_side > SVO_VSIDE_LIMIT)
+        throw std::runtime_error(fmt::format("Invalid volume of slices: volume side {}, slice side {}"
+                                            , volume.volume_side, volume.slice_side));
+    if (!volume.slices.empty())
+        throw std::runtime_error("Importing into a volume that already has slices");
+}
+
+///number of voxels whose keys are encoded in one svo_morton_encode_n() batch.
+static const std::size_t KEY_BATCH_SIZE = 256;
+
+/**
+ * Sets @c records[i].key to the Morton code of voxel @c i of @c coords (3 per voxel), in voxels of the
+ *  whole volume: the slice's vcurve within the volume, followed by the voxel's vcurve within the slice.
+ */
+static void volume_keys(const volume_of_slices_t& volume, const vside_t* coords, std::size_t n, svo_sort_record_t* records)
+{
+    vside_t slice_side = volume.slice_side;
+    vcurvesize_t slice_size = vcurvesize(slice_side);
+
+    vside_t slice_coords[3*KEY_BATCH_SIZE];
+    vside_t voxel_coords[3*KEY_BATCH_SIZE];
+    vcurve_t slice_vcurves[KEY_BATCH_SIZE];
+    vcurve_t voxel_vcurves[KEY_BATCH_SIZE];
+
+    for (std::size_t begin = 0; begin < n; begin += KEY_BATCH_SIZE)
+    {
+        std::size_t batch_size = std::min(KEY_BATCH_SIZE, n - begin);
+        for (std::size_t i = 0; i < 3*batch_size; ++i)
+        {
+            slice_coords[i] = coords[3*begin + i] / slice_side;
+            voxel_coords[i] = coords[3*begin + i] % slice_side;
+        }
+
+        svo_morton_encode_n(slice_coords, slice_vcurves, batch_size);
+        svo_morton_encode_n(voxel_coords, voxel_vcurves, batch_size);
+
+        for (std::size_t i = 0; i < batch_size; ++i)
+            records[begin + i].key = uint64_t(slice_vcurves[i]) * slice_size + voxel_vcurves[i];
+    }
+}
+
+
+/**
+ * Creates the slices of sorted @c records, copying each voxel's entry from @c source + source_index*stride,
+ *  and appends them to @c volume.
+ */
+static void emit_slices(volume_of_slices_t& volume, const svo_declaration_t& declaration
+                        , const std::vector<svo_sort_record_t>& records, const uint8_t* source
+                        , std::size_t num_threads)
+{
+    vcurvesize_t slice_size = vcurvesize(volume.slice_side);
+    std::size_t stride = declaration.stride();
+
+    std::vector<slice_run_t> runs;
+    for (std::size_t begin = 0; begin < records.size(); )
+    {
+        vcurve_t slice_vcurve = vcurve_t(records[begin].key / slice_size);
+        std::size_t end = begin + 1;
+        while (end < records.size() && records[end].key / slice_size == slice_vcurve)
+            ++end;
+
+        runs.push_back(slice_run_t{slice_vcurve, begin, end});
+        begin = end;
+    }
+
+    std::vector<svo_slice_t*> slices(runs.size(), nullptr);
+
+    try {
+        for (auto& slice : slices)
+            slice = svo_init_slice(0, volume.slice_side);
+
+        std::atomic<std::size_t> next_run(0);
+        run_parallel(std::min(num_threads, runs.size()), [&](std::size_t){
+            for (std::size_t run_index = next_run++; run_index < runs.size(); run_index = next_run++)
+            {
+                const auto& run = runs[run_index];
+                svo_slice_t* slice = slices[run_index];
+                auto& pos_data = *slice->pos_data;
+
+                ///the last record of each key wins.
+                pos_data.reserve(run.end - run.begin);
+                std::vector<uint64_t> source_indices;
+                source_indices.reserve(run.end - run.begin);
+                for (std::size_t i = run.begin; i < run.end; ++i)
+                {
+                    if (i + 1 < run.end && records[i + 1].key == records[i].key)
+                        continue;
+                    pos_data.push_back(vcurve_t(records[i].key % slice_size));
+                    source_indices.push_back(records[i].index);
+                }
+
+                auto& buffer = slice->buffers->add_buffer(declaration, pos_data.size());
+                uint8_t* dst = buffer.rawdata();
+                for (uint64_t source_index : source_indices)
+                {
+                    std::memcpy(dst, source + source_index * stride, stride);
+                    dst += stride;
+                }
+
+                DEBUG {
+                    if (auto error = svo_slice_sanity(slice))
+                    {
+                        std::cerr << "error: " << error << std::endl;
+                        assert(false && "sanity fail");
+                    }
+                }
+            }
+        });
+    } catch (...) {
+        for (auto* slice : slices)
+            if (slice)
+                svo_uninit_slice(slice, true);
+        throw;
+    }
+
+    volume.slices.reserve(volume.slices.size() + runs.size());
+    for (std::size_t run_index = 0; run_index < runs.size(); ++run_index)
+        volume.slices.push_back(std::make_tuple(runs[run_index].slice_vcurve, slices[run_index]));
+}
+
+
+void svo_import_points(volume_of_slices_t& volume, const svo_declaration_t& declaration
+                        , const vside_t* coords, const void* attributes, std::size_t count
+                        , std::size_t num_threads)
+{
+    check_volume(volume);
+
+    vside_t volume_voxel_side = volume.volume_side * volume.slice_side;
+
+    std::vector<svo_sort_record_t> records(count);
+    std::size_t num_chunks = std::max<std::size_t>(1, std::min(num_threads, count / 4096));
+    run_parallel(num_chunks, [&](std::size_t thread_index){
+        std::size_t end = chunk_begin(count, num_chunks, thread_index + 1);
+        for (std::size_t i = chunk_begin(count, num_chunks, thread_index); i < end; ++i)
+        {
+            vside_t x = coords[3*i + 0], y = coords[3*i + 1], z = coords[3*i + 2];
+            if (x >= volume_voxel_side || y >= volume_voxel_side || z >= volume_voxel_side)
+                throw std::runtime_error(fmt::format("Point {} at ({},{},{}) is outside of the volume of side {}"
+                                                    , i, x, y, z, volume_voxel_side));
+            records[i].index = i;
+        }
+
+        std::size_t begin = chunk_begin(count, num_chunks, thread_index);
+        volume_keys(volume, coords + 3*begin, end - begin, records.data() + begin);
+    });
+
+    svo_radix_sort(records, volume_key_bits(volume), num_threads);
+
+    emit_slices(volume, declaration, records, static_cast<const uint8_t*>(attributes), num_threads);
+}
+
+
+void svo_import_dense(volume_of_slices_t& volume, const svo_declaration_t& declaration
+                        , const void* data, vside_t width, vside_t height, vside_t depth
+                        , std::size_t num_threads, const svo_import_empty_fn_t& is_empty)
+{
+    check_volume(volume);
+
+    vside_t volume_voxel_side = volume.volume_side * volume.slice_side;
+    if (width > volume_voxel_side || height > volume_voxel_side || depth > volume_voxel_side)
+        throw std::runtime_error(fmt::format("Grid of {}x{}x{} does not fit in the volume of side {}"
+                                            , width, height, depth, volume_voxel_side));
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    std::size_t stride = declaration.stride();
+
+    auto empty = [&is_empty, stride](const uint8_t* entry){
+        if (is_empty)
+            return is_empty(entry);
+        for (std::size_t i = 0; i < stride; ++i)
+            if (entry[i] != 0)
+                return false;
+        return true;
+    };
+
+    ///each thread collects the non-empty voxels of a range of z layers; concatenated in order.
+    num_threads = std::max<std::size_t>(1, std::min<std::size_t>(num_threads, depth));
+    std::vector< std::vector<svo_sort_record_t> > thread_records(num_threads);
+    run_parallel(num_threads, [&](std::size_t thread_index){
+        auto& records = thread_records[thread_index];
+        std::vector<vside_t> row_coords;
+        row_coords.reserve(3*width);
+
+        vside_t z_end = vside_t(chunk_begin(depth, num_threads, thread_index + 1));
+        for (vside_t z = vside_t(chunk_begin(depth, num_threads, thread_index)); z < z_end; ++z)
+        for (vside_t y = 0; y < height; ++y)
+        {
+            ///collect the row's voxels, then encode their keys in one go.
+            std::size_t row_begin = records.size();
+            row_coords.clear();
+            for (vside_t x = 0; x < width; ++x)
+            {
+                uint64_t source_index = (uint64_t(z) * height + y) * width + x;
+                if (empty(bytes + source_index * stride))
+                    continue;
+
+                row_coords.insert(row_coords.end(), {x, y, z});
+                records.push_back(svo_sort_record_t{0, source_index});
+            }
+            volume_keys(volume, row_coords.data(), records.size() - row_begin, records.data() + row_begin);
+        }
+    });
+
+    std::vector<svo_sort_record_t> records;
+    {
+        std::size_t total = 0;
+        for (const auto& part : thread_records)
+            total += part.size();
+        records.reserve(total);
+        for (auto& part : thread_records)
+        {
+            records.insert(records.end(), part.begin(), part.end());
+            std::vector<svo_sort_record_t>().swap(part);
+        }
+    }
+
+    svo_radix_sort(records, volume_key_bits(volume), num_threads);
+
+    emit_slices(volume, declaration, records, bytes, num_threads);
+}
+
+void svo_import_dense(volume_of_slices_t& volume, const svo_declaration_t& declaration
+                        , std::istream& in, vside_t width, vside_t height, vside_t depth
+                        , std::size_t num_threads, const svo_import_empty_fn_t& is_empty)
+{
+    std::size_t bytes = std::size_t(width) * height * depth * declaration.stride();
+
+    std::vector<uint8_t> data(bytes);
+    in.read(reinterpret_cast<char*>(data.data()), bytes);
+    if (std::size_t(in.gcount()) != bytes)
+        throw std::runtime_error(fmt::format("Truncated voxel grid: expected {} bytes, got {}", bytes, in.gcount()));
+
+    svo_import_dense(volume, declaration, data.data(), width, height, depth, num_threads, is_empty);
+}
+
+
+} //namespace svo
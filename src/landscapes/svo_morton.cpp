@@ -0,0 +1,174 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_TREE
+
+#include "landscapes/svo_morton.hpp"
+#include "landscapes/debug_macro.h"
+
+///the 64 bit pdep/pext only exist on x86-64.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || (defined(__i386__) && !defined(SVO_VCURVE_64)))
+    #define SVO_MORTON_BMI2_GNU 1
+    #include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86) && !defined(SVO_VCURVE_64)))
+    #define SVO_MORTON_BMI2_MSVC 1
+    #include <immintrin.h>
+    #include <intrin.h>
+#endif
+
+namespace svo{
+
+
+#ifdef SVO_VCURVE_64
+
+///the vcurve bits of x; y and z are the same, shifted left by 1 and 2.
+static const vcurve_t MORTON_X_MASK = 0x1249249249249249ULL;
+
+///spreads the low 21 bits of @c v to every third bit.
+static inline vcurve_t part1by2(vcurve_t v)
+{
+    v &= 0x00000000001FFFFFULL;
+    v = (v | (v << 32)) & 0x001F00000000FFFFULL;
+    v = (v | (v << 16)) & 0x001F0000FF0000FFULL;
+    v = (v | (v <<  8)) & 0x100F00F00F00F00FULL;
+    v = (v | (v <<  4)) & 0x10C30C30C30C30C3ULL;
+    v = (v | (v <<  2)) & MORTON_X_MASK;
+    return v;
+}
+
+static inline vside_t compact1by2(vcurve_t v)
+{
+    return vside_t(uninterleave64_3(v));
+}
+
+#else
+
+///the vcurve bits of x; y and z are the same, shifted left by 1 and 2.
+static const vcurve_t MORTON_X_MASK = 0x09249249;
+
+///spreads the low 10 bits of @c v to every third bit.
+static inline vcurve_t part1by2(vcurve_t v)
+{
+    v &= 0x000003FF;
+    v = (v | (v << 16)) & 0xFF0000FF;
+    v = (v | (v <<  8)) & 0x0300F00F;
+    v = (v | (v <<  4)) & 0x030C30C3;
+    v = (v | (v <<  2)) & MORTON_X_MASK;
+    return v;
+}
+
+static inline vside_t compact1by2(vcurve_t v)
+{
+    return uninterleave32_3(v);
+}
+
+#endif
+
+void svo_morton_encode_n_portable(const vside_t* coords, vcurve_t* vcurves, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        vcurves[i] = part1by2(coords[3*i + 0]) | (part1by2(coords[3*i + 1]) << 1) | (part1by2(coords[3*i + 2]) << 2);
+}
+
+void svo_morton_decode_n_portable(const vcurve_t* vcurves, vside_t* coords, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        coords[3*i + 0] = compact1by2(vcurves[i] >> 0);
+        coords[3*i + 1] = compact1by2(vcurves[i] >> 1);
+        coords[3*i + 2] = compact1by2(vcurves[i] >> 2);
+    }
+}
+
+
+#if defined(SVO_MORTON_BMI2_GNU) || defined(SVO_MORTON_BMI2_MSVC)
+
+#ifdef SVO_VCURVE_64
+    #define SVO_MORTON_PDEP _pdep_u64
+    #define SVO_MORTON_PEXT _pext_u64
+#else
+    #define SVO_MORTON_PDEP _pdep_u32
+    #define SVO_MORTON_PEXT _pext_u32
+#endif
+
+///pdep deposits only as many low bits as the mask has, so this masks the coordinates like part1by2().
+#if defined(SVO_MORTON_BMI2_GNU)
+__attribute__((target("bmi2")))
+#endif
+static void encode_n_bmi2(const vside_t* coords, vcurve_t* vcurves, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        vcurves[i] = SVO_MORTON_PDEP(coords[3*i + 0], MORTON_X_MASK)
+                   | SVO_MORTON_PDEP(coords[3*i + 1], MORTON_X_MASK << 1)
+                   | SVO_MORTON_PDEP(coords[3*i + 2], MORTON_X_MASK << 2);
+}
+
+#if defined(SVO_MORTON_BMI2_GNU)
+__attribute__((target("bmi2")))
+#endif
+static void decode_n_bmi2(const vcurve_t* vcurves, vside_t* coords, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        coords[3*i + 0] = vside_t(SVO_MORTON_PEXT(vcurves[i], MORTON_X_MASK));
+        coords[3*i + 1] = vside_t(SVO_MORTON_PEXT(vcurves[i], MORTON_X_MASK << 1));
+        coords[3*i + 2] = vside_t(SVO_MORTON_PEXT(vcurves[i], MORTON_X_MASK << 2));
+    }
+}
+
+static bool detect_bmi2()
+{
+#if defined(SVO_MORTON_BMI2_GNU)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2");
+#else
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 8)) != 0;
+#endif
+}
+
+bool svo_morton_bmi2_available()
+{
+    static const bool available = detect_bmi2();
+    return available;
+}
+
+void svo_morton_encode_n(const vside_t* coords, vcurve_t* vcurves, std::size_t n)
+{
+    if (svo_morton_bmi2_available())
+    {
+        encode_n_bmi2(coords, vcurves, n);
+        return;
+    }
+    svo_morton_encode_n_portable(coords, vcurves, n);
+}
+
+void svo_morton_decode_n(const vcurve_t* vcurves, vside_t* coords, std::size_t n)
+{
+    if (svo_morton_bmi2_available())
+    {
+        decode_n_bmi2(vcurves, coords, n);
+        return;
+    }
+    svo_morton_decode_n_portable(vcurves, coords, n);
+}
+
+#else
+
+bool svo_morton_bmi2_available()
+{
+    return false;
+}
+
+void svo_morton_encode_n(const vside_t* coords, vcurve_t* vcurves, std::size_t n)
+{
+    svo_morton_encode_n_portable(coords, vcurves, n);
+}
+
+void svo_morton_decode_n(const vcurve_t* vcurves, vside_t* coords, std::size_t n)
+{
+    svo_morton_decode_n_portable(vcurves, coords, n);
+}
+
+#endif
+
+
+} //namespace svo
@@ -0,0 +1,414 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SERIALIZATION
+
+#include "landscapes/svo_serialization.codecs.hpp"
+#include "landscapes/svo_buffer.hpp"
+#include "landscapes/debug_macro.h"
+#include "format.h"
+
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cstring>
+#include <cmath>
+#include <cassert>
+
+#include <zlib.h>
+
+namespace svo{
+
+
+svo_element_codec_params_t::svo_element_codec_params_t()
+    : byte_order(svo_byte_order_t::little)
+    , quantize_bits(16)
+    , zlib_level(-1)
+{
+
+}
+
+
+static inline void put_uint32(std::vector<uint8_t>& encoded, uint32_t v)
+{
+    for (std::size_t i = 0; i < 4; ++i)
+        encoded.push_back(uint8_t(v >> ((3 - i)*8)));
+}
+
+static inline uint32_t get_uint32(const uint8_t*& cursor, const uint8_t* end)
+{
+    if (end - cursor < 4)
+        throw std::runtime_error("Truncated element column");
+    uint32_t v = 0;
+    for (std::size_t i = 0; i < 4; ++i)
+        v = (v << 8) | *cursor++;
+    return v;
+}
+
+static inline void put_double(std::vector<uint8_t>& encoded, double v)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    put_uint32(encoded, uint32_t(bits >> 32));
+    put_uint32(encoded, uint32_t(bits));
+}
+
+static inline double get_double(const uint8_t*& cursor, const uint8_t* end)
+{
+    uint64_t bits = uint64_t(get_uint32(cursor, end)) << 32;
+    bits |= get_uint32(cursor, end);
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+
+///copies element @c element_index out of the interleaved buffer, one value after the other.
+static std::vector<uint8_t> gather_column(const svo_cpu_buffer_t& buffer, std::size_t element_index)
+{
+    const auto& declaration = buffer.declaration();
+    std::size_t offset = declaration.offset(element_index);
+    std::size_t element_bytes = declaration.elements()[element_index].bytes();
+    std::size_t stride = declaration.stride();
+
+    std::vector<uint8_t> column(buffer.entries() * element_bytes);
+    for (std::size_t entry_index = 0; entry_index < buffer.entries(); ++entry_index)
+        std::memcpy(&column[entry_index*element_bytes], buffer.rawdata() + entry_index*stride + offset, element_bytes);
+    return column;
+}
+
+static void scatter_column(svo_cpu_buffer_t& buffer, std::size_t element_index, const uint8_t* column)
+{
+    const auto& declaration = buffer.declaration();
+    std::size_t offset = declaration.offset(element_index);
+    std::size_t element_bytes = declaration.elements()[element_index].bytes();
+    std::size_t stride = declaration.stride();
+
+    for (std::size_t entry_index = 0; entry_index < buffer.entries(); ++entry_index)
+        std::memcpy(buffer.rawdata() + entry_index*stride + offset, column + entry_index*element_bytes, element_bytes);
+}
+
+///converts a column of host order values to/from the stream's byte order.
+static inline void column_byte_order(std::vector<uint8_t>& column, const svo_element_t& element, svo_byte_order_t byte_order)
+{
+    if (byte_order != svo_host_byte_order())
+        svo_bswap_bytes(column.data(), element.type_bytes(), column.size() / element.type_bytes());
+}
+
+
+
+static bool encode_palette(const std::vector<uint8_t>& column, const svo_element_t& element
+                            , const svo_element_codec_params_t& params, std::vector<uint8_t>& encoded)
+{
+    std::size_t element_bytes = element.bytes();
+    std::size_t entries = column.size() / element_bytes;
+
+    std::unordered_map<std::string, uint32_t> palette_lookup;
+    std::vector<uint8_t> palette;
+    std::vector<uint32_t> indices(entries);
+
+    for (std::size_t entry_index = 0; entry_index < entries; ++entry_index)
+    {
+        std::string value(reinterpret_cast<const char*>(&column[entry_index*element_bytes]), element_bytes);
+
+        auto w = palette_lookup.find(value);
+        if (w == palette_lookup.end())
+        {
+            if (palette_lookup.size() == (1 << 16))
+                return false;
+            w = palette_lookup.insert(std::make_pair(value, uint32_t(palette_lookup.size()))).first;
+            palette.insert(palette.end(), value.begin(), value.end());
+        }
+        indices[entry_index] = w->second;
+    }
+
+    std::size_t index_bytes = palette_lookup.size() <= (1 << 8) ? 1 : 2;
+
+    ///not worth it if the indices and palette are bigger than the column.
+    if (palette.size() + entries*index_bytes >= column.size())
+        return false;
+
+    column_byte_order(palette, element, params.byte_order);
+
+    put_uint32(encoded, uint32_t(palette_lookup.size()));
+    encoded.push_back(uint8_t(index_bytes));
+    encoded.insert(encoded.end(), palette.begin(), palette.end());
+
+    for (uint32_t index : indices)
+    {
+        if (index_bytes == 1)
+        {
+            encoded.push_back(uint8_t(index));
+        } else {
+            encoded.push_back(uint8_t(index >> 8));
+            encoded.push_back(uint8_t(index));
+        }
+    }
+    return true;
+}
+
+static void decode_palette(std::vector<uint8_t>& column, const svo_element_t& element, svo_byte_order_t byte_order
+                            , const uint8_t* encoded, std::size_t bytes)
+{
+    const uint8_t* cursor = encoded;
+    const uint8_t* end = encoded + bytes;
+
+    std::size_t element_bytes = element.bytes();
+    std::size_t entries = column.size() / element_bytes;
+
+    std::size_t palette_size = get_uint32(cursor, end);
+    if (cursor == end)
+        throw std::runtime_error("Truncated palette");
+    std::size_t index_bytes = *cursor++;
+
+    if (index_bytes != 1 && index_bytes != 2)
+        throw std::runtime_error(fmt::format("Invalid palette index width: {}", index_bytes));
+    if (std::size_t(end - cursor) != palette_size*element_bytes + entries*index_bytes)
+        throw std::runtime_error("Palette column has the wrong size");
+
+    std::vector<uint8_t> palette(cursor, cursor + palette_size*element_bytes);
+    cursor += palette.size();
+    column_byte_order(palette, element, byte_order);
+
+    for (std::size_t entry_index = 0; entry_index < entries; ++entry_index)
+    {
+        std::size_t index = *cursor++;
+        if (index_bytes == 2)
+            index = (index << 8) | *cursor++;
+
+        if (index >= palette_size)
+            throw std::runtime_error(fmt::format("Palette index out of range: {}", index));
+        std::memcpy(&column[entry_index*element_bytes], &palette[index*element_bytes], element_bytes);
+    }
+}
+
+
+
+///returns false, encoding nothing, if the column has values that cannot be quantized: NaN, infinities, or
+/// a range too wide for a double.
+template<typename T>
+static bool encode_quantized(const std::vector<uint8_t>& column, const svo_element_t& element
+                                , uint32_t bits, std::vector<uint8_t>& encoded)
+{
+    assert(bits >= 1 && bits <= 16);
+
+    std::size_t count = element.count();
+    std::size_t entries = column.size() / element.bytes();
+    double levels = double((uint32_t(1) << bits) - 1);
+
+    std::vector<T> values(entries*count);
+    std::memcpy(values.data(), column.data(), column.size());
+
+    std::vector<double> minimums(count, std::numeric_limits<double>::max());
+    std::vector<double> maximums(count, std::numeric_limits<double>::lowest());
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        if (!std::isfinite(values[i]))
+            return false;
+        minimums[i % count] = std::min(minimums[i % count], double(values[i]));
+        maximums[i % count] = std::max(maximums[i % count], double(values[i]));
+    }
+
+    for (std::size_t component = 0; component < count; ++component)
+    {
+        if (entries == 0)
+            minimums[component] = maximums[component] = 0;
+        if (!std::isfinite(maximums[component] - minimums[component]))
+            return false;
+    }
+
+    encoded.push_back(uint8_t(bits));
+    for (std::size_t component = 0; component < count; ++component)
+    {
+        put_double(encoded, minimums[component]);
+        put_double(encoded, maximums[component]);
+    }
+
+    ///the values are packed @c bits at a time, most significant bit first.
+    uint64_t pending = 0;
+    uint32_t pending_bits = 0;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        double range = maximums[i % count] - minimums[i % count];
+        double t = range > 0 ? (double(values[i]) - minimums[i % count]) / range : 0;
+        t = std::min(std::max(t, 0.0), 1.0);
+        uint32_t q = uint32_t(std::lround(t * levels));
+
+        pending = (pending << bits) | q;
+        pending_bits += bits;
+        while (pending_bits >= 8)
+        {
+            pending_bits -= 8;
+            encoded.push_back(uint8_t(pending >> pending_bits));
+        }
+    }
+    if (pending_bits > 0)
+        encoded.push_back(uint8_t(pending << (8 - pending_bits)));
+    return true;
+}
+
+template<typename T>
+static void decode_quantized(std::vector<uint8_t>& column, const svo_element_t& element
+                                , const uint8_t* encoded, std::size_t bytes)
+{
+    const uint8_t* cursor = encoded;
+    const uint8_t* end = encoded + bytes;
+
+    std::size_t count = element.count();
+    std::size_t entries = column.size() / element.bytes();
+
+    if (cursor == end)
+        throw std::runtime_error("Truncated quantized column");
+    uint32_t bits = *cursor++;
+    if (bits < 1 || bits > 16)
+        throw std::runtime_error(fmt::format("Invalid quantization bits: {}", bits));
+    double levels = double((uint32_t(1) << bits) - 1);
+
+    std::vector<double> minimums(count), scales(count);
+    for (std::size_t component = 0; component < count; ++component)
+    {
+        minimums[component] = get_double(cursor, end);
+        double maximum = get_double(cursor, end);
+
+        ///the decoded values lie between the two, so they fit in @c T if the bounds do.
+        if (!(minimums[component] <= maximum)
+            || minimums[component] < double(std::numeric_limits<T>::lowest())
+            || maximum > double(std::numeric_limits<T>::max())
+            || !std::isfinite(maximum - minimums[component]))
+            throw std::runtime_error(fmt::format("Invalid quantization range: [{}, {}]", minimums[component], maximum));
+        scales[component] = (maximum - minimums[component]) / levels;
+    }
+
+    std::size_t values_count = entries*count;
+    if (std::size_t(end - cursor) != (values_count*bits + 7) / 8)
+        throw std::runtime_error("Quantized column has the wrong size");
+
+    uint32_t mask = (uint32_t(1) << bits) - 1;
+    uint64_t pending = 0;
+    uint32_t pending_bits = 0;
+    std::vector<T> values(values_count);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        while (pending_bits < bits)
+        {
+            pending = (pending << 8) | *cursor++;
+            pending_bits += 8;
+        }
+        pending_bits -= bits;
+        uint32_t q = uint32_t(pending >> pending_bits) & mask;
+
+        values[i] = T(minimums[i % count] + q * scales[i % count]);
+    }
+    std::memcpy(column.data(), values.data(), column.size());
+}
+
+
+
+static void encode_zlib(const std::vector<uint8_t>& column, int level, std::vector<uint8_t>& encoded)
+{
+    uLongf compressed_bytes = compressBound(uLong(column.size()));
+    std::size_t begin = encoded.size();
+    encoded.resize(begin + compressed_bytes);
+
+    int result = compress2(&encoded[begin], &compressed_bytes, column.data(), uLong(column.size()), level);
+    if (result != Z_OK)
+        throw std::runtime_error(fmt::format("zlib compress2() failed: {}", result));
+    encoded.resize(begin + compressed_bytes);
+}
+
+static void decode_zlib(std::vector<uint8_t>& column, const uint8_t* encoded, std::size_t bytes)
+{
+    uLongf column_bytes = uLongf(column.size());
+    int result = uncompress(column.data(), &column_bytes, encoded, uLong(bytes));
+    if (result != Z_OK || column_bytes != column.size())
+        throw std::runtime_error(fmt::format("zlib uncompress() failed: {}", result));
+}
+
+
+
+
+svo_element_codec_t svo_encode_element(const svo_cpu_buffer_t& buffer, std::size_t element_index
+                                        , svo_element_codec_t codec, const svo_element_codec_params_t& params
+                                        , std::vector<uint8_t>& encoded)
+{
+    const auto& element = buffer.declaration().elements().at(element_index);
+
+    std::vector<uint8_t> column = gather_column(buffer, element_index);
+
+    switch (codec)
+    {
+        case svo_element_codec_t::none:
+            break;
+        case svo_element_codec_t::palette:
+        {
+            std::size_t begin = encoded.size();
+            if (encode_palette(column, element, params, encoded))
+                return codec;
+            encoded.resize(begin);
+            break;
+        }
+        case svo_element_codec_t::quantize:
+        {
+            if (params.quantize_bits < 1 || params.quantize_bits > 16)
+                throw std::runtime_error(fmt::format("Invalid quantization bits: {}", params.quantize_bits));
+
+            std::size_t begin = encoded.size();
+            if (element.type() == svo_data_type_t::FLOAT && encode_quantized<float>(column, element, params.quantize_bits, encoded))
+                return codec;
+            if (element.type() == svo_data_type_t::DOUBLE && encode_quantized<double>(column, element, params.quantize_bits, encoded))
+                return codec;
+            encoded.resize(begin);
+            break;
+        }
+        case svo_element_codec_t::zlib:
+        {
+            column_byte_order(column, element, params.byte_order);
+            encode_zlib(column, params.zlib_level, encoded);
+            return codec;
+        }
+    }
+
+    column_byte_order(column, element, params.byte_order);
+    encoded.insert(encoded.end(), column.begin(), column.end());
+    return svo_element_codec_t::none;
+}
+
+void svo_decode_element(svo_cpu_buffer_t& buffer, std::size_t element_index
+                        , svo_element_codec_t codec, svo_byte_order_t byte_order
+                        , const uint8_t* encoded, std::size_t bytes)
+{
+    const auto& element = buffer.declaration().elements().at(element_index);
+
+    std::vector<uint8_t> column(buffer.entries() * element.bytes());
+
+    switch (codec)
+    {
+        case svo_element_codec_t::none:
+            if (bytes != column.size())
+                throw std::runtime_error("Element column has the wrong size");
+            std::copy(encoded, encoded + bytes, column.begin());
+            column_byte_order(column, element, byte_order);
+            break;
+        case svo_element_codec_t::palette:
+            decode_palette(column, element, byte_order, encoded, bytes);
+            break;
+        case svo_element_codec_t::quantize:
+            if (element.type() == svo_data_type_t::FLOAT)
+                decode_quantized<float>(column, element, encoded, bytes);
+            else if (element.type() == svo_data_type_t::DOUBLE)
+                decode_quantized<double>(column, element, encoded, bytes);
+            else
+                throw std::runtime_error(fmt::format("Cannot dequantize element of type {}", tostr(element.type())));
+            break;
+        case svo_element_codec_t::zlib:
+            decode_zlib(column, encoded, bytes);
+            column_byte_order(column, element, byte_order);
+            break;
+        default:
+            throw std::runtime_error(fmt::format("Invalid element codec: {}", int(codec)));
+    }
+
+    scatter_column(buffer, element_index, column.data());
+}
+
+
+} //namespace svo
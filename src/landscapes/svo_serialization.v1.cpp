@@ -1,21 +1,21 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SERIALIZATION
 
 #include "landscapes/svo_serialization.v1.hpp"
+#include "landscapes/svo_serialization.v2.hpp"
+#include "landscapes/svo_serialization.detail.hpp"
 #include "landscapes/svo_tree.hpp"
 #include "landscapes/svo_tree.sanity.hpp"
+#include "landscapes/debug_macro.h"
 
 #include <iostream>
+#include <limits>
 
 namespace svo{
 
 
 static const int FORMAT_VERSION = 1;
 
-template<typename T>
-static inline void serialize_uint(std::ostream& out, T v);
 void serialize_string(std::ostream& out, const std::string& v);
-
-template<typename T>
-static inline T unserialize_uint(std::istream& in);
 std::string unserialize_string(std::istream& in);
 
 
@@ -40,49 +40,12 @@ std::string unserialize_string(std::istream& in)
     std::string v;
     v.resize(size);
     in.read(&v[0], v.size());
-    assert(in.gcount() == size);
+    if (std::size_t(in.gcount()) != size)
+        throw std::runtime_error(fmt::format("Truncated string: expected {} bytes, got {}", size, in.gcount()));
     
     return v;
 }
 
-template<typename T>
-static inline void serialize_uint(std::ostream& out, T v)
-{
-    T bmask = 255;
-
-    uint8_t buffer[sizeof(T)];
-
-
-    for (std::size_t i = 0; i < sizeof(T); ++i)
-    {
-        uint8_t byte = (v >> (i*8)) & bmask;
-
-        //buffer[ i ] = byte;
-        buffer[ sizeof(T) - 1 - i ] = byte;
-    }
-
-    out.write(reinterpret_cast<char*>(&buffer[0]),sizeof(T));
-}
-
-
-template<typename T>
-static inline T unserialize_uint(std::istream& in)
-{
-    uint8_t buffer[sizeof(T)];
-    in.read(reinterpret_cast<char*>(&buffer[0]), sizeof(T));
-    assert(in.gcount() == sizeof(T));
-
-    T v = 0;
-    for (std::size_t i = 0; i < sizeof(T); ++i)
-    {
-        //uint8_t byte = buffer[i];
-        uint8_t byte = buffer[sizeof(T) - 1 - i];
-
-        v |= T(byte) << (i*8);
-    }
-    return v;
-}
-
 void serialize_slice_child_info(std::ostream& out, const svo_slice_t* slice)
 {
     assert(slice);
@@ -100,7 +63,7 @@ void serialize_slice_child_info(std::ostream& out, const svo_slice_t* slice)
         svo_slice_t* child = (*slice->children)[i];
         assert(child);
         serialize_uint<uint32_t>(out, uint32_t(child->side));
-        serialize_uint<uint32_t>(out, uint32_t(child->parent_vcurve_begin));
+        serialize_vcurve(out, child->parent_vcurve_begin, slice->side);
     }
 }
 
@@ -120,13 +83,15 @@ void serialize_slice(std::ostream& out, const svo_slice_t* slice)
     const auto& pos_data = *slice->pos_data;
     const auto& buffers = *slice->buffers;
 
+    if (pos_data.size() > std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error(fmt::format("Too many voxels to serialize: {}", pos_data.size()));
     serialize_uint<uint32_t>(out, uint32_t(pos_data.size()));
 
     ///output voxel coordinates
     for (std::size_t i = 0; i < pos_data.size(); ++i)
     {
         vcurve_t vcurve = pos_data[i];
-        serialize_uint<uint32_t>(out, uint32_t(vcurve));
+        serialize_vcurve(out, vcurve, slice->side);
     }
 
     
@@ -228,7 +193,8 @@ void unserialize_buffer_data(std::istream& in, svo_cpu_buffer_t& buffer, std::si
     assert(buffer.entries() == expected_entries);
     
     in.read(reinterpret_cast<char*>(buffer.rawdata()), buffer.bytes());
-    assert(in.gcount() == buffer.bytes());
+    if (std::size_t(in.gcount()) != buffer.bytes())
+        throw std::runtime_error(fmt::format("Truncated buffer data: expected {} bytes, got {}", buffer.bytes(), in.gcount()));
 }
 
 void serialize_buffers(std::ostream& out, const svo_cpu_buffers_t& buffers, std::size_t expected_entries)
@@ -281,16 +247,27 @@ children_params_t unserialize_slice_child_info(std::istream& in, svo_slice_t* sl
     assert(slice);
     assert(slice->children);
 
+    auto is_valid_side = [](uint32_t side){ return side > 0 && side <= SVO_VSIDE_LIMIT && (side & (side - 1)) == 0; };
+
     auto slice_side = unserialize_uint<uint32_t>(in);
     auto children_count = unserialize_uint<uint32_t>(in);
-    
+
+    if (!is_valid_side(slice_side))
+        throw std::runtime_error(fmt::format("Invalid slice side: {}", slice_side));
+    ///each child covers at least one voxel of this slice.
+    if (children_count > vcurvesize(slice_side))
+        throw std::runtime_error(fmt::format("Invalid children count: {}", children_count));
+
     slice->side = slice_side;
 
     children_params_t children_params;
     for (uint32_t i = 0; i < children_count; ++i)
     {
         auto child_side = unserialize_uint<uint32_t>(in);
-        uint32_t child_parent_vcurve_begin = unserialize_uint<uint32_t>(in);
+        vcurve_t child_parent_vcurve_begin = unserialize_vcurve(in, slice_side);
+
+        if (!is_valid_side(child_side) || child_parent_vcurve_begin >= vcurvesize(slice_side))
+            throw std::runtime_error(fmt::format("Invalid child: side {}, parent_vcurve_begin {}", child_side, child_parent_vcurve_begin));
 
         children_params.push_back(std::make_tuple(child_side, child_parent_vcurve_begin));
     }
@@ -312,14 +289,21 @@ void slice_load_empty_children(svo_slice_t* slice, const children_params_t& chil
         child_slice->side = child_side;
         child_slice->parent_vcurve_begin = child_parent_vcurve_begin;
 
+        for (const auto& declaration : slice->buffers->schema())
+            child_slice->buffers->add_buffer(declaration, 0);
+
         slice->children->push_back(child_slice);
 
 
         ///todo: make this an exception or return error code.
-        if(auto error = svo_slice_sanity(child_slice))
-        {
-            std::cerr << error << std::endl;
-            assert(false && "sanity fail");
+        DEBUG_CHEAP {
+            ///the cheap tier only checks the slice itself, not its parent/children.
+            auto sanity_type = SVO_MODULE_CHECK_LEVEL >= SVO_CHECK_FULL ? svo_sanity_type_t::default_sanity : svo_sanity_type_t::minimal;
+            if(auto error = svo_slice_sanity(child_slice, sanity_type))
+            {
+                std::cerr << error << std::endl;
+                assert(false && "sanity fail");
+            }
         }
     }
 }
@@ -341,37 +325,49 @@ children_params_t unserialize_slice(std::istream& in, svo_slice_t* slice, bool l
     
     uint32_t format_version = unserialize_uint<uint32_t>(in);
     
-    ///todo: make this a runtime error
-    assert(format_version == FORMAT_VERSION);
+    ///v2 streams start with the same version word, so they can be loaded through here too.
+    if (is_v2_format_version(format_version))
+        return unserialize_slice_v2_body(in, format_version, slice, load_empty_children);
 
+    if (format_version != uint32_t(FORMAT_VERSION))
+        throw std::runtime_error(fmt::format("Unsupported slice format version: {}", format_version));
 
-    auto children_params = unserialize_slice_child_info(in, slice);
 
-    if (load_empty_children)
-    {
-        slice_load_empty_children(slice, children_params);
-    }
+    auto children_params = unserialize_slice_child_info(in, slice);
 
     auto data_size = unserialize_uint<uint32_t>(in);
+    if (data_size > vcurvesize(slice->side))
+        throw std::runtime_error(fmt::format("Invalid pos_data entries: {}, the slice only has {} voxels"
+                                            , data_size, vcurvesize(slice->side)));
     pos_data.reserve(data_size);
     
     ///unseralized position data
     for (uint32_t data_index = 0; data_index < data_size; ++data_index)
     {
-        uint32_t vcurve = unserialize_uint<uint32_t>(in);
+        vcurve_t vcurve = unserialize_vcurve(in, slice->side);
         pos_data.push_back( vcurve );
     }
 
 
     ///unserialize buffer data
     unserialize_buffers(in, buffers, data_size);
+
+    ///after the buffers, so the empty children can share their schema.
+    if (load_empty_children)
+    {
+        slice_load_empty_children(slice, children_params);
+    }
     
 
     ///todo: make this an exception or return error code.
-    if(auto error = svo_slice_sanity(slice))
-    {
-        std::cerr << error << std::endl;
-        assert(false && "sanity fail");
+    DEBUG_CHEAP {
+        ///the cheap tier only checks the slice itself, not its parent/children.
+        auto sanity_type = SVO_MODULE_CHECK_LEVEL >= SVO_CHECK_FULL ? svo_sanity_type_t::default_sanity : svo_sanity_type_t::minimal;
+        if(auto error = svo_slice_sanity(slice, sanity_type))
+        {
+            std::cerr << error << std::endl;
+            assert(false && "sanity fail");
+        }
     }
 
     return children_params;
@@ -0,0 +1,877 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SERIALIZATION
+
+#include "landscapes/svo_serialization.v2.hpp"
+#include "landscapes/svo_serialization.detail.hpp"
+#include "landscapes/svo_crc32c.hpp"
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_tree.sanity.hpp"
+#include "landscapes/debug_macro.h"
+#include "format.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+namespace svo{
+
+
+static const uint32_t FORMAT_VERSION = 2;
+static const uint32_t FORMAT_VERSION_CHECKSUMMED = 3;
+
+svo_serialization_options_t::svo_serialization_options_t()
+    : byte_order(svo_byte_order_t::little)
+    , pos_encoding(svo_pos_encoding_t::raw)
+    , buffer_layout(svo_buffer_layout_t::interleaved)
+    , checksums(true)
+    , quantize_bits(svo_element_codec_params_t().quantize_bits)
+    , zlib_level(svo_element_codec_params_t().zlib_level)
+{
+
+}
+
+
+static inline void serialize_byte_order(std::ostream& out, svo_byte_order_t byte_order)
+{
+    serialize_uint<uint8_t>(out, byte_order == svo_byte_order_t::little ? 0 : 1);
+}
+
+static inline svo_byte_order_t unserialize_byte_order(std::istream& in)
+{
+    auto byte_order = unserialize_uint<uint8_t>(in);
+    if (byte_order > 1)
+        throw std::runtime_error(fmt::format("Invalid byte order: {}", uint32_t(byte_order)));
+    return byte_order == 0 ? svo_byte_order_t::little : svo_byte_order_t::big;
+}
+
+static inline void serialize_pos_encoding(std::ostream& out, svo_pos_encoding_t pos_encoding)
+{
+    serialize_uint<uint8_t>(out, uint8_t(pos_encoding));
+}
+
+static inline svo_pos_encoding_t unserialize_pos_encoding(std::istream& in)
+{
+    auto pos_encoding = unserialize_uint<uint8_t>(in);
+    if (pos_encoding > uint8_t(svo_pos_encoding_t::delta_varint))
+        throw std::runtime_error(fmt::format("Invalid pos_data encoding: {}", uint32_t(pos_encoding)));
+    return svo_pos_encoding_t(pos_encoding);
+}
+
+
+svo_slice_load_filter_t::svo_slice_load_filter_t()
+    : all_elements(true)
+{
+
+}
+
+svo_slice_load_filter_t svo_slice_load_filter_t::positions_only()
+{
+    return only(std::set<std::string>());
+}
+
+svo_slice_load_filter_t svo_slice_load_filter_t::only(const std::set<std::string>& element_names)
+{
+    svo_slice_load_filter_t filter;
+    filter.all_elements = false;
+    filter.elements = element_names;
+    return filter;
+}
+
+bool svo_slice_load_filter_t::selects(const svo_element_t& element) const
+{
+    return all_elements || elements.count(element.name()) > 0;
+}
+
+svo_declaration_t svo_slice_load_filter_t::select(const svo_declaration_t& declaration) const
+{
+    if (all_elements)
+        return declaration;
+
+    svo_declaration_t selected;
+    for (const auto& element : declaration.elements())
+    {
+        if (selects(element))
+            selected.add(element);
+    }
+    return selected;
+}
+
+static inline void read_bulk(std::istream& in, uint8_t* data, std::size_t bytes)
+{
+    in.read(reinterpret_cast<char*>(data), bytes);
+    if (std::size_t(in.gcount()) != bytes)
+        throw std::runtime_error(fmt::format("Truncated payload: expected {} bytes, got {}", bytes, in.gcount()));
+}
+
+///reads @c count items into @c data a chunk at a time, so that a corrupt count runs into the end of the
+/// stream instead of allocating all of it up front.
+template<typename T, typename allocator_t>
+static inline void read_bulk_chunked(std::istream& in, std::vector<T, allocator_t>& data, std::size_t count)
+{
+    static const std::size_t CHUNK_SIZE = (1 << 20) / sizeof(T);
+
+    data.clear();
+    while (data.size() < count)
+    {
+        std::size_t offset = data.size();
+        std::size_t chunk = std::min(CHUNK_SIZE, count - offset);
+        data.resize(offset + chunk);
+        read_bulk(in, reinterpret_cast<uint8_t*>(data.data() + offset), chunk*sizeof(T));
+    }
+}
+
+///skips a payload that is not being loaded; a seek, where the stream supports it.
+static inline void skip_bulk(std::istream& in, std::size_t bytes)
+{
+    if (!in.seekg(std::streamoff(bytes), std::ios::cur))
+        throw std::runtime_error(fmt::format("Truncated payload: could not skip {} bytes", bytes));
+}
+
+
+
+
+///writes the vcurves as words of @c word_t, converting from vcurve_t.
+template<typename word_t>
+static inline void serialize_pos_words(std::ostream& out, const std::vector<vcurve_t>& pos_data, svo_byte_order_t byte_order)
+{
+    std::vector<word_t> words(pos_data.begin(), pos_data.end());
+    if (byte_order != svo_host_byte_order())
+        svo_bswap_n(words.data(), words.size());
+    out.write(reinterpret_cast<const char*>(words.data()), words.size()*sizeof(word_t));
+}
+
+template<typename word_t>
+static inline void unserialize_pos_words(std::istream& in, std::vector<vcurve_t>& pos_data, std::size_t entries, svo_byte_order_t byte_order)
+{
+    std::vector<word_t> words;
+    read_bulk_chunked(in, words, entries);
+    if (byte_order != svo_host_byte_order())
+        svo_bswap_n(words.data(), words.size());
+    pos_data.assign(words.begin(), words.end());
+}
+
+void serialize_pos_data_bulk(std::ostream& out, const std::vector<vcurve_t>& pos_data, vside_t side, svo_byte_order_t byte_order)
+{
+    std::size_t word_bytes = svo_vcurve_bytes(side);
+    if (word_bytes != sizeof(vcurve_t))
+    {
+        if (word_bytes == 4)
+            serialize_pos_words<uint32_t>(out, pos_data, byte_order);
+        else
+            serialize_pos_words<uint64_t>(out, pos_data, byte_order);
+        return;
+    }
+
+    if (byte_order == svo_host_byte_order())
+    {
+        out.write(reinterpret_cast<const char*>(pos_data.data()), pos_data.size()*sizeof(vcurve_t));
+        return;
+    }
+
+    std::vector<vcurve_t> swapped(pos_data);
+    svo_bswap_n(swapped.data(), swapped.size());
+    out.write(reinterpret_cast<const char*>(swapped.data()), swapped.size()*sizeof(vcurve_t));
+}
+
+void unserialize_pos_data_bulk(std::istream& in, std::vector<vcurve_t>& pos_data, std::size_t entries, vside_t side, svo_byte_order_t byte_order)
+{
+    assert(pos_data.size() == 0);
+
+    std::size_t word_bytes = svo_vcurve_bytes(side);
+    if (word_bytes != sizeof(vcurve_t))
+    {
+        if (word_bytes == 4)
+            unserialize_pos_words<uint32_t>(in, pos_data, entries, byte_order);
+        else
+            throw std::runtime_error(fmt::format("Slice side {} needs 64 bit vcurves; rebuild with SVO_VCURVE_64", side));
+        return;
+    }
+
+    ///@c entries is only bounded by the side, which allows far more than the stream may hold.
+    read_bulk_chunked(in, pos_data, entries);
+
+    if (byte_order != svo_host_byte_order())
+        svo_bswap_n(pos_data.data(), pos_data.size());
+}
+
+
+///the longest varint of a 64 bit value.
+static const std::size_t MAX_VARINT_BYTES = 10;
+
+static inline void encode_varint(std::vector<uint8_t>& encoded, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        encoded.push_back(uint8_t(v) | 0x80);
+        v >>= 7;
+    }
+    encoded.push_back(uint8_t(v));
+}
+
+static inline uint64_t decode_varint(const uint8_t*& cursor, const uint8_t* end)
+{
+    ///fast path, most tokens of a sorted slice are a single byte.
+    if (cursor < end && *cursor < 0x80)
+        return *cursor++;
+
+    uint64_t v = 0;
+    for (std::size_t shift = 0; shift < 64; shift += 7)
+    {
+        if (cursor == end)
+            throw std::runtime_error("Truncated varint in pos_data");
+        uint8_t byte = *cursor++;
+        v |= uint64_t(byte & 0x7F) << shift;
+        if (byte < 0x80)
+            return v;
+    }
+    throw std::runtime_error("Overlong varint in pos_data");
+}
+
+void svo_encode_pos_data_delta(const std::vector<vcurve_t>& pos_data, std::vector<uint8_t>& encoded)
+{
+    ///the next vcurve a run could continue from.
+    uint64_t next = 0;
+
+    std::size_t i = 0;
+    while (i < pos_data.size())
+    {
+        uint64_t begin = pos_data[i];
+        assert(begin >= next && "pos_data must be sorted and unique");
+
+        std::size_t length = 1;
+        while (i + length < pos_data.size() && uint64_t(pos_data[i + length]) == begin + length)
+            ++length;
+
+        uint64_t gap = begin - next;
+        encode_varint(encoded, (gap << 1) | (length > 1 ? 1 : 0));
+        if (length > 1)
+            encode_varint(encoded, length - 2);
+
+        next = begin + length;
+        i += length;
+    }
+}
+
+void svo_decode_pos_data_delta(const uint8_t* encoded, std::size_t bytes, std::size_t entries, vside_t side
+                                , std::vector<vcurve_t>& pos_data)
+{
+    uint64_t vcurve_end = uint64_t(vcurvesize(side));
+
+    const uint8_t* cursor = encoded;
+    const uint8_t* end = encoded + bytes;
+
+    std::size_t first = pos_data.size();
+    pos_data.resize(first + entries);
+    vcurve_t* out = pos_data.data() + first;
+    vcurve_t* out_end = out + entries;
+
+    uint64_t next = 0;
+    while (out < out_end)
+    {
+        uint64_t token = decode_varint(cursor, end);
+        uint64_t length = 1;
+        if (token & 1)
+        {
+            uint64_t extra_length = decode_varint(cursor, end);
+            if (extra_length > uint64_t(out_end - out))
+                throw std::runtime_error("pos_data run overflows the declared entries");
+            length = extra_length + 2;
+        }
+        uint64_t gap = token >> 1;
+
+        if (length > uint64_t(out_end - out))
+            throw std::runtime_error("pos_data run overflows the declared entries");
+        ///@c next never exceeds @c vcurve_end, so none of this wraps.
+        if (gap > vcurve_end - next || length > vcurve_end - next - gap)
+            throw std::runtime_error(fmt::format("pos_data run overflows the slice, of side {}", side));
+        uint64_t begin = next + gap;
+
+        ///solid runs are a plain fill, which vectorizes.
+        vcurve_t value = vcurve_t(begin);
+        for (uint64_t j = 0; j < length; ++j)
+            out[j] = value + vcurve_t(j);
+
+        out += length;
+        next = begin + length;
+    }
+
+    if (cursor != end)
+        throw std::runtime_error("Trailing bytes after pos_data");
+}
+
+static inline void serialize_pos_data(std::ostream& out, const std::vector<vcurve_t>& pos_data, vside_t side
+                                        , const svo_serialization_options_t& options)
+{
+    if (pos_data.size() > std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error(fmt::format("Too many voxels to serialize: {}", pos_data.size()));
+    serialize_uint<uint32_t>(out, uint32_t(pos_data.size()));
+
+    switch (options.pos_encoding)
+    {
+        case svo_pos_encoding_t::raw:
+            serialize_pos_data_bulk(out, pos_data, side, options.byte_order);
+            return;
+        case svo_pos_encoding_t::delta_varint:
+        {
+            std::vector<uint8_t> encoded;
+            encoded.reserve(pos_data.size() + 16);
+            svo_encode_pos_data_delta(pos_data, encoded);
+
+            serialize_uint<uint32_t>(out, uint32_t(encoded.size()));
+            out.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+            return;
+        }
+    }
+    assert(false && "unknown pos_data encoding");
+}
+
+static inline std::size_t unserialize_pos_data(std::istream& in, std::vector<vcurve_t>& pos_data
+                                                , svo_pos_encoding_t pos_encoding, svo_byte_order_t byte_order
+                                                , vside_t side)
+{
+    std::size_t max_entries = vcurvesize(side);
+    std::size_t entries = unserialize_uint<uint32_t>(in);
+    if (entries > max_entries)
+        throw std::runtime_error(fmt::format("Invalid pos_data entries: {}, the slice only has {} voxels", entries, max_entries));
+
+    switch (pos_encoding)
+    {
+        case svo_pos_encoding_t::raw:
+            unserialize_pos_data_bulk(in, pos_data, entries, side, byte_order);
+            return entries;
+        case svo_pos_encoding_t::delta_varint:
+        {
+            std::size_t bytes = unserialize_uint<uint32_t>(in);
+            ///every run costs at most two varints, and all but single voxel runs cover two entries or more.
+            if (uint64_t(bytes) > uint64_t(entries)*MAX_VARINT_BYTES)
+                throw std::runtime_error(fmt::format("Invalid encoded pos_data size: {} bytes for {} entries", bytes, entries));
+
+            std::vector<uint8_t> encoded;
+            read_bulk_chunked(in, encoded, bytes);
+
+            assert(pos_data.size() == 0);
+            svo_decode_pos_data_delta(encoded.data(), encoded.size(), entries, side, pos_data);
+            return entries;
+        }
+    }
+    assert(false && "unknown pos_data encoding");
+    return entries;
+}
+
+
+
+void svo_bswap_buffer(svo_cpu_buffer_t& buffer)
+{
+    const auto& declaration = buffer.declaration();
+    const auto& elements = declaration.elements();
+    std::size_t stride = declaration.stride();
+
+    for (std::size_t element_index = 0; element_index < elements.size(); ++element_index)
+    {
+        const auto& element = elements[element_index];
+        if (element.type_bytes() == 1)
+            continue;
+
+        std::size_t offset = declaration.offset(element_index);
+        uint8_t* data = buffer.rawdata() + offset;
+        for (std::size_t entry_index = 0; entry_index < buffer.entries(); ++entry_index)
+        {
+            svo_bswap_bytes(data + entry_index*stride, element.type_bytes(), element.count());
+        }
+    }
+}
+
+void serialize_buffer_data_bulk(std::ostream& out, const svo_cpu_buffer_t& buffer, svo_byte_order_t byte_order)
+{
+    if (byte_order == svo_host_byte_order())
+    {
+        serialize_buffer_data(out, buffer);
+        return;
+    }
+
+    svo_cpu_buffer_t swapped(buffer.declaration(), buffer.entries());
+    std::memcpy(swapped.rawdata(), buffer.rawdata(), buffer.bytes());
+    svo_bswap_buffer(swapped);
+    serialize_buffer_data(out, swapped);
+}
+
+void unserialize_buffer_data_bulk(std::istream& in, svo_cpu_buffer_t& buffer, svo_byte_order_t byte_order)
+{
+    read_bulk(in, buffer.rawdata(), buffer.bytes());
+
+    if (byte_order != svo_host_byte_order())
+        svo_bswap_buffer(buffer);
+}
+
+
+static inline svo_element_codec_t element_codec(const svo_serialization_options_t& options, const svo_element_t& element)
+{
+    auto w = options.element_codecs.find(element.name());
+    if (w == options.element_codecs.end())
+        return svo_element_codec_t::none;
+    return w->second;
+}
+
+static void serialize_buffer_payload(std::ostream& out, const svo_cpu_buffer_t& buffer, const svo_serialization_options_t& options)
+{
+    const auto& elements = buffer.declaration().elements();
+
+    bool has_codecs = std::any_of(elements.begin(), elements.end()
+                                    , [&options](const svo_element_t& element){
+                                        return element_codec(options, element) != svo_element_codec_t::none;
+                                    });
+
+    if (!has_codecs && options.buffer_layout == svo_buffer_layout_t::interleaved)
+    {
+        serialize_uint<uint8_t>(out, uint8_t(svo_buffer_layout_t::interleaved));
+        serialize_buffer_data_bulk(out, buffer, options.byte_order);
+        return;
+    }
+
+    svo_element_codec_params_t params;
+    params.byte_order = options.byte_order;
+    params.quantize_bits = options.quantize_bits;
+    params.zlib_level = options.zlib_level;
+
+    serialize_uint<uint8_t>(out, uint8_t(svo_buffer_layout_t::columns));
+
+    std::vector<uint8_t> encoded;
+    for (std::size_t element_index = 0; element_index < elements.size(); ++element_index)
+    {
+        encoded.clear();
+        auto codec = svo_encode_element(buffer, element_index, element_codec(options, elements[element_index]), params, encoded);
+
+        serialize_uint<uint8_t>(out, uint8_t(codec));
+        serialize_uint<uint32_t>(out, uint32_t(encoded.size()));
+        out.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+    }
+}
+
+/**
+ * Loads a buffer's payload, stored with the full @c declaration, into @c buffer, whose declaration is
+ *  @c declaration narrowed by @c filter.
+ */
+static void unserialize_buffer_payload(std::istream& in, const svo_declaration_t& declaration, svo_cpu_buffer_t& buffer
+                                        , svo_byte_order_t byte_order, const svo_slice_load_filter_t& filter)
+{
+    auto layout = unserialize_uint<uint8_t>(in);
+    const auto& elements = declaration.elements();
+
+    if (layout == uint8_t(svo_buffer_layout_t::interleaved))
+    {
+        if (buffer.declaration() == declaration)
+        {
+            unserialize_buffer_data_bulk(in, buffer, byte_order);
+            return;
+        }
+
+        ///the entries are interleaved, so the whole payload has to be read; then keep the selected elements.
+        svo_cpu_buffer_t full(declaration, buffer.entries());
+        unserialize_buffer_data_bulk(in, full, byte_order);
+
+        std::size_t dst_element_index = 0;
+        for (std::size_t element_index = 0; element_index < elements.size(); ++element_index)
+        {
+            if (!filter.selects(elements[element_index]))
+                continue;
+
+            std::size_t element_bytes = elements[element_index].bytes();
+            const uint8_t* src = full.rawdata() + declaration.offset(element_index);
+            uint8_t* dst = buffer.rawdata() + buffer.declaration().offset(dst_element_index);
+            for (std::size_t entry_index = 0; entry_index < buffer.entries(); ++entry_index)
+                std::memcpy(dst + entry_index*buffer.stride(), src + entry_index*full.stride(), element_bytes);
+
+            ++dst_element_index;
+        }
+        return;
+    }
+    if (layout != uint8_t(svo_buffer_layout_t::columns))
+        throw std::runtime_error(fmt::format("Invalid buffer layout: {}", uint32_t(layout)));
+
+    std::vector<uint8_t> encoded;
+    std::size_t dst_element_index = 0;
+    for (std::size_t element_index = 0; element_index < elements.size(); ++element_index)
+    {
+        auto codec = unserialize_uint<uint8_t>(in);
+        if (codec > uint8_t(svo_element_codec_t::zlib))
+            throw std::runtime_error(fmt::format("Invalid element codec: {}", uint32_t(codec)));
+
+        std::size_t bytes = unserialize_uint<uint32_t>(in);
+
+        if (!filter.selects(elements[element_index]))
+        {
+            skip_bulk(in, bytes);
+            continue;
+        }
+
+        read_bulk_chunked(in, encoded, bytes);
+
+        svo_decode_element(buffer, dst_element_index, svo_element_codec_t(codec), byte_order, encoded.data(), encoded.size());
+        ++dst_element_index;
+    }
+}
+
+///skips a buffer's payload entirely, seeking past the raw data or each of the columns.
+static void skip_buffer_payload(std::istream& in, const svo_declaration_t& declaration, std::size_t entries)
+{
+    auto layout = unserialize_uint<uint8_t>(in);
+
+    if (layout == uint8_t(svo_buffer_layout_t::interleaved))
+    {
+        skip_bulk(in, entries * declaration.stride());
+        return;
+    }
+    if (layout != uint8_t(svo_buffer_layout_t::columns))
+        throw std::runtime_error(fmt::format("Invalid buffer layout: {}", uint32_t(layout)));
+
+    for (std::size_t element_index = 0; element_index < declaration.elements().size(); ++element_index)
+    {
+        unserialize_uint<uint8_t>(in);
+        std::size_t bytes = unserialize_uint<uint32_t>(in);
+        skip_bulk(in, bytes);
+    }
+}
+
+
+
+
+void svo_write_section(std::ostream& out, const std::string& data)
+{
+    serialize_uint<uint32_t>(out, uint32_t(data.size()));
+    serialize_uint<uint32_t>(out, svo_crc32c(data.data(), data.size()));
+    out.write(data.data(), data.size());
+}
+
+///writes the contents of @c section as a checksummed section, and empties it.
+static void write_section(std::ostream& out, std::ostringstream& section)
+{
+    svo_write_section(out, section.str());
+    section.str(std::string());
+}
+
+void serialize_slice_v2(std::ostream& out, const svo_slice_t* slice, const svo_serialization_options_t& options)
+{
+    assert(slice);
+    assert(slice->children);
+    assert(slice->pos_data);
+    assert(slice->buffers);
+
+    const auto& pos_data = *slice->pos_data;
+    const auto& buffers = *slice->buffers;
+
+    if (!options.checksums)
+    {
+        serialize_uint<uint32_t>(out, uint32_t(FORMAT_VERSION));
+        serialize_byte_order(out, options.byte_order);
+        serialize_pos_encoding(out, options.pos_encoding);
+
+        serialize_slice_child_info(out, slice);
+
+        serialize_pos_data(out, pos_data, slice->side, options);
+
+        serialize_schema(out, buffers.schema());
+        for (const auto& buffer : buffers.buffers())
+        {
+            assert(buffer.entries() == pos_data.size());
+
+            serialize_uint<uint32_t>(out, buffer.entries());
+            serialize_buffer_payload(out, buffer, options);
+        }
+        return;
+    }
+
+    serialize_uint<uint32_t>(out, uint32_t(FORMAT_VERSION_CHECKSUMMED));
+
+    std::ostringstream section;
+
+    serialize_byte_order(section, options.byte_order);
+    serialize_pos_encoding(section, options.pos_encoding);
+    serialize_slice_child_info(section, slice);
+    write_section(out, section);
+
+    serialize_pos_data(section, pos_data, slice->side, options);
+    write_section(out, section);
+
+    serialize_schema(section, buffers.schema());
+    write_section(out, section);
+
+    for (const auto& buffer : buffers.buffers())
+    {
+        assert(buffer.entries() == pos_data.size());
+
+        serialize_uint<uint32_t>(section, buffer.entries());
+        serialize_buffer_payload(section, buffer, options);
+        write_section(out, section);
+    }
+}
+
+
+bool is_v2_format_version(uint32_t format_version)
+{
+    return format_version == FORMAT_VERSION || format_version == FORMAT_VERSION_CHECKSUMMED;
+}
+
+children_params_t unserialize_slice_v2(std::istream& in, svo_slice_t* slice, bool load_empty_children
+                                        , const svo_slice_load_filter_t& filter, bool verify_checksums)
+{
+    uint32_t format_version = unserialize_uint<uint32_t>(in);
+
+    if (!is_v2_format_version(format_version))
+        throw std::runtime_error(fmt::format("Unsupported slice format version: {}, expected {} or {}"
+                                            , format_version, FORMAT_VERSION, FORMAT_VERSION_CHECKSUMMED));
+
+    return unserialize_slice_v2_body(in, format_version, slice, load_empty_children, filter, verify_checksums);
+}
+
+
+void svo_read_section(std::istream& in, std::string& data, bool verify_checksums, const char* section_name)
+{
+    std::size_t bytes = unserialize_uint<uint32_t>(in);
+    uint32_t expected_crc = unserialize_uint<uint32_t>(in);
+
+    static const std::size_t CHUNK_SIZE = 1 << 20;
+
+    data.clear();
+    while (data.size() < bytes)
+    {
+        std::size_t offset = data.size();
+        std::size_t chunk = std::min(CHUNK_SIZE, bytes - offset);
+        data.resize(offset + chunk);
+
+        in.read(&data[offset], chunk);
+        if (std::size_t(in.gcount()) != chunk)
+            throw std::runtime_error(fmt::format("Truncated {} section: expected {} bytes, got {}"
+                                                , section_name, bytes, offset + in.gcount()));
+    }
+
+    if (verify_checksums)
+    {
+        uint32_t crc = svo_crc32c(data.data(), data.size());
+        if (crc != expected_crc)
+            throw std::runtime_error(fmt::format("Checksum mismatch in {} section: expected {:#010x}, got {:#010x}"
+                                                , section_name, expected_crc, crc));
+    }
+}
+
+///skips the next section of a checksummed stream without reading it.
+static void skip_section(std::istream& in)
+{
+    std::size_t bytes = unserialize_uint<uint32_t>(in);
+    unserialize_uint<uint32_t>(in);
+    skip_bulk(in, bytes);
+}
+
+/**
+ * A stream buffer over the next @c bytes of @c source, i.e. a section's payload, which computes the
+ *  CRC-32C of the bytes as they are read.
+ *
+ * Bulk reads go straight from @c source into the reader's memory, and are checksummed there, so a
+ *  payload is not copied through an intermediate buffer. Skipping forward seeks @c source, unless the
+ *  skipped bytes must be checksummed.
+ */
+struct section_streambuf_t : public std::streambuf{
+    section_streambuf_t(std::streambuf* source, std::size_t bytes, bool checksum)
+        : m_source(source), m_remaining(bytes), m_checksum(checksum), m_crc(0)
+    {
+        setg(m_buffer, m_buffer, m_buffer);
+    }
+
+    ///bytes of the section not read yet.
+    std::size_t remaining() const
+    {
+        return m_remaining + (egptr() - gptr());
+    }
+
+    uint32_t crc() const
+    {
+        return m_crc;
+    }
+
+protected:
+    virtual int_type underflow()
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+
+        std::size_t got = read_source(m_buffer, std::min(m_remaining, sizeof(m_buffer)));
+        setg(m_buffer, m_buffer, m_buffer + got);
+        return got > 0 ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+    }
+
+    virtual std::streamsize xsgetn(char* data, std::streamsize count)
+    {
+        std::size_t buffered = std::min(std::size_t(count), std::size_t(egptr() - gptr()));
+        std::memcpy(data, gptr(), buffered);
+        gbump(int(buffered));
+
+        return std::streamsize(buffered + read_source(data + buffered, std::min(m_remaining, std::size_t(count) - buffered)));
+    }
+
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+    {
+        ///only skipping forward is supported; the position is not tracked.
+        if (!(which & std::ios_base::in) || dir != std::ios_base::cur || off < 0 || std::size_t(off) > remaining())
+            return pos_type(off_type(-1));
+
+        std::size_t buffered = std::min(std::size_t(off), std::size_t(egptr() - gptr()));
+        gbump(int(buffered));
+        std::size_t skip = std::size_t(off) - buffered;
+
+        if (!m_checksum && m_source->pubseekoff(off_type(skip), std::ios_base::cur, std::ios_base::in) != pos_type(off_type(-1)))
+        {
+            m_remaining -= skip;
+            return pos_type(0);
+        }
+
+        while (skip > 0)
+        {
+            std::size_t got = read_source(m_buffer, std::min(skip, sizeof(m_buffer)));
+            if (got == 0)
+                return pos_type(off_type(-1));
+            skip -= got;
+        }
+        setg(m_buffer, m_buffer, m_buffer);
+        return pos_type(0);
+    }
+
+private:
+    std::size_t read_source(char* data, std::size_t count)
+    {
+        std::size_t got = std::size_t(m_source->sgetn(data, std::streamsize(count)));
+        m_remaining -= got;
+        if (m_checksum)
+            m_crc = svo_crc32c(data, got, m_crc);
+        return got;
+    }
+
+    std::streambuf* m_source;
+    std::size_t m_remaining;
+    bool m_checksum;
+    uint32_t m_crc;
+    char m_buffer[256];
+};
+
+/**
+ * Calls @c parse with a stream positioned at the next section.
+ *
+ * For checksummed streams @c parse reads the section through a section_streambuf_t, and must consume it
+ *  entirely; the section is verified afterwards, before the slice is used. Otherwise @c parse reads
+ *  straight from @c in.
+ */
+template<typename parse_t>
+static void parse_section(std::istream& in, bool checksummed, bool verify_checksums, const char* section_name
+                            , parse_t parse)
+{
+    if (!checksummed)
+    {
+        parse(in);
+        return;
+    }
+
+    std::size_t bytes = unserialize_uint<uint32_t>(in);
+    uint32_t expected_crc = unserialize_uint<uint32_t>(in);
+
+    section_streambuf_t section_buf(in.rdbuf(), bytes, verify_checksums);
+    std::istream section_in(&section_buf);
+    section_in.exceptions(in.exceptions());
+    parse(section_in);
+
+    if (section_buf.remaining() != 0)
+        throw std::runtime_error(fmt::format("{} trailing bytes in {} section", section_buf.remaining(), section_name));
+
+    if (verify_checksums && section_buf.crc() != expected_crc)
+        throw std::runtime_error(fmt::format("Checksum mismatch in {} section: expected {:#010x}, got {:#010x}"
+                                            , section_name, expected_crc, section_buf.crc()));
+}
+
+children_params_t unserialize_slice_v2_body(std::istream& in, uint32_t format_version, svo_slice_t* slice, bool load_empty_children
+                                            , const svo_slice_load_filter_t& filter, bool verify_checksums)
+{
+    assert(slice);
+    assert(slice->children);
+    assert(slice->pos_data);
+    assert(slice->buffers);
+
+    assert(slice->children->size() == 0);
+    assert(slice->pos_data->size() == 0);
+    assert(slice->buffers->buffers().size() == 0);
+
+    if (!is_v2_format_version(format_version))
+        throw std::runtime_error(fmt::format("Unsupported slice format version: {}", format_version));
+
+    bool checksummed = format_version == FORMAT_VERSION_CHECKSUMMED;
+
+    auto& pos_data = *slice->pos_data;
+    auto& buffers = *slice->buffers;
+
+    svo_byte_order_t byte_order = svo_byte_order_t::little;
+    svo_pos_encoding_t pos_encoding = svo_pos_encoding_t::raw;
+    children_params_t children_params;
+    parse_section(in, checksummed, verify_checksums, "header", [&](std::istream& section_in){
+        byte_order = unserialize_byte_order(section_in);
+        pos_encoding = unserialize_pos_encoding(section_in);
+        children_params = unserialize_slice_child_info(section_in, slice);
+    });
+
+    std::size_t entries = 0;
+    parse_section(in, checksummed, verify_checksums, "pos_data", [&](std::istream& section_in){
+        entries = unserialize_pos_data(section_in, pos_data, pos_encoding, byte_order, slice->side);
+    });
+
+    svo_schema_t schema;
+    parse_section(in, checksummed, verify_checksums, "schema", [&](std::istream& section_in){
+        schema = unserialize_schema(section_in);
+    });
+
+    for (const auto& declaration : schema)
+    {
+        auto selected = filter.select(declaration);
+
+        ///a checksummed buffer section can be skipped as a whole, without reading it.
+        if (checksummed && selected.elements().empty())
+        {
+            skip_section(in);
+            continue;
+        }
+
+        parse_section(in, checksummed, verify_checksums, "buffer", [&](std::istream& section_in){
+            std::size_t buffer_entries = unserialize_uint<uint32_t>(section_in);
+            if (buffer_entries != entries)
+                throw std::runtime_error("buffer's entries does not match expected");
+
+            if (selected.elements().empty())
+            {
+                skip_buffer_payload(section_in, declaration, entries);
+                return;
+            }
+
+            auto& buffer = buffers.add_buffer(selected, entries);
+            unserialize_buffer_payload(section_in, declaration, buffer, byte_order, filter);
+        });
+    }
+
+    ///after the buffers, so the empty children can share their schema.
+    if (load_empty_children)
+    {
+        slice_load_empty_children(slice, children_params);
+    }
+
+
+    ///todo: make this an exception or return error code.
+    DEBUG_CHEAP {
+        ///the cheap tier only checks the slice itself, not its parent/children.
+        auto sanity_type = SVO_MODULE_CHECK_LEVEL >= SVO_CHECK_FULL ? svo_sanity_type_t::default_sanity : svo_sanity_type_t::minimal;
+        if(auto error = svo_slice_sanity(slice, sanity_type))
+        {
+            std::cerr << error << std::endl;
+            assert(false && "sanity fail");
+        }
+    }
+
+    return children_params;
+}
+
+
+} //namespace svo
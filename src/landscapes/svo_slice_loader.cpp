@@ -0,0 +1,338 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SERIALIZATION
+
+#include "landscapes/svo_slice_loader.hpp"
+#include "landscapes/svo_serialization.v2.hpp"
+#include "landscapes/svo_serialization.detail.hpp"
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/debug_macro.h"
+#include "format.h"
+
+#include <istream>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+namespace svo{
+
+
+void svo_archive_slice_bounds(const svo_archive_t& archive, svo_slice_id_t slice_id
+                                , float3_t& lower, float3_t& upper)
+{
+    ///walk up to the root, then back down, accumulating each child's offset within its parent.
+    std::vector<svo_slice_id_t> chain;
+    for (svo_slice_id_t id = slice_id; id != invalid_slice_id; id = archive.entry(id).parent_id)
+        chain.push_back(id);
+
+    lower = make_float3(0,0,0);
+    float extent = 1;
+
+    for (std::size_t i = chain.size() - 1; i > 0; --i)
+    {
+        const auto& parent_entry = archive.entry(chain[i]);
+        const auto& child_entry = archive.entry(chain[i - 1]);
+
+        vside_t x = 0, y = 0, z = 0;
+        vcurve2coords(child_entry.parent_vcurve_begin, parent_entry.side, &x, &y, &z);
+
+        float voxel_extent = extent / float(parent_entry.side);
+        lower = lower + make_float3(x,y,z) * voxel_extent;
+        extent = voxel_extent * float(child_entry.side / 2);
+    }
+
+    upper = lower + make_float3(extent, extent, extent);
+}
+
+
+static inline float distance_to_axis_range(float v, float lower, float upper)
+{
+    return v < lower ? lower - v : (v > upper ? v - upper : 0);
+}
+
+static inline float distance_to_box(const float3_t& p, const float3_t& lower, const float3_t& upper)
+{
+    float dx = distance_to_axis_range(p.x, lower.x, upper.x);
+    float dy = distance_to_axis_range(p.y, lower.y, upper.y);
+    float dz = distance_to_axis_range(p.z, lower.z, upper.z);
+    return std::sqrt(dx*dx + dy*dy + dz*dz);
+}
+
+
+svo_loaded_slice_t::svo_loaded_slice_t()
+    : slice_id(invalid_slice_id), slice(0)
+{
+
+}
+
+
+svo_async_slice_loader_t::svo_async_slice_loader_t(svo_archive_t& archive, std::size_t num_workers, std::size_t capacity
+                                                    , bool load_empty_children, const svo_slice_load_filter_t& filter)
+    : m_archive(archive), m_capacity(capacity), m_load_empty_children(load_empty_children), m_filter(filter)
+    , m_max_decode_queue(std::max<std::size_t>(num_workers, 1) * 2)
+    , m_stop(false)
+    , m_states(archive.size(), slice_state_t::none)
+    , m_loading(0)
+{
+    if (capacity == 0)
+        throw std::runtime_error("svo_async_slice_loader_t needs a capacity of at least one slice");
+
+    num_workers = std::max<std::size_t>(num_workers, 1);
+
+    m_io_thread = std::thread(&svo_async_slice_loader_t::io_main, this);
+    for (std::size_t i = 0; i < num_workers; ++i)
+        m_workers.push_back(std::thread(&svo_async_slice_loader_t::worker_main, this));
+}
+
+svo_async_slice_loader_t::~svo_async_slice_loader_t()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_io_cv.notify_all();
+    m_decode_cv.notify_all();
+
+    m_io_thread.join();
+    for (auto& worker : m_workers)
+        worker.join();
+
+    for (auto& loaded : m_ready)
+    {
+        if (loaded.slice)
+            svo_uninit_slice(loaded.slice, true);
+    }
+}
+
+bool svo_async_slice_loader_t::request_locked(svo_slice_id_t slice_id, float priority)
+{
+    if (slice_id >= m_states.size())
+        throw std::runtime_error(fmt::format("Invalid slice id: {}", slice_id));
+
+    if (m_states[slice_id] == slice_state_t::queued)
+    {
+        for (auto& pending : m_pending)
+        {
+            if (pending.slice_id == slice_id)
+                pending.priority = std::max(pending.priority, priority);
+        }
+        return true;
+    }
+
+    if (m_states[slice_id] == slice_state_t::loading || m_states[slice_id] == slice_state_t::ready)
+        return false;
+    if (m_pending.size() + m_loading + m_ready.size() >= m_capacity)
+        return false;
+
+    m_states[slice_id] = slice_state_t::queued;
+    m_pending.push_back(pending_t{slice_id, priority});
+    return true;
+}
+
+bool svo_async_slice_loader_t::request(svo_slice_id_t slice_id, float priority)
+{
+    bool queued = false;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        queued = request_locked(slice_id, priority);
+    }
+    if (queued)
+        m_io_cv.notify_one();
+    return queued;
+}
+
+bool svo_async_slice_loader_t::cancel(svo_slice_id_t slice_id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = std::find_if(m_pending.begin(), m_pending.end()
+                            , [slice_id](const pending_t& pending){ return pending.slice_id == slice_id; });
+    if (it == m_pending.end())
+        return false;
+
+    m_pending.erase(it);
+    m_states[slice_id] = slice_state_t::none;
+    return true;
+}
+
+std::size_t svo_async_slice_loader_t::prefetch_children(svo_slice_id_t slice_id, float priority)
+{
+    const auto& entry = m_archive.entry(slice_id);
+
+    std::size_t queued = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (svo_slice_id_t child_id : entry.children)
+        {
+            if (m_states[child_id] != slice_state_t::none)
+                continue;
+            if (request_locked(child_id, priority))
+                ++queued;
+        }
+    }
+
+    if (queued > 0)
+        m_io_cv.notify_one();
+    return queued;
+}
+
+std::size_t svo_async_slice_loader_t::prefetch_near(const float3_t& camera, float max_distance)
+{
+    ///distance from the camera to each slice's cube; the index is const, so no lock is needed.
+    std::vector<std::pair<float, svo_slice_id_t>> candidates;
+    for (svo_slice_id_t slice_id = 0; slice_id < m_archive.size(); ++slice_id)
+    {
+        float3_t lower, upper;
+        svo_archive_slice_bounds(m_archive, slice_id, lower, upper);
+
+        float distance = distance_to_box(camera, lower, upper);
+
+        if (distance <= max_distance)
+            candidates.push_back(std::make_pair(distance, slice_id));
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    std::size_t queued = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (const auto& candidate : candidates)
+        {
+            if (m_states[candidate.second] != slice_state_t::none)
+                continue;
+            if (!request_locked(candidate.second, -candidate.first))
+                break;
+            ++queued;
+        }
+    }
+
+    if (queued > 0)
+        m_io_cv.notify_one();
+    return queued;
+}
+
+bool svo_async_slice_loader_t::try_pop(svo_loaded_slice_t& loaded)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_ready.empty())
+        return false;
+
+    loaded = m_ready.front();
+    m_ready.pop_front();
+    m_states[loaded.slice_id] = slice_state_t::popped;
+    return true;
+}
+
+bool svo_async_slice_loader_t::wait_pop(svo_loaded_slice_t& loaded)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_ready_cv.wait(lock, [this](){ return !m_ready.empty() || (m_pending.empty() && m_loading == 0); });
+
+    if (m_ready.empty())
+        return false;
+
+    loaded = m_ready.front();
+    m_ready.pop_front();
+    m_states[loaded.slice_id] = slice_state_t::popped;
+    return true;
+}
+
+std::size_t svo_async_slice_loader_t::outstanding() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_pending.size() + m_loading + m_ready.size();
+}
+
+void svo_async_slice_loader_t::complete_locked(svo_loaded_slice_t loaded)
+{
+    assert(m_loading > 0);
+    --m_loading;
+    m_states[loaded.slice_id] = slice_state_t::ready;
+    m_ready.push_back(loaded);
+}
+
+void svo_async_slice_loader_t::io_main()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_io_cv.wait(lock, [this](){
+            return m_stop || (!m_pending.empty() && m_decode_queue.size() < m_max_decode_queue);
+        });
+        if (m_stop)
+            break;
+
+        auto best = std::max_element(m_pending.begin(), m_pending.end()
+                                    , [](const pending_t& lhs, const pending_t& rhs){ return lhs.priority < rhs.priority; });
+        svo_slice_id_t slice_id = best->slice_id;
+        m_pending.erase(best);
+        m_states[slice_id] = slice_state_t::loading;
+        ++m_loading;
+
+        decode_job_t job;
+        job.slice_id = slice_id;
+
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            m_archive.read_slice_data(slice_id, job.data);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        if (error)
+        {
+            svo_loaded_slice_t loaded;
+            loaded.slice_id = slice_id;
+            loaded.error = error;
+            complete_locked(loaded);
+            m_ready_cv.notify_all();
+            continue;
+        }
+
+        m_decode_queue.push_back(std::move(job));
+        m_decode_cv.notify_one();
+    }
+}
+
+void svo_async_slice_loader_t::worker_main()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_decode_cv.wait(lock, [this](){ return m_stop || !m_decode_queue.empty(); });
+        if (m_stop)
+            break;
+
+        decode_job_t job = std::move(m_decode_queue.front());
+        m_decode_queue.pop_front();
+        ///room in the decode queue.
+        m_io_cv.notify_one();
+
+        lock.unlock();
+        const auto& entry = m_archive.entry(job.slice_id);
+
+        svo_loaded_slice_t loaded;
+        loaded.slice_id = job.slice_id;
+        loaded.slice = svo_init_slice(entry.level, entry.side);
+        try {
+            svo_memory_streambuf_t data_buf(job.data.data(), job.data.size());
+            std::istream in(&data_buf);
+            unserialize_slice_v2(in, loaded.slice, m_load_empty_children, m_filter, m_archive.verify_checksums());
+
+            if (std::size_t(loaded.slice->side) != std::size_t(entry.side))
+                throw std::runtime_error(fmt::format("Slice {} does not match its archive entry", job.slice_id));
+        } catch (...) {
+            svo_uninit_slice(loaded.slice, true);
+            loaded.slice = 0;
+            loaded.error = std::current_exception();
+        }
+        lock.lock();
+
+        complete_locked(loaded);
+        m_ready_cv.notify_all();
+    }
+}
+
+
+} //namespace svo
@@ -0,0 +1,334 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SLICE_MGMT
+
+#include "landscapes/svo_sort.hpp"
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_buffer.hpp"
+#include "landscapes/svo_parallel.detail.hpp"
+#include "landscapes/debug_macro.h"
+#include "format.h"
+
+#include <vector>
+#include <array>
+#include <tuple>
+#include <queue>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace svo{
+
+
+///not worth a thread for fewer items than this.
+static const std::size_t MIN_ITEMS_PER_THREAD = 4096;
+
+static inline std::size_t useful_threads(std::size_t num_threads, std::size_t size)
+{
+    return std::max<std::size_t>(1, std::min(num_threads, size / MIN_ITEMS_PER_THREAD));
+}
+
+///number of bits needed for the vcurves of a slice of side @c side.
+static std::size_t vcurve_bits(vside_t side)
+{
+    uint64_t max_vcurve = uint64_t(vcurvesize(side)) - 1;
+
+    std::size_t bits = 0;
+    while (bits < 64 && (max_vcurve >> bits) != 0)
+        ++bits;
+    return bits;
+}
+
+
+void svo_radix_sort(std::vector<svo_sort_record_t>& records, std::size_t key_bits, std::size_t num_threads)
+{
+    static const std::size_t RADIX_BITS = 8;
+    static const std::size_t RADIX = std::size_t(1) << RADIX_BITS;
+
+    std::size_t size = records.size();
+    if (size < 2)
+        return;
+
+    num_threads = useful_threads(num_threads, size);
+
+    std::vector<svo_sort_record_t> scratch(size);
+    std::vector<svo_sort_record_t>* src = &records;
+    std::vector<svo_sort_record_t>* dst = &scratch;
+
+    std::vector< std::array<std::size_t, RADIX> > counts(num_threads);
+
+    for (std::size_t shift = 0; shift < key_bits; shift += RADIX_BITS)
+    {
+        run_parallel(num_threads, [&](std::size_t thread_index){
+            auto& count = counts[thread_index];
+            count.fill(0);
+            std::size_t end = chunk_begin(size, num_threads, thread_index + 1);
+            for (std::size_t i = chunk_begin(size, num_threads, thread_index); i < end; ++i)
+                ++count[((*src)[i].key >> shift) & (RADIX - 1)];
+        });
+
+        ///exclusive prefix sum, digit major, so that equal digits keep their input order.
+        bool trivial = false;
+        std::size_t offset = 0;
+        for (std::size_t digit = 0; digit < RADIX; ++digit)
+        {
+            std::size_t digit_count = 0;
+            for (std::size_t thread_index = 0; thread_index < num_threads; ++thread_index)
+            {
+                std::size_t count = counts[thread_index][digit];
+                counts[thread_index][digit] = offset;
+                offset += count;
+                digit_count += count;
+            }
+            trivial = trivial || digit_count == size;
+        }
+
+        if (trivial)
+            continue;
+
+        run_parallel(num_threads, [&](std::size_t thread_index){
+            auto& next = counts[thread_index];
+            std::size_t end = chunk_begin(size, num_threads, thread_index + 1);
+            for (std::size_t i = chunk_begin(size, num_threads, thread_index); i < end; ++i)
+            {
+                const auto& record = (*src)[i];
+                (*dst)[next[(record.key >> shift) & (RADIX - 1)]++] = record;
+            }
+        });
+
+        std::swap(src, dst);
+    }
+
+    if (src != &records)
+        records.swap(scratch);
+}
+
+
+
+void svo_gather_slice_data(svo_slice_t* slice, const std::vector<std::size_t>& sources, std::size_t num_threads)
+{
+    assert(slice);
+    assert(slice->pos_data);
+    assert(slice->buffers);
+
+    auto& pos_data = *slice->pos_data;
+    auto& buffers = *slice->buffers;
+
+    assert(buffers.entries() == pos_data.size() || buffers.buffers().empty());
+
+    std::size_t size = sources.size();
+    for (std::size_t source : sources)
+        if (source >= pos_data.size())
+            throw std::runtime_error(fmt::format("Invalid source voxel: {}, the slice has {} voxels", source, pos_data.size()));
+
+    num_threads = useful_threads(num_threads, size);
+
+    {
+        svo_slice_t::pos_data_t gathered(size);
+        run_parallel(num_threads, [&](std::size_t thread_index){
+            std::size_t end = chunk_begin(size, num_threads, thread_index + 1);
+            for (std::size_t i = chunk_begin(size, num_threads, thread_index); i < end; ++i)
+                gathered[i] = pos_data[sources[i]];
+        });
+        pos_data.swap(gathered);
+    }
+
+    for (auto& buffer : buffers.buffers())
+    {
+        std::size_t stride = buffer.stride();
+        svo_cpu_buffer_t gathered(buffer.declaration(), size, buffer.arena());
+
+        const uint8_t* src = static_cast<const svo_cpu_buffer_t&>(buffer).rawdata();
+        uint8_t* dst = gathered.rawdata();
+        run_parallel(num_threads, [&](std::size_t thread_index){
+            std::size_t end = chunk_begin(size, num_threads, thread_index + 1);
+            for (std::size_t i = chunk_begin(size, num_threads, thread_index); i < end; ++i)
+                std::memcpy(dst + i * stride, src + sources[i] * stride, stride);
+        });
+
+        buffer = std::move(gathered);
+    }
+}
+
+void svo_sort_slice_data(svo_slice_t* slice, std::size_t num_threads)
+{
+    assert(slice);
+    assert(slice->pos_data);
+
+    const auto& pos_data = *slice->pos_data;
+    if (std::adjacent_find(pos_data.begin(), pos_data.end(), std::greater_equal<vcurve_t>()) == pos_data.end())
+        return;
+
+    std::vector<svo_sort_record_t> records(pos_data.size());
+    for (std::size_t i = 0; i < pos_data.size(); ++i)
+        records[i] = svo_sort_record_t{uint64_t(pos_data[i]), uint64_t(i)};
+
+    svo_radix_sort(records, vcurve_bits(slice->side), num_threads);
+
+    ///the sort is stable, so the last voxel of a vcurve is the last of its run.
+    std::vector<std::size_t> sources;
+    sources.reserve(records.size());
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        if (i + 1 < records.size() && records[i + 1].key == records[i].key)
+            continue;
+        sources.push_back(std::size_t(records[i].index));
+    }
+
+    svo_gather_slice_data(slice, sources, num_threads);
+}
+
+
+
+namespace{
+    ///a range of consecutive voxels of one source, copied to consecutive voxels of the destination.
+    struct merge_run_t{
+        std::size_t source;
+        std::size_t begin;
+        std::size_t count;
+    };
+} //namespace
+
+void svo_merge_slice_data(svo_slice_t* dst_slice, const std::vector<const svo_slice_t*>& src_slices
+                            , const std::vector<vcurve_t>& vcurve_offsets)
+{
+    assert(dst_slice);
+    assert(dst_slice->pos_data);
+    assert(dst_slice->buffers);
+
+    if (src_slices.size() != vcurve_offsets.size())
+        throw std::runtime_error(fmt::format("Merging {} slices with {} vcurve offsets", src_slices.size(), vcurve_offsets.size()));
+    if (!dst_slice->pos_data->empty())
+        throw std::runtime_error("Merging into a slice that already has voxels");
+
+    auto& dst_pos_data = *dst_slice->pos_data;
+    auto& dst_buffers = *dst_slice->buffers;
+
+    std::size_t total = 0;
+    for (const svo_slice_t* src_slice : src_slices)
+    {
+        if (!src_slice)
+            continue;
+        assert(src_slice->pos_data);
+        assert(src_slice->buffers);
+
+        if (!dst_buffers.has_schema())
+            dst_buffers.copy_schema(*src_slice->buffers);
+        if (src_slice->buffers->schema() != dst_buffers.schema())
+            throw std::runtime_error(fmt::format("Cannot merge slices with different schemas: {} and {}"
+                                                , src_slice->buffers->schema(), dst_buffers.schema()));
+        total += src_slice->pos_data->size();
+    }
+
+    ///(vcurve, source) of the next voxel of each source; on equal vcurves the lower source pops first.
+    typedef std::tuple<vcurve_t, std::size_t> head_t;
+    std::priority_queue<head_t, std::vector<head_t>, std::greater<head_t> > heads;
+    std::vector<std::size_t> positions(src_slices.size(), 0);
+
+    for (std::size_t source = 0; source < src_slices.size(); ++source)
+    {
+        const svo_slice_t* src_slice = src_slices[source];
+        if (src_slice && !src_slice->pos_data->empty())
+            heads.push(head_t((*src_slice->pos_data)[0] + vcurve_offsets[source], source));
+    }
+
+    dst_pos_data.reserve(total);
+    std::vector<merge_run_t> runs;
+    while (!heads.empty())
+    {
+        vcurve_t vcurve; std::size_t source;
+        std::tie(vcurve, source) = heads.top();
+        heads.pop();
+
+        const auto& src_pos_data = *src_slices[source]->pos_data;
+        std::size_t position = positions[source]++;
+        if (positions[source] < src_pos_data.size())
+        {
+            vcurve_t next = src_pos_data[positions[source]] + vcurve_offsets[source];
+            assert(next > vcurve && "source slices must be Morton ordered");
+            heads.push(head_t(next, source));
+        }
+
+        ///a later source replaces the voxel.
+        if (!dst_pos_data.empty() && dst_pos_data.back() == vcurve)
+        {
+            dst_pos_data.pop_back();
+            if (--runs.back().count == 0)
+                runs.pop_back();
+        }
+
+        dst_pos_data.push_back(vcurve);
+        if (!runs.empty() && runs.back().source == source && runs.back().begin + runs.back().count == position)
+            ++runs.back().count;
+        else
+            runs.push_back(merge_run_t{source, position, 1});
+    }
+
+    auto& dst_buffers_list = dst_buffers.buffers();
+    for (std::size_t buffer_index = 0; buffer_index < dst_buffers_list.size(); ++buffer_index)
+    {
+        auto& dst_buffer = dst_buffers_list[buffer_index];
+        std::size_t stride = dst_buffer.stride();
+
+        ///a single run, e.g. one source, is shared rather than copied, unless the source is in
+        /// another arena.
+        if (runs.size() == 1)
+        {
+            dst_buffer = src_slices[runs[0].source]->buffers->buffers()[buffer_index].view(runs[0].begin, runs[0].count);
+            dst_buffer.set_arena(dst_buffers.arena());
+            continue;
+        }
+
+        ///one allocation; the schemas match, so the entries are copied raw.
+        dst_buffer.resize(dst_pos_data.size());
+
+        std::size_t dst_start = 0;
+        for (const auto& run : runs)
+        {
+            const auto& src_buffer = src_slices[run.source]->buffers->buffers()[buffer_index];
+            std::memcpy(dst_buffer.rawdata() + dst_start * stride, src_buffer.rawdata() + run.begin * stride, run.count * stride);
+            dst_start += run.count;
+        }
+        assert(dst_start == dst_pos_data.size());
+    }
+}
+
+void svo_partition_slice_data(svo_slice_t* slice, std::array<std::size_t, 9>& octant_begin)
+{
+    assert(slice);
+    assert(slice->pos_data);
+    assert(slice->side > 1);
+
+    const auto& pos_data = *slice->pos_data;
+    vcurvesize_t octant_size = vcurvesize(slice->side) / 8;
+
+    std::array<std::size_t, 8> counts;
+    counts.fill(0);
+    bool ordered = true;
+    for (std::size_t i = 0; i < pos_data.size(); ++i)
+    {
+        std::size_t octant = std::size_t(pos_data[i] / octant_size);
+        assert(octant < 8);
+        ++counts[octant];
+        ordered = ordered && (i == 0 || octant >= std::size_t(pos_data[i - 1] / octant_size));
+    }
+
+    octant_begin[0] = 0;
+    for (std::size_t octant = 0; octant < 8; ++octant)
+        octant_begin[octant + 1] = octant_begin[octant] + counts[octant];
+
+    if (ordered)
+        return;
+
+    std::array<std::size_t, 8> next;
+    std::copy(octant_begin.begin(), octant_begin.begin() + 8, next.begin());
+
+    std::vector<std::size_t> sources(pos_data.size());
+    for (std::size_t i = 0; i < pos_data.size(); ++i)
+        sources[next[std::size_t(pos_data[i] / octant_size)]++] = i;
+
+    svo_gather_slice_data(slice, sources);
+}
+
+
+} //namespace svo
@@ -1,3 +1,4 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_BLOCK_MGMT
 
 #include "landscapes/debug_macro.h"
 #include "landscapes/cpputils.hpp"
@@ -9,15 +10,18 @@
 #include "bprinter/table_printer.h"
 
 #include "pempek_assert.h"
+#include "format.h"
 #include <iostream>
 #include <deque>
 #include <algorithm>
+#include <stdexcept>
+#include <cstring>
 
 namespace svo{
 
 
 slice_inserter_t::slice_inserter_t(svo_tree_t* tree, svo_block_t* block)
-    : tree(tree), block(block), slice(nullptr), parent_block(nullptr)
+    : tree(tree), block(block), slice(nullptr), parent_block(nullptr), attr_entry_bytes(0)
 {
     assert(block);
     assert(block->slice);
@@ -69,6 +73,17 @@ slice_inserter_t::slice_inserter_t(svo_tree_t* tree, svo_block_t* block)
     
     out_uc_root_offsets.resize(out_datas.size(), offset_t(-1));
     out_data_root_levels.resize(out_datas.size(), std::size_t(-1));
+    out_datas_attrs.resize(out_datas.size());
+
+    if (slice->buffers->has_schema())
+    {
+        for (const auto& buffer : slice->buffers->buffers())
+            attr_entry_bytes += buffer.stride();
+
+        if (block->buffers->has_schema() && block->buffers->schema() != slice->buffers->schema())
+            throw std::runtime_error(fmt::format("Cannot insert a slice with schema {} into a block with schema {}"
+                                                , slice->buffers->schema(), block->buffers->schema()));
+    }
 }
 
 svo_error_t slice_inserter_t::execute()
@@ -85,6 +100,13 @@ svo_error_t slice_inserter_t::execute()
     
     cd_goffsets_t uc_cd_goffsets(uc_out_data.size(), invalid_goffset);
     insert_unclassified_child_descriptors(uc_cd_goffsets);
+
+    if (attr_entry_bytes > 0 && uc_out_data.size() > 0)
+    {
+        prepare_block_attrs(parent_block);
+        for (std::size_t out_data_index = 0; out_data_index < uc_out_data.size(); ++out_data_index)
+            write_block_attrs(parent_block, uc_cd_goffsets[out_data_index], uc_out_attrs, out_data_index);
+    }
     
     ///remove the block from the parent block
     {
@@ -111,6 +133,18 @@ svo_error_t slice_inserter_t::execute()
         std::vector<goffset_t> cd_goffsets(out_data.size(), invalid_goffset);
         insert_classified_child_descriptors(cd_goffsets, dst_block, classification
                                             , uc_cd_goffsets, cd_req_far_ptrs, cd_parent_indices, out_data);
+
+        ///the CDs were rewritten, so their data is rewritten with them; the root shadow CD keeps the data of the
+        /// root CD it shadows.
+        if (attr_entry_bytes > 0)
+        {
+            const out_attrs_t& out_attrs = out_datas_attrs[classification];
+
+            prepare_block_attrs(dst_block);
+            write_block_attrs(dst_block, dst_block->root_shadow_cd_goffset, uc_out_attrs, root_out_data_index(classification));
+            for (std::size_t out_data_index = 0; out_data_index < out_data.size(); ++out_data_index)
+                write_block_attrs(dst_block, cd_goffsets[out_data_index], out_attrs, out_data_index);
+        }
         
         DEBUG {
             std::vector<std::string> issues;
@@ -375,7 +409,6 @@ void slice_inserter_t::classify_child_descriptors()
         
         assert (classification == std::size_t(-1) || classification < out_datas.size());
 
-
         std::size_t out_data_index = std::size_t(-1);
 
         
@@ -388,6 +421,7 @@ void slice_inserter_t::classify_child_descriptors()
         
         ///we output either to the unclassified out data, or to the classified out data.
         auto& out_data = (classification != std::size_t(-1)) ? out_datas[classification] : uc_out_data;
+        auto& out_attrs = (classification != std::size_t(-1)) ? out_datas_attrs[classification] : uc_out_attrs;
         //auto& out_data_channels = (classification != std::size_t(-1)) ? out_datas_all_channels[classification] : uc_out_data_channels;
             
         ///if this is a child descriptor already in the block
@@ -419,6 +453,7 @@ void slice_inserter_t::classify_child_descriptors()
             
             ///and push it into the data.
             out_data.push_back( std::make_tuple(level, level_vcurve, new_cd, 0 /* child offset */) );
+            stage_block_attrs(out_attrs, out_data_index, cd_goffset);
 
 
             //for (std::size_t attr_index = 0; attr_index < out_data_channels.size(); ++attr_index)
@@ -454,6 +489,7 @@ void slice_inserter_t::classify_child_descriptors()
                         
                     out_data_index = out_data.size();
                     out_data.push_back( std::make_tuple(level, level_vcurve, new_cd, 0 ) );
+                    stage_block_attrs(out_attrs, out_data_index, invalid_goffset);
                 }
                 assert( out_data_index != std::size_t(-1) );
                 
@@ -478,9 +514,11 @@ void slice_inserter_t::classify_child_descriptors()
                     std::cout << std::endl;
                     */
                     
-                    vcurve_t next_new_voxel_vcurve = in_pos_data[in_data_index++];
+                    vcurve_t next_new_voxel_vcurve = in_pos_data[in_data_index];
 
                     ccurve_t new_voxel_ccurve = next_new_voxel_vcurve % 8;
+                    stage_slice_attrs(out_attrs, out_data_index, new_voxel_ccurve, in_data_index);
+                    ++in_data_index;
 
                     valid_mask |= (1 << new_voxel_ccurve);
                     leaf_mask |= (1 << new_voxel_ccurve);
@@ -669,6 +707,99 @@ void slice_inserter_t::classify_child_descriptors()
 }
 
 
+std::size_t slice_inserter_t::root_out_data_index(std::size_t classification) const
+{
+    assert(classification < out_uc_root_offsets.size());
+
+    ///special case when there is only one voxel
+    if (out_uc_root_offsets[classification] == offset_t(-1))
+        return 0;
+    return out_uc_root_offsets[classification];
+}
+
+void slice_inserter_t::stage_block_attrs(out_attrs_t& out_attrs, std::size_t out_data_index, goffset_t cd_goffset)
+{
+    if (attr_entry_bytes == 0)
+        return;
+
+    assert(out_attrs.size() == out_data_index*8*attr_entry_bytes);
+    out_attrs.resize((out_data_index + 1)*8*attr_entry_bytes, 0);
+
+    ///a new CD, or a block that has no data yet.
+    if (cd_goffset == invalid_goffset || !block->buffers->has_schema())
+        return;
+
+    assert(block->is_valid_cd_goffset(cd_goffset));
+    const auto& buffers = block->buffers->buffers();
+    uint8_t* dst = &out_attrs[out_data_index*8*attr_entry_bytes];
+
+    for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
+    {
+        uint32_t data_index = svo_get_data_index(block->cd_start, cd_goffset, ccurve);
+        if (data_index >= block->buffers->entries())
+            break;
+
+        for (const auto& buffer : buffers)
+        {
+            std::memcpy(dst, buffer.rawdata() + data_index*buffer.stride(), buffer.stride());
+            dst += buffer.stride();
+        }
+    }
+}
+
+void slice_inserter_t::stage_slice_attrs(out_attrs_t& out_attrs, std::size_t out_data_index, ccurve_t ccurve, std::size_t in_data_index)
+{
+    if (attr_entry_bytes == 0)
+        return;
+
+    assert(ccurve < 8);
+    assert(in_data_index < slice->buffers->entries());
+    assert((out_data_index*8 + ccurve + 1)*attr_entry_bytes <= out_attrs.size());
+
+    uint8_t* dst = &out_attrs[(out_data_index*8 + ccurve)*attr_entry_bytes];
+    for (const auto& buffer : slice->buffers->buffers())
+    {
+        std::memcpy(dst, buffer.rawdata() + in_data_index*buffer.stride(), buffer.stride());
+        dst += buffer.stride();
+    }
+}
+
+void slice_inserter_t::prepare_block_attrs(svo_block_t* dst_block)
+{
+    assert(attr_entry_bytes > 0);
+
+    auto& buffers = *dst_block->buffers;
+    if (!buffers.has_schema())
+        buffers.copy_schema(slice->buffers->schema(), 0);
+    else if (buffers.schema() != slice->buffers->schema())
+        throw std::runtime_error(fmt::format("Cannot insert a slice with schema {} into a block with schema {}"
+                                            , slice->buffers->schema(), buffers.schema()));
+
+    if (buffers.entries() < dst_block->data_slots())
+        dst_block->fit_data();
+}
+
+void slice_inserter_t::write_block_attrs(svo_block_t* dst_block, goffset_t cd_goffset, const out_attrs_t& out_attrs, std::size_t out_data_index)
+{
+    assert(dst_block->is_valid_cd_goffset(cd_goffset));
+    assert((out_data_index + 1)*8*attr_entry_bytes <= out_attrs.size());
+
+    const uint8_t* src = &out_attrs[out_data_index*8*attr_entry_bytes];
+    auto& buffers = dst_block->buffers->buffers();
+
+    for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
+    {
+        uint32_t data_index = svo_get_data_index(dst_block->cd_start, cd_goffset, ccurve);
+        assert(data_index < dst_block->buffers->entries());
+
+        for (auto& buffer : buffers)
+        {
+            std::memcpy(buffer.rawdata() + data_index*buffer.stride(), src, buffer.stride());
+            src += buffer.stride();
+        }
+    }
+}
+
 void slice_inserter_t::allocate_dst_blocks()
 {
     assert(out_datas.size() > 0);
@@ -955,14 +1086,7 @@ void slice_inserter_t::insert_classified_child_descriptors (
         
         assert(classification < out_uc_root_offsets.size());
         
-        std::size_t root_out_data_index = out_uc_root_offsets[classification];
-        ///special case when there is only one voxel
-        if (root_out_data_index == std::size_t(-1)) {
-            root_out_data_index = 0;
-        } else {
-            
-        }
-        
+        std::size_t root_out_data_index = this->root_out_data_index(classification);
         assert(root_out_data_index < uc_out_data.size());
         
         const auto& root_voxel = uc_out_data[root_out_data_index];
@@ -1,8 +1,10 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_TREE
 
 #include "landscapes/svo_tree.hpp"
 #include "landscapes/svo_tree.block_mgmt.hpp"
 #include "landscapes/cpputils.hpp"
 #include "landscapes/svo_tree.sanity.hpp"
+#include "landscapes/svo_sort.hpp"
 
 #include "landscapes/debug_macro.h"
 #include "pempek_assert.h"
@@ -13,6 +15,7 @@
 #include <bitset>
 #include <algorithm>
 #include <cstring>
+#include <limits>
 
 #ifndef DEBUG_PRINT
 
@@ -52,9 +55,9 @@ namespace svo{
 /**
  * @param slice, should be a pointer to uninitialized memory.
  */
-svo_slice_t* svo_init_slice(std::size_t level, vside_t side, void* userdata)
+svo_slice_t* svo_init_slice(std::size_t level, vside_t side, void* userdata, svo_arena_t* arena)
 {
-    svo_slice_t* slice = new svo_slice_t();
+    svo_slice_t* slice = arena ? arena->create<svo_slice_t>() : new svo_slice_t();
 
     slice->level = level;
     slice->side = side;
@@ -63,10 +66,20 @@ svo_slice_t* svo_init_slice(std::size_t level, vside_t side, void* userdata)
     slice->children = 0;
     slice->parent_slice = 0;
     slice->parent_vcurve_begin = 0;
+    slice->arena = arena;
 
-    slice->pos_data = new svo_slice_t::pos_data_t();
-    slice->children = new svo_slice_t::children_t();
-    slice->buffers = new svo_cpu_buffers_t();
+    if (arena)
+    {
+        slice->pos_data = arena->create<svo_slice_t::pos_data_t>();
+        slice->children = arena->create<svo_slice_t::children_t>();
+        slice->buffers = arena->create<svo_cpu_buffers_t>(arena);
+    }
+    else
+    {
+        slice->pos_data = new svo_slice_t::pos_data_t();
+        slice->children = new svo_slice_t::children_t();
+        slice->buffers = new svo_cpu_buffers_t();
+    }
 
 
 
@@ -80,8 +93,17 @@ void svo_uninit_slice(svo_slice_t* slice, bool recursive)
 {
     assert(slice);
 
-    delete slice->pos_data;
-    delete slice->buffers;
+    svo_arena_t* arena = slice->arena;
+    if (arena)
+    {
+        svo_arena_t::destroy(slice->pos_data);
+        svo_arena_t::destroy(slice->buffers);
+    }
+    else
+    {
+        delete slice->pos_data;
+        delete slice->buffers;
+    }
     
     slice->level = 0;
     slice->side = 0;
@@ -102,12 +124,17 @@ void svo_uninit_slice(svo_slice_t* slice, bool recursive)
             (*children)[child_index] = 0;
         }
 
-        delete children;
+        if (arena)
+            svo_arena_t::destroy(children);
+        else
+            delete children;
     }
 
 
-
-    delete slice;
+    if (arena)
+        svo_arena_t::destroy(slice);
+    else
+        delete slice;
 }
 /*
 svo_channel_t& svo_slice_t::add_channel(const std::string& name, std::size_t element_size, const std::string& type_name)
@@ -158,7 +185,7 @@ bool svo_slice_t::has_channel(const std::string& name) const
 
 */
 
-svo_slice_t* svo_clone_slice(const svo_slice_t* slice0, bool recursive)
+svo_slice_t* svo_clone_slice(const svo_slice_t* slice0, bool recursive, svo_arena_t* arena)
 {
     assert(slice0);
     assert(slice0->pos_data);
@@ -174,7 +201,7 @@ svo_slice_t* svo_clone_slice(const svo_slice_t* slice0, bool recursive)
         }
     }
 
-    svo_slice_t* slice = svo_init_slice(slice0->level, slice0->side, slice0->userdata);
+    svo_slice_t* slice = svo_init_slice(slice0->level, slice0->side, slice0->userdata, arena);
 
     slice->level = slice0->level;
     slice->side = slice0->side;
@@ -196,17 +223,15 @@ svo_slice_t* svo_clone_slice(const svo_slice_t* slice0, bool recursive)
     
     *slice->pos_data = *slice0->pos_data;
     *slice->children = *slice0->children;
-    slice->buffers->reset();
-    
-    slice->buffers->assert_invariants();
-    
-    slice->buffers->copy_schema( *slice0->buffers, slice0->buffers->entries() );
+
+    ///the clone's buffers share the storage of the original until either is written.
+    slice->buffers->share_buffers( *slice0->buffers );
 
     if (recursive)
     {
         for (svo_slice_t*& child : *slice->children)
         {
-            child = svo_clone_slice(child, true);
+            child = svo_clone_slice(child, true, arena);
         }
     }
 
@@ -241,7 +266,7 @@ void svo_slice_attach_child(svo_slice_t* parent, svo_slice_t* child, vcurve_t pa
     assert(parent->level + 1 == child->level);
     assert(child->parent_vcurve_begin == 0);
     assert(child->side <= parent->side * 2);
-    assert(child->side < 256);
+    assert(child->side <= SVO_VSIDE_LIMIT);
 
     vcurvesize_t parent_size = vcurvesize(parent->side);
     vcurvesize_t child_size = vcurvesize(child->side);
@@ -423,6 +448,35 @@ svo_tree_t::mem_range_t svo_tree_t::mem_malloc(std::size_t size)
     return result;
 }
 
+void svo_tree_t::mem_reserve(mem_range_t mem_range)
+{
+    assert(mem_range.first < mem_range.second);
+    assert(mem_range.first % SVO_PAGE_SIZE == 0);
+    assert(mem_range.second % SVO_PAGE_SIZE == 0);
+
+    ///the free ranges are disjoint, so the only candidate is the last one starting at or before this one.
+    auto w = freemems.upper_bound(mem_range_t(mem_range.first, std::numeric_limits<std::size_t>::max()));
+    if (w == freemems.begin())
+        throw svo_bad_alloc();
+    --w;
+
+    auto freemem_range0 = w->first;
+    auto free_memory_range_info0 = w->second;
+    if (!(freemem_range0.first <= mem_range.first && mem_range.second <= freemem_range0.second))
+        throw svo_bad_alloc();
+
+    freemems.erase(w);
+    size2freemem.erase(free_memory_range_info0.size2freemem_iterator);
+
+    for (auto freemem_range1 : {mem_range_t(freemem_range0.first, mem_range.first)
+                              , mem_range_t(mem_range.second, freemem_range0.second)})
+    {
+        if (mem_range_size(freemem_range1) == 0)
+            continue;
+        freemems[freemem_range1] = default_freemem_lookup_info();
+        update_freemem_lookup_info(freemem_range1);
+    }
+}
 
 
 svo_block_t::svo_block_t()
@@ -451,6 +505,10 @@ void svo_block_t::reset()
     this->cd_end = invalid_goffset;
     this->cdspace_end = invalid_goffset;
 
+    this->data_start = invalid_goffset;
+    this->data_end = invalid_goffset;
+    this->dataspace_end = invalid_goffset;
+
     this->info_goffset = invalid_goffset;
 
     this->root_shadow_cd_goffset = invalid_goffset;
@@ -654,6 +712,32 @@ bool svo_block_t::check_parent_root_cd() const
     return check_parent_root_cd(issues);
 }
 
+std::size_t svo_block_t::data_slots() const
+{
+    assert(cd_start <= cd_end);
+    return (cd_end - cd_start) / sizeof(child_descriptor_t) * 8;
+}
+
+void svo_block_t::fit_data()
+{
+    assert(buffers);
+    buffers->resize(data_slots());
+}
+
+void svo_block_t::update_info_section()
+{
+    assert(tree);
+    assert(tree->address_space);
+    assert(info_goffset != invalid_goffset);
+    assert(is_in_block(info_goffset, sizeof(svo_info_section_t)));
+    assert(cd_start <= info_goffset && info_goffset <= data_start);
+
+    auto* info = reinterpret_cast<svo_info_section_t*>(tree->address_space + info_goffset);
+    info->cd_start_offset = info_goffset - cd_start;
+    info->data_offset = data_start - info_goffset;
+    info->data_entries = buffers && buffers->has_schema() ? buffers->entries() : 0;
+}
+
 svo_tree_t::svo_tree_t(std::size_t size, std::size_t block_size){
 
 
@@ -702,6 +786,39 @@ svo_tree_t::svo_tree_t(std::size_t size, std::size_t block_size){
     }
 }
 
+svo_tree_t::svo_tree_t(byte_t* address_space, std::size_t size)
+{
+    this->address_space_mem = 0;
+    this->address_space = address_space;
+    this->size = size;
+    this->root_block = 0;
+
+    std::size_t alignment = SVO_PAGE_SIZE;
+    assert( size % alignment == 0);
+    assert( (uintptr_t(address_space) % alignment) == 0 );
+
+    ///as above, the first page is never used.
+    auto initialfreemem = mem_range_t(alignment, size);
+    this->freemems[initialfreemem] = default_freemem_lookup_info();
+    this->update_freemem_lookup_info(initialfreemem);
+}
+
+svo_block_t* svo_tree_t::adopt_block(goffset_t block_start, goffset_t block_end)
+{
+    std::unique_ptr<svo_block_t> block(new svo_block_t());
+
+    this->mem_reserve(mem_range_t(block_start, block_end));
+
+    block->tree = this;
+    block->block_start = block_start;
+    block->block_end = block_end;
+
+    auto& block_lookup_info = this->blocks[block.get()];
+    block_lookup_info.freesize2block_iterator = freesize2block.end();
+    block_lookup_info.size2block_iterator = size2block.end();
+
+    return block.release();
+}
 
 svo_block_t* svo_tree_t::allocate_block(std::size_t size)
 {
@@ -731,6 +848,13 @@ svo_block_t* svo_tree_t::allocate_block(std::size_t size)
 
     block->info_goffset = block->cdspace_end;
 
+    ///the data section takes the rest of the block, after the info section.
+    goffset_t info_end = block->info_goffset + sizeof(svo_info_section_t);
+    block->data_start = (info_end + sizeof(child_descriptor_t) - 1) / sizeof(child_descriptor_t) * sizeof(child_descriptor_t);
+    block->data_end = block->data_start;
+    block->dataspace_end = block->block_end;
+    assert(block->data_start <= block->dataspace_end);
+    block->update_info_section();
 
     
     child_descriptor_t root_cd0; svo_init_cd(&root_cd0);
@@ -1337,9 +1461,6 @@ svo_error_t svo_block_initialize_slice_data(std::vector<svo_block_t*>& new_leaf_
         if (children.size() == 1)
             new_block->slice = children[0];
 
-
-        new_leaf_blocks.push_back(new_block);
-
     } else {
         assert(block->child_blocks);
 
@@ -2451,8 +2572,11 @@ void svo_join_slices(svo_slice_t* dst_slice, const std::array<svo_slice_t*, 8>&
     std::array<vcurvesize_t, 8> src_vcurve_adjustments;
 
     
-    ///copy data over to the destination slice
+    ///merge the data of the source slices into the destination slice
     {
+        std::vector<const svo_slice_t*> merge_slices(8, nullptr);
+        std::vector<vcurve_t> merge_offsets(8, 0);
+
         for (ccurve_t src_slice_corner = 0; src_slice_corner < 8; ++src_slice_corner)
         {
             const auto* src_slice = src_slices[src_slice_corner];
@@ -2466,9 +2590,7 @@ void svo_join_slices(svo_slice_t* dst_slice, const std::array<svo_slice_t*, 8>&
             assert(src_slice->buffers);
 
             assert( src_slice->parent_vcurve_begin >= dst_slice->parent_vcurve_begin );
-
-            const auto& src_pos_data = *src_slice->pos_data;
-            const auto& src_buffers = *src_slice->buffers;
+            assert(src_slice->buffers->schema() == dst_buffers.schema());
 
             ///the offset of this source slice in the the destination slice
             vcurve_t src_vcurve_adjustment = (src_slice->parent_vcurve_begin - dst_slice->parent_vcurve_begin)*8;
@@ -2476,55 +2598,13 @@ void svo_join_slices(svo_slice_t* dst_slice, const std::array<svo_slice_t*, 8>&
             ///cache this for later
             src_vcurve_adjustments[src_slice_corner] = src_vcurve_adjustment;
 
-
-            //std::cout << "----" << std::endl;
-
-            //std::cout << "src_slice_index: " << src_slice_index << std::endl;
-            //std::cout << "src_slice->parent_vcurve_begin: " << src_slice->parent_vcurve_begin << std::endl;
-            //std::cout << "dst_slice->parent_vcurve_begin: " << dst_slice->parent_vcurve_begin << std::endl;
-            //std::cout << "src_vcurve_adjustment: " << src_vcurve_adjustment << std::endl;
-            
-            
-            for (const vcurve_t vcurve : src_pos_data)
-            {
-
-                vcurve_t adjusted_vcurve = vcurve + src_vcurve_adjustment;
-
-                //std::cout << "  vcurve: " << vcurve << std::endl;
-                //std::cout << "  adjusted_vcurve: " << adjusted_vcurve << std::endl;
-                //std::cout << "  dst_data.back().vcurve: " << (dst_data.size() ? std::get<0>(dst_data.back()) : -1) << std::endl;
-                //std::cout << "  ---" << std::endl;
-
-                assert(adjusted_vcurve < vcurvesize(dst_slice->side));
-
-                if (dst_pos_data.size() > 0)
-                    assert( adjusted_vcurve > dst_pos_data.back());
-
-                dst_pos_data.push_back( adjusted_vcurve );
-            }
-            
-            assert(src_buffers.schema() == dst_buffers.schema());
-            
-            const auto& src_buffers_list = src_buffers.buffers();
-            auto& dst_buffers_list = dst_buffers.buffers();
-            
-            for (std::size_t buffer_index = 0; buffer_index < src_buffers_list.size(); ++buffer_index)
-            {
-                const auto& src_buffer = src_buffers_list[ buffer_index ];
-                auto& dst_buffer = dst_buffers_list[buffer_index];
-                
-                assert(src_buffer.entries() == src_pos_data.size());
-                assert(dst_buffer.declaration() == src_buffer.declaration());
-                
-                dst_buffer.append_buffer(src_buffer);
-                
-                //std::size_t output_byte_index = src_buffer.entries()*dst_channel.element_size;
-                //dst_channel.resize(dst_channel.size() + src_channel.size());
-                
-                ///copy the data over.
-                //std::memcpy(dst_channel.rawdata() + output_byte_index, src_channel.rawdata(), src_channel.size()*src_channel.element_size);
-            }
+            merge_slices[src_slice_corner] = src_slice;
+            merge_offsets[src_slice_corner] = src_vcurve_adjustment;
         }
+
+        ///the octants do not overlap, so this is a concatenation; each buffer is copied in 8 runs.
+        svo_merge_slice_data(dst_slice, merge_slices, merge_offsets);
+        assert(dst_pos_data.empty() || dst_pos_data.back() < vcurvesize(dst_slice->side));
     }
 
     ///attach the destination slice to the parent. detatch the src slices from the parent.
@@ -2670,113 +2750,169 @@ void svo_join_slices(svo_slice_t* dst_slice, const std::array<svo_slice_t*, 8>&
 }
 
 /**
- *
- *
+ * Overview:
+ * 1. split the children that straddle octants, so that each child lies within one octant.
+ * 2. copy the data of each octant to a destination slice.
+ * 3. replace the src slice in the parent with the destination slices.
+ * 4. connect the children of the src slice to the destination slices.
  */
-void svo_split_slice(svo_slice_t* src_slice, std::vector<svo_slice_t*>& new_slices, bool copyusedata)
+void svo_split_slice(svo_slice_t* src_slice, std::array<svo_slice_t*, 8>& dst_slices)
 {
-
     assert(src_slice);
     assert(src_slice->pos_data);
     assert(src_slice->buffers);
+    assert(src_slice->children);
     assert(src_slice->side > 1);
 
-    const auto& src_pos_data = *src_slice->pos_data;
-    const auto& src_buffers = *src_slice->buffers;
-    
+    DEBUG {
+        if(auto error = svo_slice_sanity(src_slice))
+        {
+            std::cerr << error << std::endl;
+            assert(false && "sanity failed");
+        }
+    }
+
     ///the size of the curve.
     vcurvesize_t size = vcurvesize(src_slice->side);
+    vside_t dst_side = src_slice->side / 2;
 
     ///size should be divisible into 8 parts, one for each octant.
     assert(size % 8 == 0);
-
     vcurvesize_t octant_size = size / 8;
+    assert(octant_size == vcurvesize(dst_side));
 
-    std::vector< svo_slice_t* > dst_slices;
+    auto* parent_slice = src_slice->parent_slice;
 
-    ///initialize the destination slices.
-    for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
+    ///each destination slice must still cover whole voxels of the parent.
+    assert(!parent_slice || dst_side > 1);
+
+    ///a child as large as the src slice straddles all the octants; it is split first, so that each of its
+    /// parts lies within one octant.
     {
-        void* userdata = copyusedata ? src_slice->userdata : 0;
+        auto& children = *src_slice->children;
+        for (std::size_t child_index = 0; child_index < children.size(); )
+        {
+            svo_slice_t* child = children[child_index];
+            assert(child);
+            assert(child->side <= src_slice->side * 2);
 
-        dst_slices.push_back( svo_init_slice(src_slice->level, src_slice->side / 2, userdata) );
-        svo_slice_t* dst_slice = dst_slices[ccurve];
-        assert(dst_slice);
-        dst_slice->side = src_slice->side / 2;
-        dst_slice->level = src_slice->level;
-        dst_slice->parent_slice = src_slice->parent_slice;
-        dst_slice->parent_vcurve_begin = src_slice->parent_vcurve_begin + (octant_size*ccurve);
-        
-        dst_slice->buffers->copy_schema(src_buffers);
-        
-    }
+            if (child->side <= src_slice->side)
+            {
+                ++child_index;
+                continue;
+            }
 
+            ///replaces the child in @c children with its parts.
+            std::array<svo_slice_t*, 8> child_parts;
+            svo_split_slice(child, child_parts);
+            svo_uninit_slice(child, false);
 
-    ///then split the actual data into 8 parts.
-    {
-        ///iterate through the source data and destination data simultaniously.
+            ///the parts are checked again in case they still straddle.
+        }
+    }
 
-        ///a pointer to the current source data voxel.
-        std::size_t data_index = 0;
+    ///find the voxels of each octant; they are already contiguous in a Morton ordered slice.
+    std::array<std::size_t, 9> octant_begin;
+    svo_partition_slice_data(src_slice, octant_begin);
 
-        ///while iterating through the destination data, we have to iterate through the destination
-        /// slice.
-        for (ccurve_t dst_ccurve = 0; dst_ccurve < 8; ++dst_ccurve)
-        {
-            ///for each destination slice,
-            svo_slice_t* dst_slice = dst_slices[dst_ccurve];
-            assert(dst_slice);
-            assert(dst_slice->pos_data);
-            assert(false && "TODO: handle channels");
-            auto& dst_pos_data = *dst_slice->pos_data;
-            
-            ///the first value in the curve for this corner's octant.
-            vcurvesize_t octant_parent_vcurve_begin = octant_size*(dst_ccurve);
-            assert(octant_parent_vcurve_begin == dst_slice->parent_vcurve_begin);
+    const auto& src_pos_data = *src_slice->pos_data;
+    const auto& src_buffers = *src_slice->buffers;
 
-            ///the last value (+1) in the curve for this corner's octant.
-            vcurvesize_t octant_parent_vcurve_end = octant_parent_vcurve_begin + octant_size;
-            assert(octant_parent_vcurve_end <= size);
+    ///the children of each octant.
+    std::array<svo_slice_t::children_t, 8> octant_children;
+    for (svo_slice_t* child : *src_slice->children)
+    {
+        assert(child->parent_slice == src_slice);
+        ccurve_t ccurve = ccurve_t(child->parent_vcurve_begin / octant_size);
+        assert(ccurve < 8);
+        assert(child->parent_vcurve_begin + vcurvesize(child->side) / 8 <= (ccurve + 1)*octant_size);
+        octant_children[ccurve].push_back(child);
+    }
 
-            ///iterate through the data, until done with this corner's octant within the souce data->
-            while (data_index < src_pos_data.size())
-            {
+    ///initialize the destination slices, and split the actual data into 8 parts; empty octants get no slice.
+    for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
+    {
+        std::size_t begin = octant_begin[ccurve];
+        std::size_t end = octant_begin[ccurve + 1];
 
-                vcurve_t vcurve = src_pos_data[data_index];
+        dst_slices[ccurve] = nullptr;
+        if (begin == end && octant_children[ccurve].empty())
+            continue;
 
-                assert(vcurve >= octant_parent_vcurve_begin);
+        svo_slice_t* dst_slice = svo_init_slice(src_slice->level, dst_side, src_slice->userdata, src_slice->arena);
+        dst_slices[ccurve] = dst_slice;
+        assert(dst_slice);
+        assert(dst_slice->pos_data);
 
-                ///if this voxel is outside the the octant, break and move to next destination slice.
-                if (!(vcurve < octant_parent_vcurve_end))
-                    break;
+        ///the position of the octant within the parent; a slice with no parent has no position.
+        dst_slice->parent_slice = parent_slice;
+        dst_slice->parent_vcurve_begin = parent_slice ? src_slice->parent_vcurve_begin + ccurve*(octant_size / 8) : 0;
 
-                ///next source data voxel
-                data_index++;
+        ///the first value in the curve for this corner's octant.
+        vcurve_t octant_vcurve_begin = octant_size*ccurve;
 
-                vcurve_t adjusted_vcurve = vcurve - octant_parent_vcurve_begin;
+        ///the vcurves are rebased to the octant, so they are copied.
+        auto& dst_pos_data = *dst_slice->pos_data;
+        dst_pos_data.reserve(end - begin);
+        for (std::size_t data_index = begin; data_index < end; ++data_index)
+            dst_pos_data.push_back( src_pos_data[data_index] - octant_vcurve_begin );
 
-                dst_pos_data.push_back( adjusted_vcurve );
+        ///the buffers are views of the octant's entries in the source buffers; nothing is copied
+        /// until one of the slices is written.
+        dst_slice->buffers->copy_schema(src_buffers);
+        const auto& src_buffers_list = src_buffers.buffers();
+        auto& dst_buffers_list = dst_slice->buffers->buffers();
+        for (std::size_t buffer_index = 0; buffer_index < src_buffers_list.size(); ++buffer_index)
+        {
+            dst_buffers_list[buffer_index] = src_buffers_list[buffer_index].view(begin, end - begin);
+            dst_buffers_list[buffer_index].set_arena(dst_slice->buffers->arena());
+        }
 
-            }
+        ///connect the children of the octant, rebased to the octant.
+        for (svo_slice_t* child : octant_children[ccurve])
+        {
+            child->parent_slice = dst_slice;
+            child->parent_vcurve_begin -= octant_vcurve_begin;
+            dst_slice->children->push_back(child);
         }
     }
+    src_slice->children->clear();
 
-    ///if there is a parent slice attached, replace the parent's child reference with
-    /// the (up to) 8 children.
+    ///replace the src slice in the parent with the destination slices; they cover the range of the src
+    /// slice, so they go where it was, in morton order.
+    if (parent_slice)
     {
-        assert(false && "TODO");
+        auto& parent_children = *parent_slice->children;
+        auto w = std::find(parent_children.begin(), parent_children.end(), src_slice);
+        assert(w != parent_children.end() && "source slice was not found as a child of the parent ...");
+
+        std::size_t child_index = w - parent_children.begin();
+        parent_children.erase(w);
+        for (svo_slice_t* dst_slice : dst_slices)
+        {
+            if (!dst_slice)
+                continue;
+            parent_children.insert(parent_children.begin() + child_index, dst_slice);
+            ++child_index;
+        }
     }
 
+    src_slice->parent_slice = 0;
+    src_slice->parent_vcurve_begin = 0;
 
-    ///if there are child slices connected, they must not straddle across octants.
-    ///if they do straddle (i.e if there is 1 child slice for example); then it must be split as well.
-    ///if they do not straddle the octants, we divy them up to their new parents. 
-    {
-        assert(false && "TODO");
+    ///check sanity.
+    DEBUG {
+        for (svo_slice_t* dst_slice : dst_slices)
+        {
+            if (!dst_slice)
+                continue;
+            if(auto error = svo_slice_sanity(dst_slice))
+            {
+                std::cerr << error << std::endl;
+                assert(false && "sanity failed");
+            }
+        }
     }
-
-    ///record the new slices.
-    new_slices.insert(new_slices.end(), dst_slices.begin(), dst_slices.end());
 }
 
 
@@ -0,0 +1,67 @@
+#include "landscapes/svo_tree.lod.hpp"
+
+#include "format.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+namespace svo{
+
+svo_lod_controller_t::svo_lod_controller_t(float base_ray_scale2, double target_frame_ms, float min_quality)
+    : base_ray_scale2(base_ray_scale2)
+    , target_frame_ms(target_frame_ms)
+    , min_quality(min_quality)
+    , dead_band(.05)
+    , gain(.5)
+    , smoothing(.25)
+    , quality(1)
+    , smoothed_frame_ms(0)
+{
+    if (!(base_ray_scale2 > 0))
+        throw std::runtime_error(fmt::format("invalid base_ray_scale2: {}", base_ray_scale2));
+    if (!(target_frame_ms > 0))
+        throw std::runtime_error(fmt::format("invalid target_frame_ms: {}", target_frame_ms));
+    if (!(min_quality > 0 && min_quality <= 1))
+        throw std::runtime_error(fmt::format("min_quality must be in (0,1], min_quality: {}", min_quality));
+}
+
+void svo_lod_controller_t::reset()
+{
+    quality = 1;
+    smoothed_frame_ms = 0;
+}
+
+float svo_lod_controller_t::update(double frame_ms)
+{
+    if (!(frame_ms > 0))
+        return ray_scale2();
+
+    if (smoothed_frame_ms == 0)
+        smoothed_frame_ms = frame_ms;
+    else
+        smoothed_frame_ms = smoothing*frame_ms + (1 - smoothing)*smoothed_frame_ms;
+
+    double ratio = target_frame_ms / smoothed_frame_ms;
+
+    if (std::abs(ratio - 1) > dead_band)
+    {
+        ///the traversal cost grows roughly with the number of levels descended, which grows with
+        /// log(rayScale2); so adjust multiplicatively, and only by part of the error.
+        double step = std::pow(ratio, gain);
+        quality = float(std::min<double>(1, std::max<double>(min_quality, quality*step)));
+    }
+
+    return ray_scale2();
+}
+
+float svo_lod_controller_t::ray_scale2() const
+{
+    return base_ray_scale2 * quality;
+}
+
+uint32_t svo_lod_controller_t::max_level(float distance) const
+{
+    return svo_lod_max_level(distance, ray_scale2());
+}
+
+} // namespace svo
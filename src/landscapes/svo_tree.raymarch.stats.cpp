@@ -0,0 +1,214 @@
+#include "landscapes/svo_tree.raymarch.stats.hpp"
+
+#include "format.h"
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+namespace svo{
+
+uint32_t svo_raymarch_stats_get(const svo_raymarch_stats_t& stats, svo_raymarch_metric_t metric)
+{
+    switch (metric)
+    {
+        case svo_raymarch_metric_t::iterations:
+            return stats.iterations;
+        case svo_raymarch_metric_t::max_depth:
+            return stats.max_depth;
+        case svo_raymarch_metric_t::cd_fetches:
+            return stats.cd_fetches;
+        case svo_raymarch_metric_t::far_ptr_follows:
+            return stats.far_ptr_follows;
+        case svo_raymarch_metric_t::pushes:
+            return stats.pushes;
+        case svo_raymarch_metric_t::pops:
+            return stats.pops;
+    }
+    assert(false && "unknown metric");
+    return 0;
+}
+
+static const char* svo_raymarch_metric_name(svo_raymarch_metric_t metric)
+{
+    switch (metric)
+    {
+        case svo_raymarch_metric_t::iterations:
+            return "iterations";
+        case svo_raymarch_metric_t::max_depth:
+            return "max_depth";
+        case svo_raymarch_metric_t::cd_fetches:
+            return "cd_fetches";
+        case svo_raymarch_metric_t::far_ptr_follows:
+            return "far_ptr_follows";
+        case svo_raymarch_metric_t::pushes:
+            return "pushes";
+        case svo_raymarch_metric_t::pops:
+            return "pops";
+    }
+    return "unknown";
+}
+
+
+
+svo_raymarch_histogram_t::svo_raymarch_histogram_t(std::size_t bin_count)
+    : bins(bin_count, 0)
+    , samples(0), sum(0), max(0)
+{
+    if (bin_count == 0)
+        throw std::runtime_error("svo_raymarch_histogram_t needs at least one bin");
+}
+
+void svo_raymarch_histogram_t::add(uint32_t value)
+{
+    std::size_t bin = std::min<std::size_t>(value, bins.size() - 1);
+    bins[bin]++;
+    samples++;
+    sum += value;
+    max = std::max(max, value);
+}
+
+void svo_raymarch_histogram_t::reset()
+{
+    std::fill(bins.begin(), bins.end(), 0);
+    samples = 0;
+    sum = 0;
+    max = 0;
+}
+
+double svo_raymarch_histogram_t::mean() const
+{
+    if (samples == 0)
+        return 0;
+    return double(sum) / double(samples);
+}
+
+uint32_t svo_raymarch_histogram_t::percentile(double fraction) const
+{
+    assert(fraction >= 0 && fraction <= 1);
+    if (samples == 0)
+        return 0;
+
+    std::size_t needed = std::max<std::size_t>(1, std::size_t(fraction * samples + .5));
+    std::size_t seen = 0;
+    for (std::size_t bin = 0; bin < bins.size(); ++bin)
+    {
+        seen += bins[bin];
+        if (seen >= needed)
+            return uint32_t(bin);
+    }
+    return uint32_t(bins.size() - 1);
+}
+
+
+
+svo_raymarch_frame_stats_t::svo_raymarch_frame_stats_t(std::size_t bin_count)
+    : rays(0), hits(0)
+    , histograms(svo_raymarch_metric_count, svo_raymarch_histogram_t(bin_count))
+{
+
+}
+
+void svo_raymarch_frame_stats_t::add(const svo_raymarch_stats_t& stats)
+{
+    rays++;
+    hits += stats.hit ? 1 : 0;
+
+    for (std::size_t i = 0; i < svo_raymarch_metric_count; ++i)
+        histograms[i].add(svo_raymarch_stats_get(stats, svo_raymarch_metric_t(i)));
+}
+
+void svo_raymarch_frame_stats_t::reset()
+{
+    rays = 0;
+    hits = 0;
+    for (auto& histogram : histograms)
+        histogram.reset();
+}
+
+const svo_raymarch_histogram_t& svo_raymarch_frame_stats_t::histogram(svo_raymarch_metric_t metric) const
+{
+    std::size_t i = std::size_t(metric);
+    assert(i < histograms.size());
+    return histograms[i];
+}
+
+
+::std::ostream& operator<<(::std::ostream& out, const svo_raymarch_frame_stats_t& frame_stats)
+{
+    out << fmt::format("rays: {}, hits: {}", frame_stats.rays, frame_stats.hits) << std::endl;
+
+    for (std::size_t i = 0; i < svo_raymarch_metric_count; ++i)
+    {
+        auto metric = svo_raymarch_metric_t(i);
+        const auto& histogram = frame_stats.histogram(metric);
+        out << fmt::format("  {}: mean: {:.2f}, p50: {}, p90: {}, p99: {}, max: {}"
+                            , svo_raymarch_metric_name(metric)
+                            , histogram.mean()
+                            , histogram.percentile(.5), histogram.percentile(.9), histogram.percentile(.99)
+                            , histogram.max)
+            << std::endl;
+    }
+    return out;
+}
+
+
+
+svo_raymarch_heatmap_t::svo_raymarch_heatmap_t(std::size_t width, std::size_t height)
+    : width(width), height(height)
+    , pixels(width*height)
+{
+    reset();
+}
+
+svo_raymarch_stats_t& svo_raymarch_heatmap_t::at(std::size_t x, std::size_t y)
+{
+    assert(x < width && y < height);
+    return pixels[y*width + x];
+}
+
+const svo_raymarch_stats_t& svo_raymarch_heatmap_t::at(std::size_t x, std::size_t y) const
+{
+    assert(x < width && y < height);
+    return pixels[y*width + x];
+}
+
+void svo_raymarch_heatmap_t::reset()
+{
+    for (auto& pixel : pixels)
+        svo_raymarch_stats_init(&pixel);
+}
+
+void svo_raymarch_heatmap_t::aggregate(svo_raymarch_frame_stats_t& frame_stats) const
+{
+    for (const auto& pixel : pixels)
+        frame_stats.add(pixel);
+}
+
+void svo_raymarch_heatmap_t::write_ppm(std::ostream& out, svo_raymarch_metric_t metric, uint32_t max_value) const
+{
+    if (max_value == 0)
+    {
+        for (const auto& pixel : pixels)
+            max_value = std::max(max_value, svo_raymarch_stats_get(pixel, metric));
+        max_value = std::max<uint32_t>(max_value, 1);
+    }
+
+    out << "P6\n" << width << " " << height << "\n255\n";
+
+    for (const auto& pixel : pixels)
+    {
+        uint32_t value = std::min(svo_raymarch_stats_get(pixel, metric), max_value);
+        float t = float(value) / float(max_value);
+
+        ///blue => green => red
+        float r = std::max(0.f, 2*t - 1);
+        float b = std::max(0.f, 1 - 2*t);
+        float g = 1 - r - b;
+
+        char rgb[3] = { char(uint8_t(r*255 + .5f)), char(uint8_t(g*255 + .5f)), char(uint8_t(b*255 + .5f)) };
+        out.write(rgb, 3);
+    }
+}
+
+} // namespace svo
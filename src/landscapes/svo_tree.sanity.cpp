@@ -6,6 +6,8 @@
 #include "format.h"
 #include <iostream>
 #include <tuple>
+#include <vector>
+#include <future>
 
 
 namespace svo{
@@ -1049,6 +1051,81 @@ svo_slice_sanity_error_t svo_slice_sanity(
 
 
 
+::std::ostream& operator<<(::std::ostream& out, const svo::svo_sanity_report_t& report)
+{
+    out << fmt::format("blocks checked: {}, slices checked: {}, block errors: {}, slice errors: {}"
+                        , report.blocks_checked, report.slices_checked
+                        , report.block_errors.size(), report.slice_errors.size());
+    for (const auto& error : report.block_errors)
+        out << std::endl << "  block error: " << error;
+    for (const auto& error : report.slice_errors)
+        out << std::endl << "  slice error: " << error;
+    return out;
+}
+
+svo_sanity_report_t svo_validate_blocks(const svo_block_t* root_block)
+{
+    svo_sanity_report_t report;
+    if (!root_block)
+        return report;
+
+    std::vector<const svo_block_t*> stack{root_block};
+    while (stack.size() > 0)
+    {
+        const svo_block_t* block = stack.back(); stack.pop_back();
+
+        report.blocks_checked++;
+        if (auto error = svo_block_sanity_check(block, 0/*recurse*/))
+        {
+            report.block_errors.push_back(error);
+            ///don't descend into a block we can't trust.
+            continue;
+        }
+
+        for (const svo_block_t* child_block : *block->child_blocks)
+            stack.push_back(child_block);
+    }
+    return report;
+}
+
+svo_sanity_report_t svo_validate_slices(const svo_slice_t* root_slice, svo_sanity_type_t sanity_type)
+{
+    svo_sanity_report_t report;
+    if (!root_slice)
+        return report;
+
+    ///each slice is checked against its children, so there is no need for the checks to recurse themselves.
+    std::vector<const svo_slice_t*> stack{root_slice};
+    while (stack.size() > 0)
+    {
+        const svo_slice_t* slice = stack.back(); stack.pop_back();
+
+        report.slices_checked++;
+        if (auto error = svo_slice_sanity(slice, sanity_type, 0/*recurse*/, false/*parent_recurse*/))
+        {
+            report.slice_errors.push_back(error);
+            continue;
+        }
+
+        for (const svo_slice_t* child_slice : *slice->children)
+            stack.push_back(child_slice);
+    }
+    return report;
+}
+
+std::future<svo_sanity_report_t> svo_validate_async(const svo_block_t* root_block, const svo_slice_t* root_slice
+    , svo_sanity_type_t sanity_type)
+{
+    return std::async(std::launch::async, [root_block, root_slice, sanity_type]()
+    {
+        svo_sanity_report_t report = svo_validate_blocks(root_block);
+        svo_sanity_report_t slice_report = svo_validate_slices(root_slice, sanity_type);
+
+        report.slices_checked = slice_report.slices_checked;
+        report.slice_errors = std::move(slice_report.slice_errors);
+        return report;
+    });
+}
 
 
 
@@ -1,3 +1,4 @@
+#define SVO_MODULE_CHECK_LEVEL SVO_CHECK_LEVEL_SLICE_MGMT
 
 #include "landscapes/svo_tree.slice_mgmt.hpp"
 
@@ -129,7 +130,7 @@ flush()
 
     result = result / float(siblings.size());
     
-    T& out_data = element_view.template get<T>(out_entry_index++);
+    T& out_data = element_view[out_entry_index++];
     out_data = result;
     
     siblings.clear();
@@ -224,9 +225,11 @@ void svo_downsample_slice(svo_slice_t* parent_slice, const svo_slice_t* child_sl
     {
         if (dst_buffers.has_named_element(element_name))
         {
-            const auto& src_color_element = src_buffers.get_element_view(element_name);
+            ///the schemas are the same, so one handle serves both.
+            auto handle = src_buffers.get_element_handle<float3_t>(element_name);
+            auto src_color_element = src_buffers.get_element_view(handle);
             
-            auto dst_color_element = dst_buffers.get_element_view(element_name);
+            auto dst_color_element = dst_buffers.get_element_view(handle);
 
             
             auto avg_downsampler = make_avg_downsampler<float3_t>(child_slice->parent_vcurve_begin, dst_color_element, out_data_index);
@@ -235,7 +238,7 @@ void svo_downsample_slice(svo_slice_t* parent_slice, const svo_slice_t* child_sl
             {
                 vcurve_t vcurve = src_pos_data[in_data_index];
                 
-                const float3_t& raw_color = src_color_element.get<float3_t>(in_data_index);
+                const float3_t& raw_color = src_color_element[in_data_index];
 
                 avg_downsampler.append(vcurve, raw_color);
 
@@ -262,7 +265,7 @@ void svo_downsample_slice(svo_slice_t* parent_slice, const svo_slice_t* child_sl
 
 
 
-svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::size_t max_voxels_per_slice, std::size_t root_level)
+svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::size_t max_voxels_per_slice, std::size_t root_level, svo_arena_t* arena)
 {
     assert(volume_of_slices.volume_side % 2 == 0);
 
@@ -306,7 +309,7 @@ svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::
 
 
 
-            svo_slice_t* slice = svo_clone_slice(slice0);
+            svo_slice_t* slice = svo_clone_slice(slice0, true, arena);
             assert(slice->side == volume_of_slices.slice_side);
             
             
@@ -375,7 +378,7 @@ svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::
             if (next_level.slices.size() == 0 || std::get<0>(next_level.slices.back()) != parent_slice_vcurve)
             {
                 ///insert the parent.
-                svo_slice_t* parent_slice = svo_init_slice(0, parent_side);
+                svo_slice_t* parent_slice = svo_init_slice(0, parent_side, 0, arena);
                 
                 
                 DEBUG {
@@ -468,7 +471,7 @@ svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::
     if (current_level.slices.size() == 0)
     {
         ///return an empty root slice.
-        svo_slice_t* root_slice = svo_init_slice(root_level, 1);
+        svo_slice_t* root_slice = svo_init_slice(root_level, 1, 0, arena);
         return root_slice;
     }
 
@@ -599,7 +602,7 @@ svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::
 
 
     ///combine slices together with their siblings if they all add up to less than the slice limit.
-    auto squeeze_a_tree_slice = [max_voxels_per_slice](svo_slice_t* current_slice){
+    auto squeeze_a_tree_slice = [max_voxels_per_slice, arena](svo_slice_t* current_slice){
 
         assert(current_slice);
         assert(current_slice->children);
@@ -634,7 +637,7 @@ svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::
 
                 if (total_child_size < max_voxels_per_slice)
                 {
-                    svo_slice_t* new_replacement_slice = svo_init_slice(current_slice->level + 1, current_slice->side*2);
+                    svo_slice_t* new_replacement_slice = svo_init_slice(current_slice->level + 1, current_slice->side*2, 0, arena);
 
 
                     for (svo_slice_t* child : group.group_children)
@@ -689,7 +692,7 @@ svo_slice_t* svo_entree_slices(const volume_of_slices_t& volume_of_slices, std::
         assert( root_slice->side % 2 == 0);
         vside_t next_root_slice_side = root_slice->side / 2;
 
-        svo_slice_t* next_root_slice = svo_init_slice(0, next_root_slice_side);
+        svo_slice_t* next_root_slice = svo_init_slice(0, next_root_slice_side, 0, arena);
 
         assert(next_root_slice);
         assert(next_root_slice->children);
@@ -0,0 +1,235 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_archive.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <sstream>
+#include <string>
+
+struct ArchiveTest : public ::testing::Test {
+    const svo::svo_slice_t* root0;
+protected:
+
+    svo::svo_slice_t* m_root0;
+
+    static svo::svo_slice_t* make_slice(std::size_t level, vside_t side, vcurve_t stride)
+    {
+        svo::svo_slice_t* slice = svo::svo_init_slice(level, side);
+        for (vcurve_t vcurve = 0; vcurve < vcurvesize(side); vcurve += stride)
+            slice->pos_data->push_back(vcurve);
+
+        svo::svo_declaration_t declaration;
+        declaration.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::UNSIGNED_BYTE, 3));
+        auto& buffer = slice->buffers->add_buffer(declaration, slice->pos_data->size());
+        for (std::size_t byte_index = 0; byte_index < buffer.bytes(); ++byte_index)
+            buffer.rawdata()[byte_index] = uint8_t(byte_index + level);
+        return slice;
+    }
+
+    virtual void SetUp() {
+        ///root => two children => one grandchild under the second child.
+        m_root0 = make_slice(0, 4, 1);
+
+        svo::svo_slice_t* child0 = make_slice(1, 2, 1);
+        svo::svo_slice_t* child1 = make_slice(1, 4, 3);
+        svo::svo_slice_t* grandchild = make_slice(2, 4, 2);
+
+        svo::svo_slice_attach_child(m_root0, child0, 0);
+        svo::svo_slice_attach_child(m_root0, child1, 8);
+        svo::svo_slice_attach_child(child1, grandchild, 8);
+
+        root0 = m_root0;
+    }
+
+    virtual void TearDown() {
+        svo::svo_uninit_slice(m_root0, true);
+    }
+
+    static void expect_same_slice(const svo::svo_slice_t* slice0, const svo::svo_slice_t* slice1)
+    {
+        EXPECT_EQ(slice0->level, slice1->level);
+        EXPECT_EQ(slice0->side, slice1->side);
+        EXPECT_EQ(*slice0->pos_data, *slice1->pos_data);
+        ASSERT_EQ(slice0->buffers->schema(), slice1->buffers->schema());
+    }
+};
+
+
+TEST_F(ArchiveTest,index)
+{
+    std::stringstream archive_data;
+    ///a prefix, to check that the archive does not need to start the stream.
+    archive_data << "prefix";
+    svo::svo_write_archive(archive_data, root0);
+
+    archive_data.seekg(6);
+    svo::svo_archive_t archive(archive_data);
+
+    ASSERT_EQ(archive.size(), 4U);
+
+    const auto& root_entry = archive.entry(0);
+    EXPECT_EQ(root_entry.parent_id, svo::invalid_slice_id);
+    EXPECT_EQ(root_entry.side, vside_t(4));
+    ASSERT_EQ(root_entry.children.size(), 2U);
+
+    svo::svo_slice_id_t child1_id = archive.find_child(0, 8);
+    ASSERT_NE(child1_id, svo::invalid_slice_id);
+    EXPECT_EQ(archive.entry(child1_id).side, vside_t(4));
+    EXPECT_EQ(archive.entry(child1_id).parent_id, 0U);
+    EXPECT_EQ(archive.find_child(0, 1), svo::invalid_slice_id);
+
+    ASSERT_EQ(archive.entry(child1_id).children.size(), 1U);
+    svo::svo_slice_id_t grandchild_id = archive.entry(child1_id).children[0];
+    EXPECT_EQ(archive.entry(grandchild_id).level, 2U);
+    EXPECT_EQ(archive.entry(grandchild_id).parent_vcurve_begin, vcurve_t(8));
+
+    EXPECT_THROW(archive.entry(4), std::runtime_error);
+}
+
+TEST_F(ArchiveTest,load_lazily)
+{
+    std::stringstream archive_data;
+    svo::svo_write_archive(archive_data, root0);
+
+    svo::svo_archive_t archive(archive_data);
+
+    ///only the grandchild, with a single seek.
+    const svo::svo_slice_t* grandchild0 = (*(*root0->children)[1]->children)[0];
+    svo::svo_slice_id_t grandchild_id = archive.entry(archive.find_child(0, 8)).children[0];
+
+    svo::svo_slice_t* grandchild1 = svo::svo_init_slice(2, archive.entry(grandchild_id).side);
+    archive.load_slice(grandchild_id, grandchild1, true);
+    expect_same_slice(grandchild0, grandchild1);
+    svo::svo_uninit_slice(grandchild1, true);
+
+    ///the root and its children, but not the grandchild.
+    svo::svo_slice_t* root1 = archive.load_subtree(0, 1);
+    expect_same_slice(root0, root1);
+    ASSERT_EQ(root1->children->size(), 2U);
+    expect_same_slice((*root0->children)[1], (*root1->children)[1]);
+    EXPECT_EQ((*root1->children)[1]->parent_vcurve_begin, vcurve_t(8));
+    EXPECT_EQ((*root1->children)[1]->children->size(), 0U);
+    svo::svo_uninit_slice(root1, true);
+}
+
+TEST_F(ArchiveTest,load_subtree)
+{
+    std::stringstream archive_data;
+    svo::svo_serialization_options_t options;
+    options.pos_encoding = svo::svo_pos_encoding_t::delta_varint;
+    svo::svo_write_archive(archive_data, root0, options);
+
+    svo::svo_archive_t archive(archive_data);
+
+    svo::svo_slice_t* root1 = archive.load_subtree(0);
+
+    expect_same_slice(root0, root1);
+    ASSERT_EQ(root1->children->size(), 2U);
+    expect_same_slice((*root0->children)[0], (*root1->children)[0]);
+    expect_same_slice((*root0->children)[1], (*root1->children)[1]);
+    ASSERT_EQ((*root1->children)[1]->children->size(), 1U);
+    expect_same_slice((*(*root0->children)[1]->children)[0], (*(*root1->children)[1]->children)[0]);
+
+    svo::svo_uninit_slice(root1, true);
+}
+
+#ifdef SVO_VCURVE_64
+TEST_F(ArchiveTest,load_wide_subtree)
+{
+    ///a child slice wider than 256, which needs 64 bit vcurves, covering the whole root.
+    svo::svo_slice_t* root = make_slice(0, 256, 4096);
+    svo::svo_slice_t* child = make_slice(1, 512, 8*4096*4);
+    svo::svo_slice_attach_child(root, child, 0);
+
+    std::stringstream archive_data;
+    svo::svo_write_archive(archive_data, root);
+
+    svo::svo_archive_t archive(archive_data);
+    ASSERT_EQ(archive.size(), 2U);
+
+    svo::svo_slice_t* root1 = archive.load_subtree(0);
+    expect_same_slice(root, root1);
+    ASSERT_EQ(root1->children->size(), 1U);
+    expect_same_slice(child, (*root1->children)[0]);
+    EXPECT_EQ((*root1->children)[0]->side, 512U);
+
+    svo::svo_uninit_slice(root1, true);
+    svo::svo_uninit_slice(root, true);
+}
+#endif
+
+TEST_F(ArchiveTest,bad_magic)
+{
+    std::stringstream archive_data("not an archive");
+    EXPECT_THROW(svo::svo_archive_t archive(archive_data), std::runtime_error);
+}
+
+TEST_F(ArchiveTest,corrupt_index)
+{
+    std::stringstream archive_data;
+    svo::svo_write_archive(archive_data, root0);
+
+    ///the index is at the end; flip a bit in its last field, the last slice's children count.
+    std::string corrupt = archive_data.str();
+    corrupt[corrupt.size() - 1] ^= 0x01;
+
+    std::stringstream corrupt_data(corrupt);
+    EXPECT_THROW(svo::svo_archive_t archive(corrupt_data), std::runtime_error);
+
+    ///without verification, the count running past the index is still caught by the structural checks.
+    std::stringstream unverified_data(corrupt);
+    EXPECT_THROW(svo::svo_archive_t archive(unverified_data, false), std::runtime_error);
+}
+
+TEST_F(ArchiveTest,bad_tree)
+{
+    std::stringstream archive_data;
+    svo::svo_write_archive(archive_data, root0);
+    const std::string data = archive_data.str();
+
+    ///the index ends with the grandchild (id 3; offset, size, level, side, parent_vcurve_begin, parent id
+    /// and no children), preceded by the only child id of its parent, 2.
+    static const std::size_t LAST_ENTRY_SIZE = 8 + 8 + 4*5;
+    std::size_t parent_id_offset = data.size() - 8;
+    std::size_t child_id_offset = data.size() - LAST_ENTRY_SIZE - 4;
+    ASSERT_EQ(data[parent_id_offset + 3], 2);
+    ASSERT_EQ(data[child_id_offset + 3], 3);
+
+    auto expect_rejected = [&](std::size_t offset, char value)
+    {
+        std::string corrupt = data;
+        corrupt[offset + 3] = value;
+
+        ///skip the checksums, so only the tree checks can catch it.
+        std::stringstream corrupt_data(corrupt);
+        EXPECT_THROW(svo::svo_archive_t archive(corrupt_data, false), std::runtime_error)
+            << "offset: " << offset << ", value: " << int(value);
+    };
+
+    ///a slice that is its own parent, or the child of a later slice.
+    expect_rejected(parent_id_offset, 3);
+    ///a child that loops back to the root, or that is not the child of its parent.
+    expect_rejected(child_id_offset, 0);
+    expect_rejected(child_id_offset, 1);
+
+    ///the grandchild is at level 2, with side 4, at 8 within its parent, of side 4.
+    std::size_t level_offset = data.size() - 20;
+    std::size_t side_offset = data.size() - 16;
+    std::size_t parent_vcurve_begin_offset = data.size() - 12;
+    ASSERT_EQ(data[level_offset + 3], 2);
+    ASSERT_EQ(data[side_offset + 3], 4);
+    ASSERT_EQ(data[parent_vcurve_begin_offset + 3], 8);
+
+    ///a child that is not one level below its parent.
+    expect_rejected(level_offset, 3);
+    ///a side that is not a power of two, or more than twice its parent's.
+    expect_rejected(side_offset, 3);
+    expect_rejected(side_offset, 16);
+    ///a position past the end of the parent, or not aligned to the child's size.
+    expect_rejected(parent_vcurve_begin_offset, 64);
+    expect_rejected(parent_vcurve_begin_offset, 9);
+
+    std::stringstream valid_data(data);
+    svo::svo_archive_t archive(valid_data, false);
+    EXPECT_EQ(archive.size(), 4U);
+}
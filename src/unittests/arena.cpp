@@ -0,0 +1,110 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_arena.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <cstdint>
+#include <memory>
+
+struct ArenaTest : public ::testing::Test {
+protected:
+
+    svo::svo_declaration_t m_declaration;
+
+    virtual void SetUp() {
+        m_declaration.add(svo::svo_element_t("id", svo::svo_semantic_t::NONE, svo::svo_data_type_t::UNSIGNED_INT, 1));
+    }
+};
+
+
+TEST_F(ArenaTest,allocate)
+{
+    svo::svo_arena_t arena(1024);
+
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0U);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(arena.chunks(), 1U);
+
+    ///a large allocation gets its own chunk, and the small ones keep using the first.
+    arena.allocate(4096);
+    EXPECT_EQ(arena.chunks(), 2U);
+    arena.allocate(16);
+    EXPECT_EQ(arena.chunks(), 2U);
+    EXPECT_EQ(arena.bytes_allocated(), 3U + 8U + 4096U + 16U);
+
+    arena.release();
+    EXPECT_EQ(arena.chunks(), 0U);
+    EXPECT_EQ(arena.bytes_allocated(), 0U);
+
+    std::vector<int, svo::svo_arena_allocator_t<int> > values{svo::svo_arena_allocator_t<int>(&arena)};
+    for (int i = 0; i < 1000; ++i)
+        values.push_back(i);
+    EXPECT_EQ(values[999], 999);
+    EXPECT_GT(arena.chunks(), 0U);
+}
+
+TEST_F(ArenaTest,slices)
+{
+    svo::svo_arena_t arena;
+
+    svo::svo_slice_t* slice = svo::svo_init_slice(0, 4, 0, &arena);
+    EXPECT_EQ(slice->arena, &arena);
+    EXPECT_EQ(slice->buffers->arena(), &arena);
+
+    *slice->pos_data = {1, 9, 17, 60};
+    slice->buffers->add_buffer(m_declaration, 4);
+    EXPECT_EQ(slice->buffers->buffers()[0].arena(), &arena);
+    auto ids = slice->buffers->get_element_view("id");
+    for (std::size_t i = 0; i < 4; ++i)
+        ids.get<uint32_t>(i) = uint32_t(i);
+
+    ///clones into another arena are allocated from it, including the copies made on write.
+    svo::svo_arena_t clone_arena;
+    svo::svo_slice_t* clone = svo::svo_clone_slice(slice, true, &clone_arena);
+    EXPECT_EQ(clone->arena, &clone_arena);
+    clone->buffers->get_element_view("id").get<uint32_t>(3) = 7;
+    EXPECT_EQ(clone->buffers->buffers()[0].arena(), &clone_arena);
+    EXPECT_EQ(slice->buffers->get_element_view("id").get<uint32_t>(3), 3U);
+
+    std::size_t bytes = arena.bytes_allocated();
+    svo::svo_uninit_slice(clone, true);
+    svo::svo_uninit_slice(slice, true);
+    EXPECT_EQ(arena.bytes_allocated(), bytes);
+}
+
+TEST_F(ArenaTest,release_with_heap_clone)
+{
+    std::unique_ptr<svo::svo_arena_t> arena(new svo::svo_arena_t());
+
+    svo::svo_slice_t* slice = svo::svo_init_slice(0, 4, 0, arena.get());
+    *slice->pos_data = {1, 9, 17, 60};
+    slice->buffers->add_buffer(m_declaration, 4);
+    auto ids = slice->buffers->get_element_view("id");
+    for (std::size_t i = 0; i < 4; ++i)
+        ids.get<uint32_t>(i) = uint32_t(i);
+
+    ///a heap clone does not share the arena's storage, and a view moved to the heap is copied.
+    svo::svo_slice_t* clone = svo::svo_clone_slice(slice, true, nullptr);
+    EXPECT_FALSE(clone->buffers->buffers()[0].shared());
+    EXPECT_EQ(clone->buffers->buffers()[0].arena(), nullptr);
+
+    svo::svo_cpu_buffer_t view = slice->buffers->buffers()[0].view(1, 2);
+    EXPECT_TRUE(view.shared());
+    view.set_arena(nullptr);
+    EXPECT_FALSE(view.shared());
+
+    svo::svo_uninit_slice(slice, true);
+    arena.reset();
+
+    ///the clone and the view are still usable after the arena is gone.
+    auto clone_ids = clone->buffers->get_element_view("id");
+    for (std::size_t i = 0; i < 4; ++i)
+        EXPECT_EQ(clone_ids.get<uint32_t>(i), uint32_t(i));
+    clone_ids.get<uint32_t>(3) = 7;
+    EXPECT_EQ(clone_ids.get<uint32_t>(3), 7U);
+    EXPECT_EQ(reinterpret_cast<const uint32_t*>(view.rawdata())[1], 2U);
+
+    svo::svo_uninit_slice(clone, true);
+}
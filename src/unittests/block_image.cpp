@@ -0,0 +1,243 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_block_image.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <memory>
+#include <cstring>
+#include <cstdio>
+
+struct BlockImageTest : public ::testing::Test {
+    svo::svo_tree_t* tree0;
+protected:
+
+    std::unique_ptr<svo::svo_tree_t> m_tree0;
+
+    virtual void SetUp() {
+        std::size_t block_size = SVO_PAGE_SIZE*4;
+        std::size_t tree_size = SVO_PAGE_SIZE + 4*block_size;
+
+        m_tree0.reset(new svo::svo_tree_t(tree_size, block_size));
+        tree0 = m_tree0.get();
+
+        ///a child block, and some recognizable bytes in both blocks.
+        svo::svo_block_t* child_block = tree0->allocate_block(block_size);
+        child_block->parent_block = tree0->root_block;
+        child_block->root_level = 3;
+        child_block->side = 8;
+        tree0->root_block->child_blocks->push_back(child_block);
+
+        for (const svo::svo_block_t* block : {tree0->root_block, child_block})
+        {
+            for (goffset_t goffset = block->cd_end; goffset < block->block_end; ++goffset)
+                tree0->address_space[goffset] = byte_t(goffset * 7);
+        }
+    }
+
+    virtual void TearDown() {
+        for (auto& child_block : *tree0->root_block->child_blocks)
+            delete child_block;
+        delete tree0->root_block;
+    }
+
+    void expect_same_tree(const svo::svo_tree_t* tree1)
+    {
+        ASSERT_EQ(tree0->size, tree1->size);
+        ASSERT_EQ(tree0->blocks.size(), tree1->blocks.size());
+
+        const svo::svo_block_t* block0 = tree0->root_block;
+        const svo::svo_block_t* block1 = tree1->root_block;
+        ASSERT_TRUE(block1);
+        EXPECT_TRUE(block1->trunk);
+        ASSERT_EQ(block1->child_blocks->size(), 1U);
+
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            EXPECT_EQ(block0->block_start, block1->block_start);
+            EXPECT_EQ(block0->block_end, block1->block_end);
+            EXPECT_EQ(block0->cd_end, block1->cd_end);
+            EXPECT_EQ(block0->root_shadow_cd_goffset, block1->root_shadow_cd_goffset);
+            EXPECT_EQ(block0->root_level, block1->root_level);
+            EXPECT_EQ(block0->side, block1->side);
+            EXPECT_EQ(block1->tree, tree1);
+            EXPECT_EQ(0, std::memcmp(tree0->address_space + block0->block_start
+                                    , tree1->address_space + block1->block_start
+                                    , block0->size()));
+
+            if (i == 0)
+            {
+                block0 = (*block0->child_blocks)[0];
+                block1 = (*block1->child_blocks)[0];
+                EXPECT_EQ(block1->parent_block, tree1->root_block);
+            }
+        }
+    }
+};
+
+
+TEST_F(BlockImageTest,load)
+{
+    std::stringstream image_data;
+    svo::svo_write_block_image(image_data, tree0);
+
+    auto image = svo::svo_load_block_image(image_data);
+    ASSERT_TRUE(image);
+    EXPECT_FALSE(image->mapped());
+
+    expect_same_tree(image->tree());
+
+    ///the restored tree can still allocate in the free memory; the image frees the block.
+    svo::svo_block_t* block = image->tree()->allocate_block(SVO_PAGE_SIZE*4);
+    EXPECT_GE(block->block_start, (*image->tree()->root_block->child_blocks)[0]->block_end);
+}
+
+TEST_F(BlockImageTest,map)
+{
+    std::string path = "block_image_test.svoi";
+    {
+        std::ofstream out(path, std::ios::binary);
+        svo::svo_write_block_image(out, tree0);
+    }
+
+    {
+        auto image = svo::svo_map_block_image(path);
+        ASSERT_TRUE(image);
+        expect_same_tree(image->tree());
+
+        ///copy-on-write; the file is not modified.
+        image->tree()->address_space[image->tree()->root_block->cd_end] ^= 0xFF;
+    }
+
+    auto image = svo::svo_map_block_image(path);
+    expect_same_tree(image->tree());
+
+    std::remove(path.c_str());
+}
+
+TEST_F(BlockImageTest,bad_magic)
+{
+    std::stringstream image_data("not an image");
+    EXPECT_THROW(svo::svo_load_block_image(image_data), std::runtime_error);
+}
+
+TEST_F(BlockImageTest,checksums)
+{
+    std::stringstream image_data;
+    svo::svo_write_block_image(image_data, tree0);
+
+    ///a flipped bit in the last page of the child block.
+    std::string corrupt = image_data.str();
+    corrupt[corrupt.size() - 1] ^= 0x01;
+
+    {
+        std::stringstream in(corrupt);
+        EXPECT_THROW(svo::svo_load_block_image(in), std::runtime_error);
+    }
+
+    {
+        std::stringstream in(corrupt);
+        auto image = svo::svo_load_block_image(in, svo::svo_block_image_validation_t::table);
+        ASSERT_TRUE(image);
+    }
+
+    std::string path = "block_image_checksums_test.svoi";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(corrupt.data(), corrupt.size());
+    }
+
+    ///mapping only checks the table by default, so the pages are not touched.
+    EXPECT_TRUE(svo::svo_map_block_image(path));
+    EXPECT_THROW(svo::svo_map_block_image(path, svo::svo_block_image_validation_t::full), std::runtime_error);
+
+    std::remove(path.c_str());
+}
+
+TEST_F(BlockImageTest,bad_layout)
+{
+    svo::svo_block_t* block = (*tree0->root_block->child_blocks)[0];
+
+    auto expect_rejected = [&](goffset_t* field, goffset_t value)
+    {
+        goffset_t original = *field;
+        *field = value;
+
+        std::stringstream image_data;
+        svo::svo_write_block_image(image_data, tree0);
+        EXPECT_THROW(svo::svo_load_block_image(image_data), std::runtime_error) << "value: " << value;
+
+        *field = original;
+    };
+
+    ///sections out of order, or past the end of the block.
+    expect_rejected(&block->cd_end, block->cdspace_end + 4);
+    expect_rejected(&block->info_goffset, block->block_end);
+    expect_rejected(&block->data_start, block->info_goffset);
+    expect_rejected(&block->data_end, block->data_start - 4);
+    expect_rejected(&block->dataspace_end, block->block_end + SVO_PAGE_SIZE);
+
+    ///CDs outside of their blocks.
+    expect_rejected(&block->root_shadow_cd_goffset, block->cd_end);
+    expect_rejected(&block->parent_root_cd_goffset, block->root_shadow_cd_goffset);
+    expect_rejected(&tree0->root_block->parent_root_cd_goffset, tree0->root_block->root_shadow_cd_goffset);
+
+    ///and the untouched tree still loads.
+    std::stringstream image_data;
+    svo::svo_write_block_image(image_data, tree0);
+    EXPECT_TRUE(svo::svo_load_block_image(image_data));
+}
+
+TEST_F(BlockImageTest,data)
+{
+    svo::svo_block_t* block = (*tree0->root_block->child_blocks)[0];
+
+    svo::svo_declaration_t color_declaration;
+    color_declaration.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::UNSIGNED_INT, 1));
+    svo::svo_declaration_t normal_declaration;
+    normal_declaration.add(svo::svo_element_t("normal", svo::svo_semantic_t::NORMAL, svo::svo_data_type_t::FLOAT, 3));
+
+    block->buffers->add_buffer(color_declaration);
+    block->buffers->add_buffer(normal_declaration);
+    block->fit_data();
+    ASSERT_EQ(block->buffers->entries(), block->data_slots());
+    ASSERT_GT(block->data_slots(), 0U);
+
+    goffset_t pcd_goffset = block->root_shadow_cd_goffset;
+    uint32_t data_index = svo_get_data_index(block->cd_start, pcd_goffset, 5);
+    {
+        auto colors = block->buffers->get_element_view(block->buffers->get_element_handle<uint32_t>("color"));
+        colors[data_index] = 0xABCD;
+        block->buffers->get_element_view("normal").get<float>(data_index) = 0.5f;
+    }
+
+    ///the data is found from the CD alone.
+    const auto& buffers = block->buffers->buffers();
+    EXPECT_EQ(svo_get_data_goffset(tree0->address_space, pcd_goffset, 5, 0, 4), buffers[0].start() + data_index*4);
+    EXPECT_EQ(svo_get_data_goffset(tree0->address_space, pcd_goffset, 5, 4, 12), buffers[1].start() + data_index*12);
+
+    ///more CDs; the buffers grow and move, and keep their data.
+    child_descriptor_t cd; svo_init_cd(&cd);
+    svo_append_cd(tree0->address_space, block, &cd);
+    block->fit_data();
+    ASSERT_EQ(block->buffers->entries(), block->data_slots());
+    EXPECT_EQ(buffers[0].start(), block->data_start);
+    EXPECT_EQ(buffers[1].start(), block->data_start + block->data_slots()*4);
+    EXPECT_EQ(block->data_end, buffers[1].start() + block->data_slots()*12);
+
+    EXPECT_THROW(block->buffers->resize(block->size()), svo::svo_bad_alloc);
+
+    ///and it can be read straight from the image.
+    std::stringstream image_data;
+    svo::svo_write_block_image(image_data, tree0);
+    auto image = svo::svo_load_block_image(image_data);
+    ASSERT_TRUE(image);
+
+    const byte_t* address_space = image->tree()->address_space;
+    uint32_t color; float normal;
+    std::memcpy(&color, address_space + svo_get_data_goffset(address_space, pcd_goffset, 5, 0, 4), sizeof(color));
+    std::memcpy(&normal, address_space + svo_get_data_goffset(address_space, pcd_goffset, 5, 4, 12), sizeof(normal));
+    EXPECT_EQ(color, 0xABCDU);
+    EXPECT_EQ(normal, 0.5f);
+}
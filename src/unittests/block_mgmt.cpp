@@ -0,0 +1,175 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_tree.sanity.hpp"
+#include "landscapes/svo_block_image.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <map>
+#include <tuple>
+#include <memory>
+#include <sstream>
+#include <cstring>
+
+/**
+ * A slice hierarchy of one voxel wide chains, root => child => grandchild, inserted into a tree one
+ * level at a time. Each voxel's color is (level*1000 + vcurve).
+ */
+struct SliceInserterTest : public ::testing::Test {
+protected:
+
+    std::unique_ptr<svo::svo_tree_t> m_tree;
+    svo::svo_slice_t* m_root_slice;
+
+    static svo::svo_slice_t* make_slice(std::size_t level, vside_t side, const std::vector<vcurve_t>& pos_data)
+    {
+        svo::svo_slice_t* slice = svo::svo_init_slice(level, side);
+        *slice->pos_data = pos_data;
+
+        svo::svo_declaration_t declaration;
+        declaration.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::UNSIGNED_INT, 1));
+        slice->buffers->add_buffer(declaration, pos_data.size());
+
+        auto colors = slice->buffers->get_element_view(slice->buffers->get_element_handle<uint32_t>("color"));
+        for (std::size_t i = 0; i < pos_data.size(); ++i)
+            colors[i] = uint32_t(level*1000 + pos_data[i]);
+        return slice;
+    }
+
+    virtual void SetUp() {
+        m_root_slice = make_slice(0, 1, {0});
+        svo::svo_slice_t* child = make_slice(1, 2, {0, 3, 5, 7});
+        svo::svo_slice_t* grandchild = make_slice(2, 4, {0, 1, 2, 3, 24, 25, 40, 63});
+        svo::svo_slice_attach_child(m_root_slice, child, 0);
+        svo::svo_slice_attach_child(child, grandchild, 0);
+
+        m_tree.reset(new svo::svo_tree_t(SVO_PAGE_SIZE*64, SVO_PAGE_SIZE*4));
+    }
+
+    virtual void TearDown() {
+        for (auto& child_block : *m_tree->root_block->child_blocks)
+            delete child_block;
+        delete m_tree->root_block;
+        svo::svo_uninit_slice(m_root_slice, true);
+    }
+
+    ///inserts the whole slice hierarchy, and returns the leaf blocks.
+    std::vector<svo::svo_block_t*> build_tree()
+    {
+        std::vector<svo::svo_block_t*> leaf_blocks;
+        EXPECT_EQ(svo::svo_block_initialize_slice_data(leaf_blocks, m_tree.get(), m_tree->root_block, m_root_slice)
+                 , svo::svo_error_t::OK);
+
+        bool loading = true;
+        while (loading)
+        {
+            loading = false;
+            std::vector<svo::svo_block_t*> next_leaf_blocks;
+            for (svo::svo_block_t* block : leaf_blocks)
+            {
+                if (!block->slice)
+                {
+                    next_leaf_blocks.push_back(block);
+                    continue;
+                }
+
+                std::vector<svo::svo_block_t*> new_leaf_blocks;
+                EXPECT_EQ(svo::svo_load_next_slice(new_leaf_blocks, block), svo::svo_error_t::OK);
+                next_leaf_blocks.insert(next_leaf_blocks.end(), new_leaf_blocks.begin(), new_leaf_blocks.end());
+                loading = true;
+            }
+            leaf_blocks = next_leaf_blocks;
+        }
+        return leaf_blocks;
+    }
+
+    ///{vcurve => color} of the voxels at @c level of @c block, each read from its parent CD with svo_get_data_goffset().
+    static std::map<vcurve_t, uint32_t> read_colors(const byte_t* address_space, const svo::svo_block_t* block, std::size_t level)
+    {
+        std::map<vcurve_t, uint32_t> colors;
+        auto visitor = [&colors, address_space, level](goffset_t pcd_goffset, goffset_t cd_goffset, ccurve_t voxel_ccurve
+                                                      , std::tuple<vcurve_t, std::size_t> metadata)
+        {
+            vcurve_t voxel_vcurve = std::get<0>(metadata)*8 + voxel_ccurve;
+            std::size_t voxel_level = std::get<1>(metadata);
+
+            if (pcd_goffset != invalid_goffset && voxel_level == level)
+            {
+                uint32_t color;
+                std::memcpy(&color, address_space + svo_get_data_goffset(address_space, pcd_goffset, voxel_ccurve, 0, sizeof(color)), sizeof(color));
+                colors[voxel_vcurve] = color;
+            }
+            (void)cd_goffset;
+            return std::make_tuple(voxel_vcurve, voxel_level + 1);
+        };
+        svo::z_preorder_traverse_block_cds(address_space, block, std::make_tuple(vcurve_t(0), std::size_t(0)), visitor);
+        return colors;
+    }
+
+    static std::map<vcurve_t, uint32_t> slice_colors(const svo::svo_slice_t* slice)
+    {
+        std::map<vcurve_t, uint32_t> colors;
+        const auto& buffer = slice->buffers->buffers()[0];
+        for (std::size_t i = 0; i < slice->pos_data->size(); ++i)
+            colors[(*slice->pos_data)[i]] = reinterpret_cast<const uint32_t*>(buffer.rawdata())[i];
+        return colors;
+    }
+};
+
+
+TEST_F(SliceInserterTest,data)
+{
+    auto leaf_blocks = build_tree();
+    ASSERT_EQ(leaf_blocks.size(), 1U);
+
+    svo::svo_block_t* block = leaf_blocks[0];
+    const svo::svo_slice_t* child = (*m_root_slice->children)[0];
+    const svo::svo_slice_t* grandchild = (*child->children)[0];
+    ASSERT_EQ(block->height, 3U);
+    ASSERT_TRUE(block->buffers->has_schema());
+    EXPECT_EQ(block->buffers->schema(), grandchild->buffers->schema());
+    EXPECT_EQ(block->buffers->entries(), block->data_slots());
+
+    ///both levels kept their data, though the child's CDs were rewritten when the grandchild was inserted.
+    EXPECT_EQ(read_colors(m_tree->address_space, block, 1), slice_colors(child));
+    EXPECT_EQ(read_colors(m_tree->address_space, block, 2), slice_colors(grandchild));
+
+    ///and they can be read straight from the image.
+    std::stringstream image_data;
+    svo::svo_write_block_image(image_data, m_tree.get());
+    auto image = svo::svo_load_block_image(image_data);
+    ASSERT_TRUE(image);
+    ASSERT_EQ(image->tree()->root_block->child_blocks->size(), 1U);
+
+    const svo::svo_block_t* image_block = (*image->tree()->root_block->child_blocks)[0];
+    const byte_t* address_space = image->tree()->address_space;
+    EXPECT_EQ(read_colors(address_space, image_block, 1), slice_colors(child));
+    EXPECT_EQ(read_colors(address_space, image_block, 2), slice_colors(grandchild));
+}
+
+TEST_F(SliceInserterTest,validate_blocks)
+{
+    auto leaf_blocks = build_tree();
+    ASSERT_EQ(leaf_blocks.size(), 1U);
+
+    auto report = svo::svo_validate_blocks(m_tree->root_block);
+    EXPECT_FALSE(report) << report;
+    EXPECT_EQ(report.blocks_checked, std::size_t(2));
+
+    report = svo::svo_validate_async(m_tree->root_block, m_root_slice).get();
+    EXPECT_FALSE(report) << report;
+    EXPECT_EQ(report.blocks_checked, std::size_t(2));
+    EXPECT_EQ(report.slices_checked, std::size_t(3));
+
+    ///a broken leaf block is reported, and the pass still gets through the whole tree.
+    svo::svo_block_t* block = leaf_blocks[0];
+    std::size_t height = block->height;
+    block->height = 0;
+
+    report = svo::svo_validate_blocks(m_tree->root_block);
+    EXPECT_TRUE(report);
+    EXPECT_EQ(report.blocks_checked, std::size_t(2));
+    ASSERT_EQ(report.block_errors.size(), 1U);
+    EXPECT_EQ(report.block_errors[0].block0, block);
+
+    block->height = height;
+}
@@ -0,0 +1,298 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_buffer.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <array>
+#include <cstring>
+
+struct BufferTest : public ::testing::Test {
+protected:
+
+    svo::svo_declaration_t m_declaration;
+
+    virtual void SetUp() {
+        m_declaration.add(svo::svo_element_t("id", svo::svo_semantic_t::NONE, svo::svo_data_type_t::UNSIGNED_SHORT, 1));
+    }
+
+    static uint16_t id(const svo::svo_cpu_buffer_t& buffer, std::size_t i)
+    {
+        return reinterpret_cast<const uint16_t*>(buffer.rawdata())[i];
+    }
+};
+
+
+TEST_F(BufferTest,views)
+{
+    svo::svo_cpu_buffer_t buffer(m_declaration, 8);
+    for (std::size_t i = 0; i < 8; ++i)
+        reinterpret_cast<uint16_t*>(buffer.rawdata())[i] = uint16_t(i);
+
+    const svo::svo_cpu_buffer_t& const_buffer = buffer;
+    svo::svo_cpu_buffer_t view = buffer.view(2, 3);
+    EXPECT_TRUE(buffer.shared());
+    EXPECT_EQ(view.entries(), 3U);
+    EXPECT_EQ(static_cast<const svo::svo_cpu_buffer_t&>(view).rawdata(), const_buffer.rawdata() + 2*2);
+    EXPECT_EQ(id(view, 0), 2);
+
+    ///writing through the view copies it; the buffer keeps its data.
+    reinterpret_cast<uint16_t*>(view.rawdata())[0] = 100;
+    EXPECT_FALSE(view.shared());
+    EXPECT_FALSE(buffer.shared());
+    EXPECT_EQ(id(view, 0), 100);
+    EXPECT_EQ(id(buffer, 2), 2);
+
+    ///growing a view keeps its entries.
+    svo::svo_cpu_buffer_t tail = buffer.view(6, 2);
+    tail.resize(4);
+    EXPECT_EQ(id(tail, 0), 6);
+    EXPECT_EQ(id(tail, 1), 7);
+    EXPECT_EQ(id(tail, 2), 0);
+    EXPECT_EQ(buffer.entries(), 8U);
+
+    EXPECT_THROW(buffer.view(7, 2), std::runtime_error);
+
+    ///a copy has its own storage; only views share.
+    svo::svo_cpu_buffer_t copy = tail;
+    EXPECT_FALSE(copy.shared());
+    EXPECT_FALSE(tail.shared());
+    EXPECT_NE(static_cast<const svo::svo_cpu_buffer_t&>(copy).rawdata(), static_cast<const svo::svo_cpu_buffer_t&>(tail).rawdata());
+    EXPECT_EQ(id(copy, 1), 7);
+}
+
+TEST_F(BufferTest,clone_slice)
+{
+    svo::svo_slice_t* slice = svo::svo_init_slice(0, 4);
+    slice->pos_data->assign({1, 2, 3});
+    auto& buffer = slice->buffers->add_buffer(m_declaration, 3);
+    for (std::size_t i = 0; i < 3; ++i)
+        reinterpret_cast<uint16_t*>(buffer.rawdata())[i] = uint16_t(10 + i);
+
+    ///the clone shares the data, until it is written.
+    svo::svo_slice_t* clone = svo::svo_clone_slice(slice);
+    const auto& clone_buffer = clone->buffers->buffers()[0];
+    EXPECT_EQ(*clone->pos_data, *slice->pos_data);
+    EXPECT_EQ(clone_buffer.rawdata(), static_cast<const svo::svo_cpu_buffer_t&>(buffer).rawdata());
+    EXPECT_EQ(id(clone_buffer, 2), 12);
+
+    clone->buffers->get_element_view("id").get<uint16_t>(2) = 7;
+    EXPECT_EQ(id(clone_buffer, 2), 7);
+    EXPECT_EQ(id(buffer, 2), 12);
+
+    svo::svo_uninit_slice(clone, true);
+    svo::svo_uninit_slice(slice, true);
+}
+
+TEST_F(BufferTest,split_join_slice)
+{
+    ///a slice of ids equal to the vcurves.
+    auto make_slice = [this](std::size_t level, vside_t side, const std::vector<vcurve_t>& pos_data)
+    {
+        svo::svo_slice_t* slice = svo::svo_init_slice(level, side);
+        *slice->pos_data = pos_data;
+        auto& buffer = slice->buffers->add_buffer(m_declaration, pos_data.size());
+        for (std::size_t i = 0; i < pos_data.size(); ++i)
+            reinterpret_cast<uint16_t*>(buffer.rawdata())[i] = uint16_t(pos_data[i]);
+        return slice;
+    };
+    auto ids = [](const svo::svo_slice_t* slice)
+    {
+        const auto& buffer = slice->buffers->buffers()[0];
+        const uint16_t* data = reinterpret_cast<const uint16_t*>(buffer.rawdata());
+        return std::vector<uint16_t>(data, data + buffer.entries());
+    };
+
+    std::vector<vcurve_t> parent_pos_data(64);
+    for (std::size_t i = 0; i < parent_pos_data.size(); ++i)
+        parent_pos_data[i] = vcurve_t(i);
+
+    ///the grandchild covers the whole child, so it is split along with it.
+    svo::svo_slice_t* parent = make_slice(0, 4, parent_pos_data);
+    svo::svo_slice_t* child = make_slice(1, 8, {0, 1, 70, 200, 511});
+    svo::svo_slice_t* gchild = make_slice(2, 16, {3, 8, 560, 1600, 4095});
+    svo::svo_slice_attach_child(parent, child, 0);
+    svo::svo_slice_attach_child(child, gchild, 0);
+
+    std::array<svo::svo_slice_t*, 8> parts;
+    svo::svo_split_slice(child, parts);
+    EXPECT_EQ(child->parent_slice, nullptr);
+    EXPECT_TRUE(child->children->empty());
+
+    const std::array<std::vector<vcurve_t>, 8> part_pos_data{{ {0, 1}, {6}, {}, {8}, {}, {}, {}, {63} }};
+    const std::array<std::vector<vcurve_t>, 8> gpart_pos_data{{ {3, 8}, {48}, {}, {64}, {}, {}, {}, {511} }};
+    ASSERT_EQ(parent->children->size(), 4U);
+    for (std::size_t ccurve = 0; ccurve < 8; ++ccurve)
+    {
+        svo::svo_slice_t* part = parts[ccurve];
+        if (part_pos_data[ccurve].empty())
+        {
+            EXPECT_EQ(part, nullptr);
+            continue;
+        }
+        ASSERT_NE(part, nullptr);
+        EXPECT_EQ(part->side, 4U);
+        EXPECT_EQ(part->level, 1U);
+        EXPECT_EQ(part->parent_slice, parent);
+        EXPECT_EQ(part->parent_vcurve_begin, ccurve*8);
+        EXPECT_EQ(*part->pos_data, part_pos_data[ccurve]);
+
+        ///the buffers are views of the child's entries.
+        EXPECT_TRUE(part->buffers->buffers()[0].shared());
+        std::vector<uint16_t> expected_ids;
+        for (vcurve_t vcurve : part_pos_data[ccurve])
+            expected_ids.push_back(uint16_t(vcurve + ccurve*64));
+        EXPECT_EQ(ids(part), expected_ids);
+
+        ///each part has the part of the grandchild in its octant.
+        ASSERT_EQ(part->children->size(), 1U);
+        svo::svo_slice_t* gpart = (*part->children)[0];
+        EXPECT_EQ(gpart->side, 8U);
+        EXPECT_EQ(gpart->parent_slice, part);
+        EXPECT_EQ(gpart->parent_vcurve_begin, 0U);
+        EXPECT_EQ(*gpart->pos_data, gpart_pos_data[ccurve]);
+    }
+
+    ///joining the parts gives back the child.
+    svo::svo_slice_t* joined = svo::svo_init_slice(1, 8);
+    svo::svo_join_slices(joined, parts);
+    EXPECT_EQ(joined->side, 8U);
+    EXPECT_EQ(joined->parent_slice, parent);
+    EXPECT_EQ(*joined->pos_data, *child->pos_data);
+    EXPECT_EQ(ids(joined), ids(child));
+    ASSERT_EQ(parent->children->size(), 1U);
+    EXPECT_EQ((*parent->children)[0], joined);
+    EXPECT_EQ(joined->children->size(), 4U);
+
+    for (svo::svo_slice_t* part : parts)
+        if (part)
+            svo::svo_uninit_slice(part, false);
+    svo::svo_uninit_slice(child, true);
+    svo::svo_uninit_slice(parent, true);
+}
+
+TEST_F(BufferTest,convert)
+{
+    svo::svo_declaration_t interleaved;
+    interleaved.add(svo::svo_element_t("pos", svo::svo_semantic_t::NONE, svo::svo_data_type_t::SHORT, 3));
+    interleaved.add(svo::svo_element_t("flag", svo::svo_semantic_t::NONE, svo::svo_data_type_t::UNSIGNED_BYTE, 1));
+
+    svo::svo_declaration_t positions;
+    positions.add(svo::svo_element_t("pos", svo::svo_semantic_t::NONE, svo::svo_data_type_t::FLOAT, 3));
+    svo::svo_declaration_t flags;
+    flags.add(svo::svo_element_t("flag", svo::svo_semantic_t::NONE, svo::svo_data_type_t::UNSIGNED_BYTE, 1));
+    svo::svo_declaration_t wide_positions;
+    wide_positions.add(svo::svo_element_t("pos", svo::svo_semantic_t::NONE, svo::svo_data_type_t::LONG, 3));
+
+    const std::size_t entries = 100;
+    svo::svo_cpu_buffer_t src(interleaved, entries);
+    for (std::size_t i = 0; i < entries; ++i)
+    {
+        uint8_t* entry = src.rawdata() + i*src.stride();
+        int16_t pos[3] = {int16_t(i), int16_t(-int(i)), int16_t(i*100)};
+        uint8_t flag = uint8_t(i*7);
+        std::memcpy(entry + interleaved.offset(0), pos, sizeof(pos));
+        std::memcpy(entry + interleaved.offset(1), &flag, sizeof(flag));
+    }
+
+    ///interleaved to planar: a strided conversion, and a strided raw copy.
+    svo::svo_cpu_buffer_t dst_positions(positions, entries);
+    svo::svo_cpu_buffer_t dst_flags(flags, entries);
+    dst_positions.copy_from_buffer(src, 0, 0, 0, entries, 0);
+    dst_flags.copy_from_buffer(src, 1, 0, 0, entries, 0);
+
+    ///planar to planar: a packed conversion, which sign extends.
+    svo::svo_cpu_buffer_t dst_wide(wide_positions, entries);
+    dst_wide.copy_from_buffer(dst_positions);
+
+    const svo::svo_cpu_buffer_t& result_positions = dst_positions;
+    const svo::svo_cpu_buffer_t& result_wide = dst_wide;
+    for (std::size_t i = 0; i < entries; ++i)
+    {
+        const float* pos = reinterpret_cast<const float*>(result_positions.rawdata()) + 3*i;
+        EXPECT_EQ(pos[0], float(i));
+        EXPECT_EQ(pos[1], -float(i));
+        EXPECT_EQ(pos[2], float(int16_t(i*100)));
+        EXPECT_EQ(static_cast<const svo::svo_cpu_buffer_t&>(dst_flags).rawdata()[i], uint8_t(i*7));
+
+        const int64_t* wide = reinterpret_cast<const int64_t*>(result_wide.rawdata()) + 3*i;
+        EXPECT_EQ(wide[1], -int64_t(i));
+    }
+
+    EXPECT_THROW(dst_flags.copy_from_buffer(src, 0, 0, 0, entries, 0), std::runtime_error);
+}
+
+TEST_F(BufferTest,planar)
+{
+    svo::svo_declaration_t planar(svo::svo_layout_t::PLANAR);
+    planar.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::FLOAT, 3));
+    planar.add(svo::svo_element_t("normal", svo::svo_semantic_t::NORMAL, svo::svo_data_type_t::FLOAT, 3));
+    ASSERT_EQ(planar.planes().size(), 2U);
+    EXPECT_EQ(planar.planes()[1].elements()[0].name(), "normal");
+
+    svo::svo_cpu_buffers_t buffers;
+    auto& first = buffers.add_buffer(planar, 10);
+    ASSERT_EQ(buffers.buffers().size(), 2U);
+    EXPECT_EQ(&first, &buffers.buffers()[0]);
+    EXPECT_EQ(buffers.entries(), 10U);
+
+    ///each element is a unit-stride stream of its own buffer.
+    for (const auto& buffer : buffers.buffers())
+    {
+        EXPECT_EQ(buffer.declaration().layout(), svo::svo_layout_t::INTERLEAVED);
+        EXPECT_EQ(buffer.stride(), 3*sizeof(float));
+    }
+
+    auto normals = buffers.get_element_view("normal");
+    normals.get<float>(4) = 2.5f;
+    const float* normal_data = reinterpret_cast<const float*>(static_cast<const svo::svo_cpu_buffer_t&>(buffers.buffers()[1]).rawdata());
+    EXPECT_EQ(normal_data[3*4], 2.5f);
+
+    ///a clash adds none of the planes.
+    svo::svo_declaration_t clash(svo::svo_layout_t::PLANAR);
+    clash.add(svo::svo_element_t("id", svo::svo_semantic_t::NONE, svo::svo_data_type_t::INT, 1));
+    clash.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::FLOAT, 3));
+    EXPECT_THROW(buffers.add_buffer(clash, 10), std::runtime_error);
+    EXPECT_EQ(buffers.buffers().size(), 2U);
+
+    EXPECT_THROW(svo::svo_cpu_buffer_t(planar, 1), std::runtime_error);
+}
+
+TEST_F(BufferTest,element_handle)
+{
+    svo::svo_declaration_t declaration;
+    declaration.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::FLOAT, 3));
+    declaration.add(svo::svo_element_t("level", svo::svo_semantic_t::NONE, svo::svo_data_type_t::UNSIGNED_SHORT, 1));
+
+    svo::svo_cpu_buffers_t buffers0;
+    svo::svo_cpu_buffers_t buffers1;
+    buffers0.add_buffer(m_declaration, 4);
+    buffers0.add_buffer(declaration, 4);
+    buffers1.copy_schema(buffers0, 2);
+
+    auto handle = buffers0.get_element_handle<uint16_t>("level");
+    ASSERT_TRUE(handle.valid());
+    EXPECT_EQ(handle.buffer_index(), 1U);
+    EXPECT_EQ(handle.offset(), 3*sizeof(float));
+    EXPECT_FALSE(svo::svo_element_handle_t<uint16_t>().valid());
+
+    ///the handle serves any buffers of the same schema.
+    auto ids0 = buffers0.get_element_view(handle);
+    auto ids1 = buffers1.get_element_view(handle);
+    EXPECT_EQ(ids0.entries(), 4U);
+    EXPECT_EQ(ids1.entries(), 2U);
+    EXPECT_EQ(ids0.stride(), declaration.stride());
+    ids0[3] = 30;
+    ids1[1] = 11;
+    EXPECT_EQ(buffers0.get_element_view("level").get<uint16_t>(3), 30);
+    EXPECT_EQ(buffers1.get_element_view("level").get<uint16_t>(1), 11);
+
+    const svo::svo_cpu_buffers_t& const_buffers = buffers0;
+    EXPECT_EQ(const_buffers.get_element_view(handle)[3], 30);
+
+    EXPECT_THROW(buffers0.get_element_handle<uint32_t>("level"), std::runtime_error);
+    ///a different type of the same size, or a different count.
+    EXPECT_THROW(buffers0.get_element_handle<int16_t>("level"), std::runtime_error);
+    EXPECT_THROW(buffers0.get_element_handle<float>("color"), std::runtime_error);
+    EXPECT_TRUE(buffers0.get_element_handle<float3_t>("color").valid());
+    EXPECT_THROW(buffers0.get_element_handle<uint16_t>("nope"), std::runtime_error);
+}
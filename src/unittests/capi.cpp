@@ -0,0 +1,54 @@
+#include "landscapes/svo_tree.capi.h"
+#include "gtest/gtest.h"
+
+class CAPITest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+    // Code here will be called immediately after each test
+    // (right before the destructor).
+    }
+    };
+
+
+
+TEST_F(CAPITest,count_bits){
+    for (uint32_t value = 0; value < 256; ++value)
+    {
+        EXPECT_EQ(svo_count_bits_uint8(value), svo_count_bits_uint8_check(value)) << "value: " << value;
+        EXPECT_EQ(svo_popcount8_lut[value], svo_count_bits_uint8_check(value)) << "value: " << value;
+    }
+}
+
+TEST_F(CAPITest,child_index){
+
+    ///every combination of valid/leaf masks, and every nonleaf child in them.
+    for (uint32_t valid_mask = 0; valid_mask < 256; ++valid_mask)
+    {
+        for (uint32_t leaf_mask = 0; leaf_mask < 256; ++leaf_mask)
+        {
+            if ((leaf_mask & valid_mask) != leaf_mask)
+                continue;
+
+            child_descriptor_t cd;
+            svo_init_cd(&cd);
+            svo_set_valid_mask(&cd, valid_mask);
+            svo_set_leaf_mask(&cd, leaf_mask);
+
+            EXPECT_EQ(svo_get_cd_valid_count(&cd), svo_get_cd_valid_count_check(&cd));
+            EXPECT_EQ(svo_get_cd_leaf_count(&cd), svo_get_cd_leaf_count_check(&cd));
+            EXPECT_EQ(svo_get_cd_nonleaf_count(&cd), svo_get_cd_nonleaf_count_check(&cd));
+
+            for (ccurve_t ccurve = 0; ccurve < 8; ++ccurve)
+            {
+                if (!svo_get_nonleaf_bit(&cd, ccurve))
+                    continue;
+                ASSERT_EQ(svo_get_cd_child_index(&cd, ccurve), svo_get_cd_child_index_check(&cd, ccurve))
+                    << "valid_mask: " << valid_mask << ", leaf_mask: " << leaf_mask << ", ccurve: " << ccurve;
+            }
+        }
+    }
+}
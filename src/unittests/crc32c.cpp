@@ -0,0 +1,48 @@
+#include "landscapes/svo_crc32c.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <random>
+#include <cstring>
+
+struct CRC32CTest : public ::testing::Test {
+protected:
+    std::vector<uint8_t> data;
+
+    virtual void SetUp() {
+        std::mt19937 gen(0);
+        data.resize(4096 + 13);
+        for (auto& byte : data)
+            byte = uint8_t(gen());
+    }
+};
+
+
+TEST_F(CRC32CTest,check_value)
+{
+    const char* check = "123456789";
+    EXPECT_EQ(svo::svo_crc32c(check, std::strlen(check)), 0xE3069283U);
+    EXPECT_EQ(svo::svo_crc32c_sw(check, std::strlen(check)), 0xE3069283U);
+    EXPECT_EQ(svo::svo_crc32c(check, 0), 0U);
+}
+
+TEST_F(CRC32CTest,hw_matches_sw)
+{
+    ///unaligned starts and odd lengths exercise every tail of both implementations.
+    for (std::size_t offset = 0; offset < 8; ++offset)
+    for (std::size_t bytes : {0, 1, 3, 7, 8, 9, 31, 64, 1000, 4096})
+    {
+        ASSERT_EQ(svo::svo_crc32c(data.data() + offset, bytes), svo::svo_crc32c_sw(data.data() + offset, bytes));
+    }
+}
+
+TEST_F(CRC32CTest,incremental)
+{
+    uint32_t whole = svo::svo_crc32c(data.data(), data.size());
+
+    uint32_t crc = 0;
+    for (std::size_t offset = 0; offset < data.size(); offset += 100)
+        crc = svo::svo_crc32c(data.data() + offset, std::min<std::size_t>(100, data.size() - offset), crc);
+
+    EXPECT_EQ(crc, whole);
+}
@@ -0,0 +1,292 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_archive.hpp"
+#include "landscapes/svo_edit_log.hpp"
+#include "landscapes/svo_serialization.v2.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <memory>
+#include <cstdio>
+
+struct EditLogTest : public ::testing::Test {
+protected:
+
+    std::stringstream m_archive_data;
+    std::string m_path;
+
+    static svo::svo_slice_t* make_slice(std::size_t level, vside_t side, vcurve_t stride)
+    {
+        svo::svo_slice_t* slice = svo::svo_init_slice(level, side);
+        for (vcurve_t vcurve = 0; vcurve < vcurvesize(side); vcurve += stride)
+            slice->pos_data->push_back(vcurve);
+
+        svo::svo_declaration_t declaration;
+        declaration.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::UNSIGNED_BYTE, 3));
+        auto& buffer = slice->buffers->add_buffer(declaration, slice->pos_data->size());
+        for (std::size_t byte_index = 0; byte_index < buffer.bytes(); ++byte_index)
+            buffer.rawdata()[byte_index] = uint8_t(byte_index + level);
+        return slice;
+    }
+
+    virtual void SetUp() {
+        ///root => two children, one in the first octant and one in the last.
+        svo::svo_slice_t* root = make_slice(0, 4, 1);
+        svo::svo_slice_attach_child(root, make_slice(1, 4, 2), 0);
+        svo::svo_slice_attach_child(root, make_slice(1, 4, 3), 56);
+
+        svo::svo_write_archive(m_archive_data, root);
+        svo::svo_uninit_slice(root, true);
+
+        m_path = "edit_log_test.svoe";
+        std::remove(m_path.c_str());
+    }
+
+    virtual void TearDown() {
+        std::remove(m_path.c_str());
+    }
+
+    typedef std::unique_ptr<svo::svo_slice_t, void(*)(svo::svo_slice_t*)> slice_ptr_t;
+
+    slice_ptr_t load_slice(svo::svo_slice_id_t slice_id)
+    {
+        m_archive_data.clear();
+        m_archive_data.seekg(0);
+        svo::svo_archive_t archive(m_archive_data);
+        return slice_ptr_t(archive.load_subtree(slice_id, 0)
+                         , [](svo::svo_slice_t* slice){ svo::svo_uninit_slice(slice, true); });
+    }
+
+    static std::vector<uint8_t> color(const svo::svo_slice_t* slice, vcurve_t vcurve)
+    {
+        const auto& pos_data = *slice->pos_data;
+        std::size_t index = std::lower_bound(pos_data.begin(), pos_data.end(), vcurve) - pos_data.begin();
+        const uint8_t* data = slice->buffers->buffers()[0].rawdata() + index * 3;
+        return std::vector<uint8_t>(data, data + 3);
+    }
+
+    static bool contains(const svo::svo_slice_t* slice, vcurve_t vcurve)
+    {
+        return std::binary_search(slice->pos_data->begin(), slice->pos_data->end(), vcurve);
+    }
+};
+
+
+TEST_F(EditLogTest,read_back)
+{
+    {
+        svo::svo_edit_log_t log(m_path);
+        log.insert(1, 5, {1, 2, 3});
+        log.erase(2, 6);
+        uint8_t value[3] = {7, 8, 9};
+        log.update(1, 7, "color", value, sizeof(value));
+        EXPECT_EQ(log.size(), 3U);
+    }
+
+    std::ifstream in(m_path, std::ios::binary);
+    uint64_t valid_end = 0;
+    auto edits = svo::svo_read_edit_log(in, &valid_end);
+
+    ASSERT_EQ(edits.size(), 3U);
+    EXPECT_EQ(edits[0].op, svo::svo_edit_op_t::insert);
+    EXPECT_EQ(edits[0].slice_id, 1U);
+    EXPECT_EQ(edits[0].vcurve, vcurve_t(5));
+    EXPECT_EQ(edits[0].data, (std::vector<uint8_t>{1, 2, 3}));
+    EXPECT_EQ(edits[1].op, svo::svo_edit_op_t::erase);
+    EXPECT_EQ(edits[1].slice_id, 2U);
+    EXPECT_EQ(edits[2].op, svo::svo_edit_op_t::update);
+    EXPECT_EQ(edits[2].element, "color");
+    EXPECT_EQ(edits[2].data, (std::vector<uint8_t>{7, 8, 9}));
+
+    in.clear();
+    in.seekg(0, std::ios::end);
+    EXPECT_EQ(valid_end, uint64_t(in.tellg()));
+
+    ///reopening appends after the existing records.
+    svo::svo_edit_log_t log(m_path);
+    EXPECT_EQ(log.size(), 3U);
+}
+
+TEST_F(EditLogTest,torn_tail)
+{
+    {
+        svo::svo_edit_log_t log(m_path);
+        log.erase(0, 1);
+        log.erase(0, 2);
+    }
+
+    {
+        ///half a record, as if the process died while appending.
+        std::ofstream out(m_path, std::ios::binary | std::ios::app);
+        out.write("\0\0\0\x10\x12\x34", 6);
+    }
+
+    {
+        svo::svo_edit_log_t log(m_path);
+        EXPECT_EQ(log.size(), 2U);
+        log.erase(0, 3);
+    }
+
+    std::ifstream in(m_path, std::ios::binary);
+    auto edits = svo::svo_read_edit_log(in);
+    ASSERT_EQ(edits.size(), 3U);
+    EXPECT_EQ(edits[2].vcurve, vcurve_t(3));
+}
+
+TEST_F(EditLogTest,corrupt)
+{
+    {
+        svo::svo_edit_log_t log(m_path);
+        log.erase(0, 1);
+        log.erase(0, 2);
+    }
+
+    {
+        ///flip a byte of the first record's payload; a record follows, so this is not a torn tail.
+        std::fstream io(m_path, std::ios::binary | std::ios::in | std::ios::out);
+        io.seekp(12 + 8 + 2);
+        io.put('\x55');
+    }
+
+    std::ifstream in(m_path, std::ios::binary);
+    EXPECT_THROW(svo::svo_read_edit_log(in), std::runtime_error);
+}
+
+TEST_F(EditLogTest,upgrade)
+{
+    {
+        ///a version 1 log, with a u32 vcurve in its one record: erase slice 2, vcurve 9.
+        std::ofstream out(m_path, std::ios::binary);
+        out.write("SVOE\0\0\0\x01", 8);
+        uint32_t byte_order_mark = 0x01020304;
+        out.write(reinterpret_cast<const char*>(&byte_order_mark), sizeof(byte_order_mark));
+        svo::svo_write_section(out, std::string("\x01\0\0\0\x02\0\0\0\x09", 9));
+    }
+
+    {
+        svo::svo_edit_log_t log(m_path);
+        EXPECT_EQ(log.size(), 1U);
+        log.erase(0, 3);
+    }
+
+    std::ifstream in(m_path, std::ios::binary);
+    auto edits = svo::svo_read_edit_log(in);
+    ASSERT_EQ(edits.size(), 2U);
+    EXPECT_EQ(edits[0].op, svo::svo_edit_op_t::erase);
+    EXPECT_EQ(edits[0].slice_id, 2U);
+    EXPECT_EQ(edits[0].vcurve, vcurve_t(9));
+    EXPECT_EQ(edits[1].vcurve, vcurve_t(3));
+}
+
+TEST_F(EditLogTest,apply)
+{
+    slice_ptr_t slice = load_slice(0);
+
+    std::vector<svo::svo_edit_t> edits(4);
+    edits[0].op = svo::svo_edit_op_t::erase;
+    edits[0].vcurve = 10;
+    edits[1].op = svo::svo_edit_op_t::update;
+    edits[1].vcurve = 11;
+    edits[1].element = "color";
+    edits[1].data = {4, 5, 6};
+    ///erased, then inserted and updated again.
+    edits[2].op = svo::svo_edit_op_t::insert;
+    edits[2].vcurve = 10;
+    edits[2].data = {1, 2, 3};
+    edits[3].op = svo::svo_edit_op_t::update;
+    edits[3].vcurve = 10;
+    edits[3].element = "color";
+    edits[3].data = {7, 8, 9};
+
+    std::vector<const svo::svo_edit_t*> edit_ptrs;
+    for (const auto& edit : edits)
+        edit_ptrs.push_back(&edit);
+    svo::svo_apply_edits(slice.get(), edit_ptrs);
+
+    EXPECT_EQ(slice->pos_data->size(), 64U);
+    EXPECT_EQ(color(slice.get(), 10), (std::vector<uint8_t>{7, 8, 9}));
+    EXPECT_EQ(color(slice.get(), 11), (std::vector<uint8_t>{4, 5, 6}));
+    EXPECT_EQ(color(slice.get(), 12), (std::vector<uint8_t>{36, 37, 38}));
+
+    svo::svo_edit_t bad_element;
+    bad_element.op = svo::svo_edit_op_t::update;
+    bad_element.element = "normal";
+    bad_element.data = {1, 2, 3};
+    EXPECT_THROW(svo::svo_apply_edits(slice.get(), {&bad_element}), std::runtime_error);
+
+    svo::svo_edit_t bad_vcurve;
+    bad_vcurve.vcurve = 64;
+    EXPECT_THROW(svo::svo_apply_edits(slice.get(), {&bad_vcurve}), std::runtime_error);
+}
+
+TEST_F(EditLogTest,compact)
+{
+    svo::svo_slice_id_t child_id, other_id;
+    {
+        svo::svo_archive_t archive(m_archive_data);
+        child_id = archive.find_child(0, 56);
+        other_id = archive.find_child(0, 0);
+        ASSERT_NE(child_id, svo::invalid_slice_id);
+        ASSERT_NE(other_id, svo::invalid_slice_id);
+    }
+    slice_ptr_t child_before = load_slice(child_id);
+
+    svo::svo_edit_log_t log(m_path);
+    log.erase(0, 63);
+    log.erase(child_id, 0);
+    log.insert(child_id, 1, {1, 2, 3});
+    uint8_t value[3] = {9, 9, 9};
+    log.update(child_id, 3, "color", value, sizeof(value));
+    ///not in the slice; ignored.
+    log.update(child_id, 2, "color", value, sizeof(value));
+
+    m_archive_data.clear();
+    m_archive_data.seekg(0);
+    log.compact_async(m_archive_data).get();
+    EXPECT_EQ(log.size(), 0U);
+
+    slice_ptr_t root = load_slice(0);
+    EXPECT_EQ(root->pos_data->size(), 63U);
+    EXPECT_FALSE(contains(root.get(), 63));
+
+    slice_ptr_t child = load_slice(child_id);
+    EXPECT_EQ(child->pos_data->size(), child_before->pos_data->size());
+    EXPECT_FALSE(contains(child.get(), 0));
+    EXPECT_TRUE(contains(child.get(), 1));
+    EXPECT_FALSE(contains(child.get(), 2));
+    EXPECT_EQ(color(child.get(), 1), (std::vector<uint8_t>{1, 2, 3}));
+    EXPECT_EQ(color(child.get(), 3), (std::vector<uint8_t>{9, 9, 9}));
+    EXPECT_EQ(color(child.get(), 6), color(child_before.get(), 6));
+
+    ///the untouched child is unchanged.
+    slice_ptr_t other = load_slice(other_id);
+    EXPECT_EQ(other->pos_data->size(), 32U);
+
+    ///the log keeps working after compaction.
+    log.erase(child_id, 1);
+    m_archive_data.clear();
+    m_archive_data.seekg(0);
+    log.compact(m_archive_data);
+    EXPECT_FALSE(contains(load_slice(child_id).get(), 1));
+
+    svo::svo_edit_log_t reopened(m_path);
+    EXPECT_EQ(reopened.size(), 0U);
+
+    ///each compaction appended the child again; a rewrite drops the dead copies.
+    std::stringstream rewritten;
+    m_archive_data.clear();
+    m_archive_data.seekg(0);
+    svo::svo_rewrite_archive(m_archive_data, rewritten);
+    EXPECT_LT(rewritten.str().size(), m_archive_data.str().size());
+
+    svo::svo_archive_t rewritten_archive(rewritten);
+    ASSERT_EQ(rewritten_archive.size(), 3U);
+    for (svo::svo_slice_id_t slice_id = 0; slice_id < rewritten_archive.size(); ++slice_id)
+    {
+        slice_ptr_t expected = load_slice(slice_id);
+        svo::svo_slice_t* slice = rewritten_archive.load_subtree(slice_id, 0);
+        EXPECT_EQ(*slice->pos_data, *expected->pos_data) << "slice: " << slice_id;
+        svo::svo_uninit_slice(slice, true);
+    }
+}
@@ -74,3 +74,20 @@ TEST_F(EntreeSlicesTest,entree_slices)
 
 
 
+
+
+TEST_F(EntreeSlicesTest,background_validation)
+{
+    std::size_t max_voxels_per_slice = 8;
+    auto* root = svo::svo_entree_slices(*volume_of_slices, max_voxels_per_slice/*max_voxels_per_slice*/);
+
+    ASSERT_NE(root, nullptr);
+
+    auto report = svo::svo_validate_async(nullptr, root).get();
+
+    EXPECT_FALSE(report) << report;
+    EXPECT_EQ(report.blocks_checked, std::size_t(0));
+    EXPECT_GT(report.slices_checked, std::size_t(1));
+
+    svo::svo_uninit_slice(root, true);
+}
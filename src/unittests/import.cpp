@@ -0,0 +1,196 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_import.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <map>
+#include <tuple>
+#include <sstream>
+#include <random>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+
+struct ImportTest : public ::testing::Test {
+protected:
+
+    svo::svo_declaration_t m_declaration;
+
+    virtual void SetUp() {
+        m_declaration.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::UNSIGNED_BYTE, 3));
+    }
+
+    static void free_slices(svo::volume_of_slices_t& volume)
+    {
+        for (auto& s : volume.slices)
+            svo::svo_uninit_slice(std::get<1>(s), true);
+        volume.slices.clear();
+    }
+
+    typedef std::tuple<vside_t, vside_t, vside_t> coords_t;
+
+    ///checks that @c volume holds exactly the voxels of @c expected, and that the slices are sorted.
+    static void expect_voxels(const svo::volume_of_slices_t& volume, const std::map<coords_t, std::vector<uint8_t> >& expected)
+    {
+        std::size_t total = 0;
+        for (std::size_t slice_index = 0; slice_index < volume.slices.size(); ++slice_index)
+        {
+            vcurve_t slice_vcurve; const svo::svo_slice_t* slice;
+            std::tie(slice_vcurve, slice) = volume.slices[slice_index];
+            if (slice_index > 0) {
+                EXPECT_LT(std::get<0>(volume.slices[slice_index - 1]), slice_vcurve);
+            }
+
+            ASSERT_EQ(slice->side, volume.slice_side);
+            ASSERT_FALSE(slice->pos_data->empty());
+            EXPECT_TRUE(std::is_sorted(slice->pos_data->begin(), slice->pos_data->end()));
+            EXPECT_EQ(std::adjacent_find(slice->pos_data->begin(), slice->pos_data->end()), slice->pos_data->end());
+
+            vside_t sx, sy, sz;
+            vcurve2coords(slice_vcurve, volume.volume_side, &sx, &sy, &sz);
+
+            const auto& buffer = slice->buffers->buffers()[0];
+            ASSERT_EQ(buffer.entries(), slice->pos_data->size());
+
+            for (std::size_t i = 0; i < slice->pos_data->size(); ++i)
+            {
+                vside_t x, y, z;
+                vcurve2coords((*slice->pos_data)[i], slice->side, &x, &y, &z);
+                coords_t coords(sx * volume.slice_side + x, sy * volume.slice_side + y, sz * volume.slice_side + z);
+
+                auto w = expected.find(coords);
+                ASSERT_NE(w, expected.end());
+                EXPECT_EQ(std::vector<uint8_t>(buffer.rawdata() + i*3, buffer.rawdata() + i*3 + 3), w->second);
+            }
+            total += slice->pos_data->size();
+        }
+        EXPECT_EQ(total, expected.size());
+    }
+};
+
+
+TEST_F(ImportTest,points)
+{
+    std::vector<vside_t> coords = {7,7,7,  0,0,0,  3,4,5,  0,0,0};
+    std::vector<uint8_t> attributes = {1,1,1,  2,2,2,  3,3,3,  4,4,4};
+
+    svo::volume_of_slices_t volume(2, 4);
+    svo::svo_import_points(volume, m_declaration, coords.data(), attributes.data(), 4);
+
+    ///the second point at the origin wins.
+    std::map<coords_t, std::vector<uint8_t> > expected;
+    expected[coords_t(7,7,7)] = {1,1,1};
+    expected[coords_t(0,0,0)] = {4,4,4};
+    expected[coords_t(3,4,5)] = {3,3,3};
+
+    ASSERT_EQ(volume.slices.size(), 3U);
+    expect_voxels(volume, expected);
+    free_slices(volume);
+}
+
+TEST_F(ImportTest,points_parallel)
+{
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<vside_t> coord(0, 63);
+
+    std::size_t count = 50000;
+    std::vector<vside_t> coords(count*3);
+    std::vector<uint8_t> attributes(count*3);
+    std::map<coords_t, std::vector<uint8_t> > expected;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            coords[i*3 + j] = coord(rng);
+            attributes[i*3 + j] = uint8_t(i * 3 + j);
+        }
+        expected[coords_t(coords[i*3], coords[i*3 + 1], coords[i*3 + 2])] = std::vector<uint8_t>(&attributes[i*3], &attributes[i*3] + 3);
+    }
+
+    svo::volume_of_slices_t volume(4, 16);
+    svo::svo_import_points(volume, m_declaration, coords.data(), attributes.data(), count, 4);
+
+    EXPECT_EQ(volume.slices.size(), 64U);
+    expect_voxels(volume, expected);
+    free_slices(volume);
+}
+
+TEST_F(ImportTest,points_outside)
+{
+    std::vector<vside_t> coords = {0,0,0,  8,0,0};
+    std::vector<uint8_t> attributes(6);
+
+    svo::volume_of_slices_t volume(2, 4);
+    EXPECT_THROW(svo::svo_import_points(volume, m_declaration, coords.data(), attributes.data(), 2), std::runtime_error);
+    EXPECT_TRUE(volume.slices.empty());
+}
+
+TEST_F(ImportTest,bad_volume)
+{
+    std::vector<vside_t> coords = {0,0,0};
+    std::vector<uint8_t> attributes(3);
+
+    std::vector<std::pair<vside_t, vside_t> > sides = {
+          {0, 4}
+        , {4, 0}
+        , {3, 4}
+        , {4, 6}
+        , {vside_t(SVO_VSIDE_LIMIT), 2}
+        , {2, vside_t(SVO_VSIDE_LIMIT)}
+    };
+
+    for (const auto& side : sides)
+    {
+        svo::volume_of_slices_t volume(side.first, side.second);
+        EXPECT_THROW(svo::svo_import_points(volume, m_declaration, coords.data(), attributes.data(), 1), std::runtime_error)
+            << "volume side: " << side.first << ", slice side: " << side.second;
+        EXPECT_TRUE(volume.slices.empty());
+    }
+
+    ///exactly as large as a vcurve allows
+    svo::volume_of_slices_t volume(vside_t(SVO_VSIDE_LIMIT / 2), 2);
+    svo::svo_import_points(volume, m_declaration, coords.data(), attributes.data(), 1);
+    EXPECT_EQ(volume.slices.size(), 1U);
+    free_slices(volume);
+}
+
+TEST_F(ImportTest,dense)
+{
+    vside_t width = 6, height = 5, depth = 8;
+
+    std::vector<uint8_t> grid(width*height*depth*3, 0);
+    std::map<coords_t, std::vector<uint8_t> > expected;
+    for (vside_t z = 0; z < depth; ++z)
+    for (vside_t y = 0; y < height; ++y)
+    for (vside_t x = 0; x < width; ++x)
+    {
+        ///a sphere-ish blob; everything else stays zero, i.e. empty.
+        int dx = int(x) - 3, dy = int(y) - 2, dz = int(z) - 4;
+        if (dx*dx + dy*dy + dz*dz > 9)
+            continue;
+
+        std::size_t index = (z*height + y)*width + x;
+        std::vector<uint8_t> color = {uint8_t(x + 1), uint8_t(y), uint8_t(z)};
+        std::memcpy(&grid[index*3], color.data(), 3);
+        expected[coords_t(x, y, z)] = color;
+    }
+
+    svo::volume_of_slices_t volume(2, 4);
+    svo::svo_import_dense(volume, m_declaration, grid.data(), width, height, depth, 3);
+    expect_voxels(volume, expected);
+    free_slices(volume);
+
+    ///from a stream, with a custom emptiness test.
+    std::stringstream raw(std::string(grid.begin(), grid.end()));
+    svo::svo_import_dense(volume, m_declaration, raw, width, height, depth, 1
+                         , [](const uint8_t* entry){ return entry[0] < 4; });
+    for (auto w = expected.begin(); w != expected.end(); )
+        w = (w->second[0] < 4) ? expected.erase(w) : std::next(w);
+    expect_voxels(volume, expected);
+    free_slices(volume);
+
+    std::stringstream truncated(std::string(grid.begin(), grid.begin() + 10));
+    EXPECT_THROW(svo::svo_import_dense(volume, m_declaration, truncated, width, height, depth), std::runtime_error);
+
+    EXPECT_THROW(svo::svo_import_dense(volume, m_declaration, grid.data(), 9, 1, 1), std::runtime_error);
+}
@@ -0,0 +1,72 @@
+#include "landscapes/svo_tree.lod.hpp"
+#include "gtest/gtest.h"
+
+class LODTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+    // Code here will be called immediately after each test
+    // (right before the destructor).
+    }
+    };
+
+
+
+TEST_F(LODTest,max_level){
+
+    ///rayScale2 of 4, => q*2 is the distance at which a voxel becomes a pixel.
+    float ray_scale2 = 4;
+
+    EXPECT_EQ(svo_lod_max_level(2, ray_scale2), 0U);
+    EXPECT_EQ(svo_lod_max_level(1, ray_scale2), 1U);
+    EXPECT_EQ(svo_lod_max_level(.5, ray_scale2), 2U);
+    EXPECT_EQ(svo_lod_max_level(.3, ray_scale2), 3U);
+    EXPECT_EQ(svo_lod_max_level(0, ray_scale2), uint32_t(MAXIMUM_TREE_DEPTH));
+
+    ///closer things need deeper levels
+    for (float distance = .001f; distance < 10; distance *= 2)
+        EXPECT_GE(svo_lod_max_level(distance, ray_scale2), svo_lod_max_level(distance*2, ray_scale2));
+}
+
+TEST_F(LODTest,controller_converges){
+
+    svo::svo_lod_controller_t controller(1e6f, 16, 1e-6f);
+
+    ///a fake renderer whose frame time is proportional to the number of levels it descends at a fixed distance
+    auto render = [&controller]()
+    {
+        return 2.0 * controller.max_level(.01f);
+    };
+
+    float initial_ray_scale2 = controller.ray_scale2();
+    double initial_frame_ms = render();
+    ASSERT_GT(initial_frame_ms, 16);
+
+    double frame_ms = initial_frame_ms;
+    for (int frame = 0; frame < 200; ++frame)
+    {
+        controller.update(frame_ms);
+        frame_ms = render();
+    }
+
+    EXPECT_LT(controller.ray_scale2(), initial_ray_scale2);
+    EXPECT_LE(frame_ms, 16*(1 + controller.dead_band) + 2);
+
+    ///when there is headroom, quality is restored, up to the base rayScale2.
+    for (int frame = 0; frame < 200; ++frame)
+        controller.update(1);
+    EXPECT_FLOAT_EQ(controller.ray_scale2(), initial_ray_scale2);
+}
+
+TEST_F(LODTest,controller_floor){
+
+    svo::svo_lod_controller_t controller(100, 16, .25f);
+
+    for (int frame = 0; frame < 200; ++frame)
+        controller.update(1000);
+
+    EXPECT_FLOAT_EQ(controller.ray_scale2(), 25);
+}
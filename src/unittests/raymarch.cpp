@@ -0,0 +1,199 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_tree.raymarch.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+/**
+ * A two level tree in the unit cube: the root has one non-leaf child at corner (1,0,0), and that
+ * child has one leaf at its own corner (0,0,0). The only solid voxel is thus
+ * [0.5,0.75]x[0,0.25]x[0,0.25].
+ */
+class RaymarchTest : public ::testing::Test {
+protected:
+    RaymarchTest()
+        : tree(SVO_PAGE_SIZE*8, SVO_PAGE_SIZE*4)
+    {}
+
+    virtual void SetUp() {
+        using namespace svo;
+        svo_block_t* block = tree.root_block;
+        byte_t* address_space = tree.address_space;
+
+        root_cd_goffset = block->root_shadow_cd_goffset;
+
+        child_descriptor_t cd;
+        svo_init_cd(&cd);
+        goffset_t child_cd_goffset = svo_append_cd(address_space, block, &cd);
+
+        child_descriptor_t* root_cd = svo_get_cd(address_space, root_cd_goffset);
+        svo_init_cd(root_cd);
+        svo_set_valid_mask(root_cd, 1 << corner2ccurve(get_corner_by_int3(1,0,0)));
+        svo_set_leaf_mask(root_cd, 0);
+        svo_set_child_ptr(root_cd, (child_cd_goffset - root_cd_goffset) / 4);
+
+        child_descriptor_t* child_cd = svo_get_cd(address_space, child_cd_goffset);
+        svo_init_cd(child_cd);
+        svo_set_valid_mask(child_cd, 1 << corner2ccurve(get_corner_by_int3(0,0,0)));
+        svo_set_leaf_mask(child_cd, 1 << corner2ccurve(get_corner_by_int3(0,0,0)));
+
+        block->root_valid_bit = 1;
+        block->root_leaf_bit = 0;
+        block->height = 3;
+    }
+
+    virtual void TearDown() {
+    // Code here will be called immediately after each test
+    // (right before the destructor).
+    }
+
+    bool raymarch(float3_t raypos, float3_t raydir, float* out_t = nullptr)
+    {
+        float3_t normal;
+        float t = 0;
+        bool hit = svo_tree_raymarch(tree.address_space, root_cd_goffset, raypos, raydir, rayScale2, &normal, &t, nullptr);
+        if (out_t)
+            *out_t = t;
+        return hit;
+    }
+
+    bool anyhit(float3_t raypos, float3_t raydir, float max_t2)
+    {
+        return svo_tree_raymarch_anyhit(tree.address_space, root_cd_goffset, raypos, raydir, rayScale2, max_t2);
+    }
+
+    ///large enough that no voxel in the tree is ever sub-pixel, so rays always descend to the leaves.
+    static constexpr float rayScale2 = 1e12f;
+
+    svo::svo_tree_t tree;
+    goffset_t root_cd_goffset;
+};
+
+
+TEST_F(RaymarchTest,anyhit_agrees_with_raymarch){
+    std::vector<float3_t> rayposs = {
+          make_float3(-1, .125, .125)
+        , make_float3(-1, .375, .125)
+        , make_float3(-1, .625, .125)
+        , make_float3(.625, .125, -1)
+        , make_float3(.625, .625, -1)
+        , make_float3(.625, 2, .125)
+    };
+    std::vector<float3_t> raydirs = {
+          make_float3(1, 0, 0)
+        , make_float3(1, 0, 0)
+        , make_float3(1, 0, 0)
+        , make_float3(0, 0, 1)
+        , make_float3(0, 0, 1)
+        , make_float3(0, -1, 0)
+    };
+
+    for (std::size_t i = 0; i < rayposs.size(); ++i)
+    {
+        EXPECT_EQ(raymarch(rayposs[i], raydirs[i]), anyhit(rayposs[i], raydirs[i], fposinf)) << "ray: " << i;
+    }
+}
+
+TEST_F(RaymarchTest,anyhit_miss){
+    ///passes through the root child's cube, but not through its only leaf
+    EXPECT_FALSE(raymarch(make_float3(-1, .375, .125), make_float3(1, 0, 0)));
+    EXPECT_FALSE(anyhit(make_float3(-1, .375, .125), make_float3(1, 0, 0), fposinf));
+
+    ///misses the root entirely
+    EXPECT_FALSE(anyhit(make_float3(-1, 2, .125), make_float3(1, 0, 0), fposinf));
+
+    ///points away from the voxel
+    EXPECT_FALSE(anyhit(make_float3(-1, .125, .125), make_float3(-1, 0, 0), fposinf));
+}
+
+TEST_F(RaymarchTest,anyhit_max_t2){
+    float3_t raypos = make_float3(-1, .125, .125);
+    float3_t raydir = make_float3(1, 0, 0);
+
+    ///the voxel starts 1.5 units away
+    EXPECT_TRUE(anyhit(raypos, raydir, 4));
+    EXPECT_FALSE(anyhit(raypos, raydir, 1));
+}
+
+TEST_F(RaymarchTest,anyhit_inside_root){
+    float3_t raypos = make_float3(.25, .125, .125);
+    float3_t raydir = make_float3(1, 0, 0);
+
+    EXPECT_TRUE(raymarch(raypos, raydir));
+    EXPECT_TRUE(anyhit(raypos, raydir, fposinf));
+    EXPECT_FALSE(anyhit(raypos, make_float3(0, 1, 0), fposinf));
+}
+
+TEST_F(RaymarchTest,occluded_n){
+    std::vector<float3_t> rayposs = {
+          make_float3(-1, .125, .125)
+        , make_float3(-1, .375, .125)
+        , make_float3(-1, .125, .125)
+        , make_float3(.25, .125, .125)
+    };
+    std::vector<float3_t> raydirs = {
+          make_float3(1, 0, 0)
+        , make_float3(1, 0, 0)
+        , make_float3(1, 0, 0)
+        , make_float3(1, 0, 0)
+    };
+    std::vector<float> max_t2s = { fposinf, fposinf, 1, fposinf };
+    std::vector<uint8_t> occluded(rayposs.size(), 0xFF);
+
+    std::size_t count = svo_tree_occluded_n(tree.address_space, root_cd_goffset
+                                           , &rayposs[0], &raydirs[0], &max_t2s[0]
+                                           , rayScale2, rayposs.size(), &occluded[0]);
+    EXPECT_EQ(count, 2U);
+    EXPECT_EQ(occluded, (std::vector<uint8_t>{1, 0, 0, 1}));
+
+    ///null max_t2s means unbounded
+    count = svo_tree_occluded_n(tree.address_space, root_cd_goffset
+                               , &rayposs[0], &raydirs[0], nullptr
+                               , rayScale2, rayposs.size(), &occluded[0]);
+    EXPECT_EQ(count, 3U);
+    EXPECT_EQ(occluded, (std::vector<uint8_t>{1, 0, 1, 1}));
+}
+
+TEST_F(RaymarchTest,stats){
+    float3_t raypos = make_float3(-1, .125, .125);
+    float3_t raydir = make_float3(1, 0, 0);
+    float3_t normal;
+    float t = 0;
+    svo_raymarch_stats_t stats;
+
+    ///hit: the empty (0,0,0) root child, then PUSH into the (1,0,0) root child, whose first
+    /// child along the ray is the leaf
+    EXPECT_TRUE(svo_tree_raymarch(tree.address_space, root_cd_goffset, raypos, raydir, rayScale2
+                                 , &normal, &t, &stats));
+    EXPECT_EQ(stats.iterations, 3U);
+    EXPECT_EQ(stats.max_depth, 2U);
+    EXPECT_EQ(stats.cd_fetches, 4U);
+    EXPECT_EQ(stats.far_ptr_follows, 0U);
+    EXPECT_EQ(stats.pushes, 1U);
+    EXPECT_EQ(stats.pops, 0U);
+    EXPECT_EQ(stats.hit, 1U);
+    EXPECT_EQ(stats.hit_depth, 2U);
+
+    ///a null out_stats traces the same ray
+    float3_t null_stats_normal;
+    float null_stats_t = 0;
+    EXPECT_TRUE(svo_tree_raymarch(tree.address_space, root_cd_goffset, raypos, raydir, rayScale2
+                                 , &null_stats_normal, &null_stats_t, nullptr));
+    EXPECT_EQ(null_stats_t, t);
+
+    ///miss: PUSH into the (1,0,0) root child, ADVANCE through its two empty children along the
+    /// ray, then POP back to the root children and POP out of the root
+    EXPECT_FALSE(svo_tree_raymarch(tree.address_space, root_cd_goffset
+                                  , make_float3(-1, .375, .125), raydir, rayScale2
+                                  , &normal, &t, &stats));
+    EXPECT_EQ(stats.iterations, 6U);
+    EXPECT_EQ(stats.max_depth, 2U);
+    EXPECT_EQ(stats.pushes, 1U);
+    EXPECT_EQ(stats.pops, 2U);
+    EXPECT_EQ(stats.hit, 0U);
+    EXPECT_EQ(stats.hit_depth, 0U);
+
+    EXPECT_FALSE(svo_tree_raymarch(tree.address_space, root_cd_goffset
+                                  , make_float3(-1, .375, .125), raydir, rayScale2
+                                  , &normal, &t, nullptr));
+}
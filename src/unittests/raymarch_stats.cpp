@@ -0,0 +1,104 @@
+#include "landscapes/svo_tree.raymarch.stats.hpp"
+#include "gtest/gtest.h"
+#include <sstream>
+#include <string>
+
+class RaymarchStatsTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+    // Code here will be called immediately after each test
+    // (right before the destructor).
+    }
+    };
+
+
+static svo_raymarch_stats_t make_stats(uint32_t iterations, uint32_t max_depth, uint32_t cd_fetches, uint32_t far_ptr_follows, bool hit)
+{
+    svo_raymarch_stats_t stats;
+    svo_raymarch_stats_init(&stats);
+    stats.iterations = iterations;
+    stats.max_depth = max_depth;
+    stats.cd_fetches = cd_fetches;
+    stats.far_ptr_follows = far_ptr_follows;
+    stats.hit = hit ? 1 : 0;
+    return stats;
+}
+
+TEST_F(RaymarchStatsTest,histogram){
+    using namespace svo;
+
+    svo_raymarch_histogram_t histogram(8);
+
+    for (uint32_t value = 0; value < 4; ++value)
+        histogram.add(value);
+    ///clamped into the last bin
+    histogram.add(100);
+
+    EXPECT_EQ(histogram.samples, 5U);
+    EXPECT_EQ(histogram.max, 100U);
+    EXPECT_EQ(histogram.bins[7], 1U);
+    EXPECT_DOUBLE_EQ(histogram.mean(), (0 + 1 + 2 + 3 + 100) / 5.0);
+    EXPECT_EQ(histogram.percentile(0), 0U);
+    EXPECT_EQ(histogram.percentile(.5), 2U);
+    EXPECT_EQ(histogram.percentile(1), 7U);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.samples, 0U);
+    EXPECT_EQ(histogram.percentile(.5), 0U);
+}
+
+TEST_F(RaymarchStatsTest,frame_stats){
+    using namespace svo;
+
+    svo_raymarch_frame_stats_t frame_stats(64);
+
+    frame_stats.add(make_stats(10, 3, 12, 0, true));
+    frame_stats.add(make_stats(20, 5, 30, 2, false));
+
+    EXPECT_EQ(frame_stats.rays, 2U);
+    EXPECT_EQ(frame_stats.hits, 1U);
+    EXPECT_EQ(frame_stats.histogram(svo_raymarch_metric_t::iterations).max, 20U);
+    EXPECT_EQ(frame_stats.histogram(svo_raymarch_metric_t::max_depth).max, 5U);
+    EXPECT_EQ(frame_stats.histogram(svo_raymarch_metric_t::cd_fetches).sum, 42U);
+    EXPECT_EQ(frame_stats.histogram(svo_raymarch_metric_t::far_ptr_follows).sum, 2U);
+
+    std::ostringstream out;
+    out << frame_stats;
+    EXPECT_NE(out.str().find("iterations"), std::string::npos);
+
+    frame_stats.reset();
+    EXPECT_EQ(frame_stats.rays, 0U);
+    EXPECT_EQ(frame_stats.histogram(svo_raymarch_metric_t::iterations).samples, 0U);
+}
+
+TEST_F(RaymarchStatsTest,heatmap){
+    using namespace svo;
+
+    svo_raymarch_heatmap_t heatmap(4, 2);
+
+    heatmap.at(0,0) = make_stats(0, 0, 0, 0, false);
+    heatmap.at(3,1) = make_stats(40, 8, 50, 1, true);
+
+    svo_raymarch_frame_stats_t frame_stats;
+    heatmap.aggregate(frame_stats);
+    EXPECT_EQ(frame_stats.rays, 8U);
+    EXPECT_EQ(frame_stats.hits, 1U);
+
+    std::ostringstream out;
+    heatmap.write_ppm(out, svo_raymarch_metric_t::iterations);
+
+    std::string header = "P6\n4 2\n255\n";
+    std::string image = out.str();
+    ASSERT_EQ(image.size(), header.size() + 4*2*3);
+    EXPECT_EQ(image.substr(0, header.size()), header);
+
+    ///the cheapest pixel is pure blue, the most expensive pure red.
+    EXPECT_EQ(uint8_t(image[header.size() + 0]), 0);
+    EXPECT_EQ(uint8_t(image[header.size() + 2]), 255);
+    EXPECT_EQ(uint8_t(image[image.size() - 3]), 255);
+    EXPECT_EQ(uint8_t(image[image.size() - 1]), 0);
+}
@@ -0,0 +1,536 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_serialization.v1.hpp"
+#include "landscapes/svo_serialization.v2.hpp"
+#include "landscapes/svo_tree.sanity.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <sstream>
+#include <random>
+#include <cstring>
+#include <limits>
+#include <cmath>
+
+struct SerializeV2Test : public ::testing::Test {
+    const svo::svo_slice_t* slice0;
+protected:
+
+    svo::svo_slice_t* m_slice0;
+
+    virtual void SetUp() {
+        std::mt19937 gen(0);
+
+        ///a sparse slice with an interleaved, mixed width buffer.
+        m_slice0 = svo::svo_init_slice(0, 16);
+
+        auto& pos_data = *m_slice0->pos_data;
+        for (vcurve_t vcurve = 0; vcurve < vcurvesize(m_slice0->side); ++vcurve)
+        {
+            if (gen() % 3 == 0)
+                pos_data.push_back(vcurve);
+        }
+
+        svo::svo_declaration_t declaration;
+        declaration.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::UNSIGNED_BYTE, 3));
+        declaration.add(svo::svo_element_t("normal", svo::svo_semantic_t::NORMAL, svo::svo_data_type_t::FLOAT, 3));
+        declaration.add(svo::svo_element_t("id", svo::svo_semantic_t::NONE, svo::svo_data_type_t::UNSIGNED_SHORT, 1));
+        declaration.add(svo::svo_element_t("weight", svo::svo_semantic_t::NONE, svo::svo_data_type_t::DOUBLE, 1));
+
+        auto& buffer = m_slice0->buffers->add_buffer(declaration, pos_data.size());
+        for (std::size_t byte_index = 0; byte_index < buffer.bytes(); ++byte_index)
+            buffer.rawdata()[byte_index] = uint8_t(gen());
+
+        slice0 = m_slice0;
+    }
+
+    virtual void TearDown() {
+        svo::svo_uninit_slice(m_slice0, true);
+    }
+
+    void expect_same_slice(const svo::svo_slice_t* slice1)
+    {
+        EXPECT_EQ(slice0->side, slice1->side);
+        ASSERT_EQ(*slice0->pos_data, *slice1->pos_data);
+        ASSERT_EQ(slice0->buffers->schema(), slice1->buffers->schema());
+        ASSERT_EQ(slice0->buffers->entries(), slice1->buffers->entries());
+
+        const auto& buffers0_list = slice0->buffers->buffers();
+        const auto& buffers1_list = slice1->buffers->buffers();
+        ASSERT_EQ(buffers0_list.size(), buffers1_list.size());
+
+        for (std::size_t buffer_index = 0; buffer_index < buffers0_list.size(); ++buffer_index)
+        {
+            const auto& buffer0 = buffers0_list[buffer_index];
+            const auto& buffer1 = buffers1_list[buffer_index];
+
+            ASSERT_EQ(buffer0.bytes(), buffer1.bytes());
+            EXPECT_EQ(0, std::memcmp(buffer0.rawdata(), buffer1.rawdata(), buffer0.bytes()));
+        }
+    }
+};
+
+
+TEST_F(SerializeV2Test,byte_orders)
+{
+    for (auto byte_order : {svo::svo_byte_order_t::little, svo::svo_byte_order_t::big})
+    {
+        svo::svo_serialization_options_t options;
+        options.byte_order = byte_order;
+
+        std::ostringstream out;
+        svo::serialize_slice_v2(out, slice0, options);
+
+        std::istringstream in(out.str());
+
+        svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+        svo::unserialize_slice_v2(in, slice1, true);
+
+        expect_same_slice(slice1);
+        svo::svo_uninit_slice(slice1, true);
+    }
+}
+
+TEST_F(SerializeV2Test,payload_layout)
+{
+    svo::svo_serialization_options_t options;
+    options.byte_order = svo::svo_byte_order_t::big;
+    options.checksums = false;
+
+    std::ostringstream out;
+    svo::serialize_slice_v2(out, slice0, options);
+    std::string data = out.str();
+
+    ///version, byte order, pos encoding, side, children count, entries; then the first vcurve, big-endian.
+    std::size_t pos_offset = 4 + 1 + 1 + 4 + 4 + 4;
+    ASSERT_GT(data.size(), pos_offset + 4);
+    EXPECT_EQ(uint8_t(data[4]), 1);
+
+    vcurve_t vcurve = (*slice0->pos_data)[0];
+    EXPECT_EQ(uint8_t(data[pos_offset + 0]), uint8_t(vcurve >> 24));
+    EXPECT_EQ(uint8_t(data[pos_offset + 3]), uint8_t(vcurve));
+}
+
+TEST_F(SerializeV2Test,unserialize_slice_dispatch)
+{
+    std::ostringstream out;
+    svo::serialize_slice_v2(out, slice0);
+
+    std::istringstream in(out.str());
+
+    svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+    svo::unserialize_slice(in, slice1, true);
+
+    expect_same_slice(slice1);
+    svo::svo_uninit_slice(slice1, true);
+}
+
+TEST_F(SerializeV2Test,truncated)
+{
+    std::ostringstream out;
+    svo::serialize_slice_v2(out, slice0);
+    std::string data = out.str();
+
+    std::istringstream in(data.substr(0, data.size() - 1));
+
+    svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+    EXPECT_THROW(svo::unserialize_slice_v2(in, slice1, true), std::runtime_error);
+    svo::svo_uninit_slice(slice1, true);
+}
+
+TEST_F(SerializeV2Test,checksums)
+{
+    std::ostringstream out;
+    svo::serialize_slice_v2(out, slice0);
+    std::string data = out.str();
+
+    ///version 3; then the header section's length.
+    EXPECT_EQ(uint8_t(data[3]), 3);
+
+    ///a flipped bit in the last buffer's payload.
+    std::string corrupt = data;
+    corrupt[corrupt.size() - 5] ^= 0x10;
+
+    {
+        std::istringstream in(corrupt);
+        svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+        EXPECT_THROW(svo::unserialize_slice_v2(in, slice1, true), std::runtime_error);
+        svo::svo_uninit_slice(slice1, true);
+    }
+
+    ///trusted data skips the checksums; the structure still has to be sound.
+    {
+        std::istringstream in(corrupt);
+        svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+        EXPECT_NO_THROW(svo::unserialize_slice_v2(in, slice1, true, svo::svo_slice_load_filter_t(), false));
+        EXPECT_EQ(*slice0->pos_data, *slice1->pos_data);
+        svo::svo_uninit_slice(slice1, true);
+    }
+
+    ///a section length pointing past the end of the stream.
+    {
+        std::string bad_length = data;
+        bad_length[4] = char(0x7F);
+        std::istringstream in(bad_length);
+        svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+        EXPECT_THROW(svo::unserialize_slice(in, slice1, true), std::runtime_error);
+        svo::svo_uninit_slice(slice1, true);
+    }
+}
+
+TEST_F(SerializeV2Test,delta_varint)
+{
+    svo::svo_serialization_options_t raw_options;
+    svo::svo_serialization_options_t delta_options;
+    delta_options.pos_encoding = svo::svo_pos_encoding_t::delta_varint;
+
+    std::ostringstream raw_out;
+    svo::serialize_slice_v2(raw_out, slice0, raw_options);
+    std::ostringstream delta_out;
+    svo::serialize_slice_v2(delta_out, slice0, delta_options);
+
+    EXPECT_LT(delta_out.str().size(), raw_out.str().size());
+
+    std::istringstream in(delta_out.str());
+
+    svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+    svo::unserialize_slice(in, slice1, true);
+
+    expect_same_slice(slice1);
+    svo::svo_uninit_slice(slice1, true);
+
+    ///without checksums, an encoded size far beyond what the entries can take is rejected before
+    /// anything is allocated for it.
+    delta_options.checksums = false;
+    std::ostringstream unchecked_out;
+    svo::serialize_slice_v2(unchecked_out, slice0, delta_options);
+    std::string data = unchecked_out.str();
+
+    std::vector<uint8_t> encoded;
+    svo::svo_encode_pos_data_delta(*slice0->pos_data, encoded);
+    std::string sizes;
+    for (uint32_t value : {uint32_t(slice0->pos_data->size()), uint32_t(encoded.size())})
+        for (int shift = 24; shift >= 0; shift -= 8)
+            sizes.push_back(char(value >> shift));
+    std::size_t sizes_offset = data.find(sizes);
+    ASSERT_NE(sizes_offset, std::string::npos);
+
+    data[sizes_offset + 4] = char(0x7F);
+    std::istringstream bad_in(data);
+    svo::svo_slice_t* slice2 = svo::svo_init_slice(0, 16);
+    EXPECT_THROW(svo::unserialize_slice(bad_in, slice2, true), std::runtime_error);
+    svo::svo_uninit_slice(slice2, true);
+}
+
+TEST_F(SerializeV2Test,column_size)
+{
+    svo::svo_serialization_options_t options;
+    options.buffer_layout = svo::svo_buffer_layout_t::columns;
+    options.checksums = false;
+
+    std::ostringstream out;
+    svo::serialize_slice_v2(out, slice0, options);
+    std::string data = out.str();
+
+    ///the last column, "weight", stored raw; its encoded size comes right before it.
+    std::size_t weight_bytes = slice0->pos_data->size()*sizeof(double);
+    std::size_t size_offset = data.size() - weight_bytes - 4;
+    ASSERT_EQ(uint32_t(uint8_t(data[size_offset + 2]))*256 + uint8_t(data[size_offset + 3]), weight_bytes);
+
+    ///a corrupt size runs into the end of the stream, instead of allocating it.
+    for (std::size_t i = 0; i < 4; ++i)
+        data[size_offset + i] = char(0xFF);
+
+    std::istringstream in(data);
+    svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+    EXPECT_THROW(svo::unserialize_slice_v2(in, slice1, true), std::runtime_error);
+    svo::svo_uninit_slice(slice1, true);
+}
+
+TEST_F(SerializeV2Test,delta_varint_runs)
+{
+    ///a solid range, isolated voxels, and values needing multi-byte varints.
+    std::vector<vcurve_t> pos_data0;
+    for (vcurve_t vcurve = 0; vcurve < 4096; ++vcurve)
+        pos_data0.push_back(vcurve);
+    pos_data0.push_back(5000);
+    pos_data0.push_back(5002);
+    pos_data0.push_back(1000000);
+    pos_data0.push_back(1000001);
+    pos_data0.push_back(vcurve_t(SVO_VCURVE_LIMIT - 1));
+
+    std::vector<uint8_t> encoded;
+    svo::svo_encode_pos_data_delta(pos_data0, encoded);
+    EXPECT_LT(encoded.size(), 32U);
+
+    std::vector<vcurve_t> pos_data1;
+    svo::svo_decode_pos_data_delta(encoded.data(), encoded.size(), pos_data0.size(), SVO_VSIDE_LIMIT, pos_data1);
+    EXPECT_EQ(pos_data0, pos_data1);
+
+    ///declaring more entries than were encoded is malformed.
+    std::vector<vcurve_t> pos_data2;
+    EXPECT_THROW(svo::svo_decode_pos_data_delta(encoded.data(), encoded.size(), pos_data0.size() + 1, SVO_VSIDE_LIMIT, pos_data2)
+                    , std::runtime_error);
+
+    ///and so are vcurves, or runs, past the end of the slice.
+    for (const std::vector<vcurve_t>& pos_data3 : {std::vector<vcurve_t>{0, 64}, std::vector<vcurve_t>{62, 63, 64}})
+    {
+        std::vector<uint8_t> encoded3;
+        svo::svo_encode_pos_data_delta(pos_data3, encoded3);
+
+        std::vector<vcurve_t> pos_data4;
+        EXPECT_THROW(svo::svo_decode_pos_data_delta(encoded3.data(), encoded3.size(), pos_data3.size(), 4, pos_data4)
+                        , std::runtime_error);
+        pos_data4.clear();
+        svo::svo_decode_pos_data_delta(encoded3.data(), encoded3.size(), pos_data3.size(), 8, pos_data4);
+        EXPECT_EQ(pos_data3, pos_data4);
+    }
+}
+
+TEST_F(SerializeV2Test,element_codecs)
+{
+    auto& buffer0 = m_slice0->buffers->buffers()[0];
+    const auto& declaration = buffer0.declaration();
+    std::size_t stride = declaration.stride();
+
+    ///a handful of colors, and normals in [-1,1].
+    for (std::size_t entry_index = 0; entry_index < buffer0.entries(); ++entry_index)
+    {
+        uint8_t* entry = buffer0.rawdata() + entry_index*stride;
+        for (std::size_t component = 0; component < 3; ++component)
+            entry[declaration.offset(0) + component] = uint8_t((entry_index % 4) * 60 + component);
+
+        float normal[3] = { std::cos(float(entry_index)), std::sin(float(entry_index)), -1 };
+        std::memcpy(entry + declaration.offset(1), normal, sizeof(normal));
+    }
+
+    for (auto byte_order : {svo::svo_byte_order_t::little, svo::svo_byte_order_t::big})
+    {
+        svo::svo_serialization_options_t raw_options;
+        raw_options.byte_order = byte_order;
+
+        svo::svo_serialization_options_t options = raw_options;
+        options.element_codecs["color"] = svo::svo_element_codec_t::palette;
+        options.element_codecs["normal"] = svo::svo_element_codec_t::quantize;
+        options.element_codecs["weight"] = svo::svo_element_codec_t::zlib;
+
+        std::ostringstream raw_out;
+        svo::serialize_slice_v2(raw_out, slice0, raw_options);
+        std::ostringstream out;
+        svo::serialize_slice_v2(out, slice0, options);
+
+        EXPECT_LT(out.str().size(), raw_out.str().size());
+
+        std::istringstream in(out.str());
+        svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+        svo::unserialize_slice(in, slice1, true);
+
+        ASSERT_EQ(*slice0->pos_data, *slice1->pos_data);
+        ASSERT_EQ(slice0->buffers->schema(), slice1->buffers->schema());
+
+        const auto& buffer1 = slice1->buffers->buffers()[0];
+        for (std::size_t entry_index = 0; entry_index < buffer0.entries(); ++entry_index)
+        {
+            const uint8_t* entry0 = buffer0.rawdata() + entry_index*stride;
+            const uint8_t* entry1 = buffer1.rawdata() + entry_index*stride;
+
+            ///lossless elements.
+            for (std::size_t element_index : {0, 2, 3})
+            {
+                std::size_t offset = declaration.offset(element_index);
+                ASSERT_EQ(0, std::memcmp(entry0 + offset, entry1 + offset, declaration.elements()[element_index].bytes()));
+            }
+
+            ///quantized normals.
+            float normal0[3], normal1[3];
+            std::memcpy(normal0, entry0 + declaration.offset(1), sizeof(normal0));
+            std::memcpy(normal1, entry1 + declaration.offset(1), sizeof(normal1));
+            for (std::size_t component = 0; component < 3; ++component)
+                ASSERT_NEAR(normal0[component], normal1[component], 2.f / 65535);
+        }
+
+        svo::svo_uninit_slice(slice1, true);
+    }
+}
+
+TEST_F(SerializeV2Test,element_codec_fallback)
+{
+    ///random bytes do not palettize, and integers do not quantize; both fall back to raw columns.
+    const auto& buffer0 = slice0->buffers->buffers()[0];
+
+    svo::svo_element_codec_params_t params;
+    std::vector<uint8_t> encoded;
+    EXPECT_EQ(svo::svo_encode_element(buffer0, 3, svo::svo_element_codec_t::palette, params, encoded)
+                , svo::svo_element_codec_t::none);
+    EXPECT_EQ(encoded.size(), buffer0.entries() * 8);
+
+    encoded.clear();
+    EXPECT_EQ(svo::svo_encode_element(buffer0, 2, svo::svo_element_codec_t::quantize, params, encoded)
+                , svo::svo_element_codec_t::none);
+}
+
+TEST_F(SerializeV2Test,quantize_bits)
+{
+    svo::svo_declaration_t declaration;
+    declaration.add(svo::svo_element_t("value", svo::svo_semantic_t::NONE, svo::svo_data_type_t::FLOAT, 1));
+
+    static const std::size_t entries = 100;
+    svo::svo_cpu_buffer_t buffer0(declaration, entries);
+    float* values0 = reinterpret_cast<float*>(buffer0.rawdata());
+    for (std::size_t i = 0; i < entries; ++i)
+        values0[i] = float(i) / (entries - 1);
+
+    for (uint32_t bits : {1, 5, 8, 12, 16})
+    {
+        svo::svo_element_codec_params_t params;
+        params.quantize_bits = bits;
+
+        std::vector<uint8_t> encoded;
+        ASSERT_EQ(svo::svo_encode_element(buffer0, 0, svo::svo_element_codec_t::quantize, params, encoded)
+                    , svo::svo_element_codec_t::quantize);
+        ///bits, min and max, then the packed values.
+        EXPECT_EQ(encoded.size(), 1 + 16 + (entries*bits + 7) / 8) << "bits: " << bits;
+
+        svo::svo_cpu_buffer_t buffer1(declaration, entries);
+        svo::svo_decode_element(buffer1, 0, svo::svo_element_codec_t::quantize, params.byte_order, encoded.data(), encoded.size());
+        const float* values1 = reinterpret_cast<const float*>(buffer1.rawdata());
+        for (std::size_t i = 0; i < entries; ++i)
+            ASSERT_NEAR(values0[i], values1[i], 0.5f / ((1 << bits) - 1) + 1e-6f) << "bits: " << bits << ", i: " << i;
+
+        ///a width outside of [1,16] is malformed.
+        for (uint8_t bad_bits : {0, 17})
+        {
+            encoded[0] = bad_bits;
+            EXPECT_THROW(svo::svo_decode_element(buffer1, 0, svo::svo_element_codec_t::quantize, params.byte_order, encoded.data(), encoded.size())
+                            , std::runtime_error);
+        }
+    }
+
+    for (uint32_t bits : {0, 17})
+    {
+        svo::svo_element_codec_params_t params;
+        params.quantize_bits = bits;
+        std::vector<uint8_t> encoded;
+        EXPECT_THROW(svo::svo_encode_element(buffer0, 0, svo::svo_element_codec_t::quantize, params, encoded), std::runtime_error);
+    }
+
+    ///non-finite values are not quantized; the column is stored raw instead.
+    for (float bad_value : {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()})
+    {
+        svo::svo_cpu_buffer_t buffer2 = buffer0;
+        reinterpret_cast<float*>(buffer2.rawdata())[7] = bad_value;
+
+        svo::svo_element_codec_params_t params;
+        std::vector<uint8_t> encoded;
+        EXPECT_EQ(svo::svo_encode_element(buffer2, 0, svo::svo_element_codec_t::quantize, params, encoded)
+                    , svo::svo_element_codec_t::none);
+        EXPECT_EQ(encoded.size(), entries * sizeof(float));
+    }
+}
+
+TEST_F(SerializeV2Test,partial_loading)
+{
+    const auto& buffer0 = slice0->buffers->buffers()[0];
+    const auto& declaration = buffer0.declaration();
+
+    for (auto buffer_layout : {svo::svo_buffer_layout_t::interleaved, svo::svo_buffer_layout_t::columns})
+    for (auto byte_order : {svo::svo_byte_order_t::little, svo::svo_byte_order_t::big})
+    {
+        svo::svo_serialization_options_t options;
+        options.byte_order = byte_order;
+        options.buffer_layout = buffer_layout;
+
+        std::ostringstream out;
+        svo::serialize_slice_v2(out, slice0, options);
+        ///a marker after the slice, to check that the skipped payloads leave the stream just past the slice.
+        out << 'M';
+
+        {
+            std::istringstream in(out.str());
+            svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+            svo::unserialize_slice_v2(in, slice1, true, svo::svo_slice_load_filter_t::positions_only());
+
+            EXPECT_EQ(*slice0->pos_data, *slice1->pos_data);
+            EXPECT_EQ(slice1->buffers->buffers().size(), 0U);
+            EXPECT_EQ(in.get(), 'M');
+            svo::svo_uninit_slice(slice1, true);
+        }
+
+        {
+            std::istringstream in(out.str());
+            svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+            svo::unserialize_slice_v2(in, slice1, true, svo::svo_slice_load_filter_t::only({"normal", "id"}));
+
+            EXPECT_EQ(*slice0->pos_data, *slice1->pos_data);
+            EXPECT_EQ(in.get(), 'M');
+
+            ASSERT_EQ(slice1->buffers->buffers().size(), 1U);
+            const auto& buffer1 = slice1->buffers->buffers()[0];
+            ASSERT_EQ(buffer1.declaration().elements().size(), 2U);
+            EXPECT_EQ(buffer1.declaration().elements()[0], declaration.elements()[1]);
+            EXPECT_EQ(buffer1.declaration().elements()[1], declaration.elements()[2]);
+            ASSERT_EQ(buffer1.entries(), buffer0.entries());
+
+            for (std::size_t entry_index = 0; entry_index < buffer0.entries(); ++entry_index)
+            {
+                const uint8_t* entry0 = buffer0.rawdata() + entry_index*buffer0.stride();
+                const uint8_t* entry1 = buffer1.rawdata() + entry_index*buffer1.stride();
+                ASSERT_EQ(0, std::memcmp(entry0 + declaration.offset(1), entry1 + buffer1.declaration().offset(0), 12));
+                ASSERT_EQ(0, std::memcmp(entry0 + declaration.offset(2), entry1 + buffer1.declaration().offset(1), 2));
+            }
+            svo::svo_uninit_slice(slice1, true);
+        }
+    }
+}
+
+#ifdef SVO_VCURVE_64
+TEST_F(SerializeV2Test,wide_vcurves)
+{
+    ///a slice with more than 2^32 voxels, whose vcurves are stored as 64 bit words.
+    svo::svo_slice_t* wide_slice = svo::svo_init_slice(0, 2048);
+    auto& pos_data = *wide_slice->pos_data;
+    for (vcurve_t vcurve = 5; vcurve < vcurvesize(wide_slice->side); vcurve += vcurvesize(wide_slice->side) / 1000 + 1)
+        pos_data.push_back(vcurve);
+    wide_slice->buffers->add_buffer(slice0->buffers->buffers()[0].declaration(), pos_data.size());
+
+    for (auto pos_encoding : {svo::svo_pos_encoding_t::raw, svo::svo_pos_encoding_t::delta_varint})
+    for (auto byte_order : {svo::svo_byte_order_t::little, svo::svo_byte_order_t::big})
+    {
+        svo::svo_serialization_options_t options;
+        options.pos_encoding = pos_encoding;
+        options.byte_order = byte_order;
+
+        std::ostringstream out;
+        svo::serialize_slice_v2(out, wide_slice, options);
+
+        std::istringstream in(out.str());
+        svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+        svo::unserialize_slice_v2(in, slice1, true);
+
+        EXPECT_EQ(slice1->side, wide_slice->side);
+        EXPECT_EQ(*slice1->pos_data, pos_data);
+        svo::svo_uninit_slice(slice1, true);
+    }
+
+    {
+        std::ostringstream out;
+        svo::serialize_slice(out, wide_slice);
+
+        std::istringstream in(out.str());
+        svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+        svo::unserialize_slice(in, slice1, true);
+        EXPECT_EQ(*slice1->pos_data, pos_data);
+        svo::svo_uninit_slice(slice1, true);
+    }
+
+    svo::svo_uninit_slice(wide_slice, true);
+
+    ///smaller slices are stored as with 32 bit vcurves.
+    std::ostringstream out;
+    svo::serialize_slice_v2(out, slice0);
+    std::istringstream in(out.str());
+    svo::svo_slice_t* slice1 = svo::svo_init_slice(0, 16);
+    svo::unserialize_slice_v2(in, slice1, true);
+    expect_same_slice(slice1);
+    svo::svo_uninit_slice(slice1, true);
+}
+#endif
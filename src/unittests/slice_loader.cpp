@@ -0,0 +1,135 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_archive.hpp"
+#include "landscapes/svo_slice_loader.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <sstream>
+#include <set>
+#include <memory>
+
+struct SliceLoaderTest : public ::testing::Test {
+protected:
+
+    std::stringstream m_archive_data;
+    std::unique_ptr<svo::svo_archive_t> m_archive;
+
+    static svo::svo_slice_t* make_slice(std::size_t level, vside_t side, vcurve_t stride)
+    {
+        svo::svo_slice_t* slice = svo::svo_init_slice(level, side);
+        for (vcurve_t vcurve = 0; vcurve < vcurvesize(side); vcurve += stride)
+            slice->pos_data->push_back(vcurve);
+
+        svo::svo_declaration_t declaration;
+        declaration.add(svo::svo_element_t("color", svo::svo_semantic_t::COLOR, svo::svo_data_type_t::UNSIGNED_BYTE, 3));
+        auto& buffer = slice->buffers->add_buffer(declaration, slice->pos_data->size());
+        for (std::size_t byte_index = 0; byte_index < buffer.bytes(); ++byte_index)
+            buffer.rawdata()[byte_index] = uint8_t(byte_index + level);
+        return slice;
+    }
+
+    virtual void SetUp() {
+        ///root => two children, one in the first octant and one in the last.
+        svo::svo_slice_t* root = make_slice(0, 4, 1);
+        svo::svo_slice_attach_child(root, make_slice(1, 4, 2), 0);
+        svo::svo_slice_attach_child(root, make_slice(1, 4, 3), 56);
+
+        svo::svo_write_archive(m_archive_data, root);
+        svo::svo_uninit_slice(root, true);
+
+        m_archive.reset(new svo::svo_archive_t(m_archive_data));
+    }
+
+    static void expect_same_slice(const svo::svo_slice_t* slice0, const svo::svo_slice_t* slice1)
+    {
+        EXPECT_EQ(slice0->level, slice1->level);
+        EXPECT_EQ(slice0->side, slice1->side);
+        EXPECT_EQ(*slice0->pos_data, *slice1->pos_data);
+        EXPECT_EQ(slice0->buffers->schema(), slice1->buffers->schema());
+    }
+};
+
+
+TEST_F(SliceLoaderTest,bounds)
+{
+    float3_t lower, upper;
+
+    svo::svo_archive_slice_bounds(*m_archive, 0, lower, upper);
+    EXPECT_EQ(lower, make_float3(0,0,0));
+    EXPECT_EQ(upper, make_float3(1,1,1));
+
+    svo::svo_archive_slice_bounds(*m_archive, m_archive->find_child(0, 56), lower, upper);
+    EXPECT_EQ(lower, make_float3(.5,.5,.5));
+    EXPECT_EQ(upper, make_float3(1,1,1));
+}
+
+TEST_F(SliceLoaderTest,load_all)
+{
+    svo::svo_async_slice_loader_t loader(*m_archive, 2, 8);
+
+    EXPECT_TRUE(loader.request(0, 1));
+    EXPECT_EQ(loader.prefetch_children(0), 2U);
+
+    std::set<svo::svo_slice_id_t> loaded_ids;
+    svo::svo_loaded_slice_t loaded;
+    while (loader.wait_pop(loaded))
+    {
+        ASSERT_TRUE(loaded.slice);
+        EXPECT_FALSE(loaded.error);
+        loaded_ids.insert(loaded.slice_id);
+
+        std::unique_ptr<svo::svo_slice_t, void(*)(svo::svo_slice_t*)> expected(m_archive->load_subtree(loaded.slice_id, 0)
+                                                                            , [](svo::svo_slice_t* slice){ svo::svo_uninit_slice(slice, true); });
+        expect_same_slice(expected.get(), loaded.slice);
+        EXPECT_EQ(loaded.slice->children->size(), m_archive->entry(loaded.slice_id).children.size());
+
+        svo::svo_uninit_slice(loaded.slice, true);
+    }
+
+    EXPECT_EQ(loaded_ids.size(), 3U);
+    EXPECT_EQ(loader.outstanding(), 0U);
+    EXPECT_FALSE(loader.try_pop(loaded));
+}
+
+TEST_F(SliceLoaderTest,bounded)
+{
+    svo::svo_async_slice_loader_t loader(*m_archive, 1, 1);
+
+    EXPECT_TRUE(loader.request(0));
+    ///the one slot is taken until the slice is popped.
+    EXPECT_FALSE(loader.request(1));
+
+    svo::svo_loaded_slice_t loaded;
+    ASSERT_TRUE(loader.wait_pop(loaded));
+    svo::svo_uninit_slice(loaded.slice, true);
+
+    EXPECT_TRUE(loader.request(1));
+    ///the destructor frees the slice if it is never popped.
+}
+
+TEST_F(SliceLoaderTest,prefetch_near)
+{
+    svo::svo_async_slice_loader_t loader(*m_archive, 2, 8);
+
+    ///near the last octant; the root and the child there are in range, the first child is not.
+    EXPECT_EQ(loader.prefetch_near(make_float3(1.25,1.25,1.25), .5), 2U);
+
+    std::set<svo::svo_slice_id_t> loaded_ids;
+    svo::svo_loaded_slice_t loaded;
+    while (loader.wait_pop(loaded))
+    {
+        loaded_ids.insert(loaded.slice_id);
+        svo::svo_uninit_slice(loaded.slice, true);
+    }
+
+    EXPECT_EQ(loaded_ids, (std::set<svo::svo_slice_id_t>{0, m_archive->find_child(0, 56)}));
+
+    ///popped slices are not prefetched again.
+    EXPECT_EQ(loader.prefetch_near(make_float3(1.25,1.25,1.25), .5), 0U);
+}
+
+TEST_F(SliceLoaderTest,bad_id)
+{
+    svo::svo_async_slice_loader_t loader(*m_archive, 1, 4);
+    EXPECT_THROW(loader.request(100), std::runtime_error);
+}
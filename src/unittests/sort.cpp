@@ -0,0 +1,132 @@
+#include "landscapes/svo_tree.hpp"
+#include "landscapes/svo_sort.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <map>
+#include <random>
+#include <algorithm>
+
+struct SortTest : public ::testing::Test {
+protected:
+
+    svo::svo_declaration_t m_declaration;
+
+    virtual void SetUp() {
+        m_declaration.add(svo::svo_element_t("id", svo::svo_semantic_t::NONE, svo::svo_data_type_t::UNSIGNED_INT, 1));
+    }
+
+    ///a slice with a voxel at each of @c vcurves, whose id is @c ids[i], or @c i.
+    svo::svo_slice_t* make_slice(vside_t side, const std::vector<vcurve_t>& vcurves, uint32_t first_id = 0)
+    {
+        svo::svo_slice_t* slice = svo::svo_init_slice(0, side);
+        *slice->pos_data = vcurves;
+        auto& buffer = slice->buffers->add_buffer(m_declaration, vcurves.size());
+        auto ids = slice->buffers->get_element_view("id");
+        for (std::size_t i = 0; i < buffer.entries(); ++i)
+            ids.get<uint32_t>(i) = first_id + uint32_t(i);
+        return slice;
+    }
+
+    static uint32_t id(const svo::svo_slice_t* slice, std::size_t i)
+    {
+        return slice->buffers->get_element_view("id").get<uint32_t>(i);
+    }
+};
+
+
+TEST_F(SortTest,radix_sort)
+{
+    std::mt19937 rng(3);
+    std::vector<svo::svo_sort_record_t> records(100000);
+    for (std::size_t i = 0; i < records.size(); ++i)
+        records[i] = svo::svo_sort_record_t{rng() % 5000, i};
+
+    auto expected = records;
+    std::stable_sort(expected.begin(), expected.end()
+                    , [](const svo::svo_sort_record_t& a, const svo::svo_sort_record_t& b){ return a.key < b.key; });
+
+    for (std::size_t num_threads : {1, 4})
+    {
+        auto sorted = records;
+        svo::svo_radix_sort(sorted, 13, num_threads);
+        for (std::size_t i = 0; i < sorted.size(); ++i)
+        {
+            ASSERT_EQ(sorted[i].key, expected[i].key);
+            ASSERT_EQ(sorted[i].index, expected[i].index);
+        }
+    }
+}
+
+TEST_F(SortTest,sort_slice_data)
+{
+    std::mt19937 rng(5);
+    std::vector<vcurve_t> vcurves(20000);
+    for (auto& vcurve : vcurves)
+        vcurve = rng() % vcurvesize(32);
+
+    svo::svo_slice_t* slice = make_slice(32, vcurves);
+    svo::svo_sort_slice_data(slice, 4);
+
+    ///the last voxel of each vcurve wins.
+    std::map<vcurve_t, uint32_t> expected;
+    for (std::size_t i = 0; i < vcurves.size(); ++i)
+        expected[vcurves[i]] = uint32_t(i);
+
+    const auto& pos_data = *slice->pos_data;
+    ASSERT_EQ(pos_data.size(), expected.size());
+    ASSERT_EQ(slice->buffers->entries(), expected.size());
+    std::size_t i = 0;
+    for (const auto& vcurve_id : expected)
+    {
+        ASSERT_EQ(pos_data[i], vcurve_id.first);
+        ASSERT_EQ(id(slice, i), vcurve_id.second);
+        ++i;
+    }
+    svo::svo_uninit_slice(slice, true);
+}
+
+TEST_F(SortTest,merge)
+{
+    svo::svo_slice_t* a = make_slice(4, {0, 1, 5, 9}, 100);
+    svo::svo_slice_t* b = make_slice(4, {2, 3, 4}, 200);
+    svo::svo_slice_t* c = make_slice(4, {0, 63}, 300);
+
+    svo::svo_slice_t* dst = svo::svo_init_slice(0, 8);
+    svo::svo_merge_slice_data(dst, {a, nullptr, b, c}, {0, 0, 10, 5});
+
+    ///c's voxel 0 lands on a's voxel 5, and wins as the later source.
+    std::vector<vcurve_t> expected_pos_data = {0, 1, 5, 9, 12, 13, 14, 68};
+    std::vector<uint32_t> expected_ids = {100, 101, 300, 103, 200, 201, 202, 301};
+    ASSERT_EQ(*dst->pos_data, expected_pos_data);
+    ASSERT_EQ(dst->buffers->entries(), expected_ids.size());
+    for (std::size_t i = 0; i < expected_ids.size(); ++i)
+        EXPECT_EQ(id(dst, i), expected_ids[i]);
+
+    svo::svo_slice_t* not_empty = svo::svo_init_slice(0, 8);
+    not_empty->pos_data->push_back(0);
+    EXPECT_THROW(svo::svo_merge_slice_data(not_empty, {a}, {0}), std::runtime_error);
+
+    for (auto* slice : {a, b, c, dst, not_empty})
+        svo::svo_uninit_slice(slice, true);
+}
+
+TEST_F(SortTest,partition)
+{
+    ///octant size is 8 in a slice of side 4.
+    svo::svo_slice_t* slice = make_slice(4, {60, 3, 17, 1, 62, 16, 40});
+
+    std::array<std::size_t, 9> octant_begin;
+    svo::svo_partition_slice_data(slice, octant_begin);
+
+    std::array<std::size_t, 9> expected_begin = {{0, 2, 2, 4, 4, 4, 5, 5, 7}};
+    EXPECT_EQ(octant_begin, expected_begin);
+
+    std::vector<vcurve_t> expected_pos_data = {3, 1, 17, 16, 40, 60, 62};
+    std::vector<uint32_t> expected_ids = {1, 3, 2, 5, 6, 0, 4};
+    ASSERT_EQ(*slice->pos_data, expected_pos_data);
+    for (std::size_t i = 0; i < expected_ids.size(); ++i)
+        EXPECT_EQ(id(slice, i), expected_ids[i]);
+
+    svo::svo_uninit_slice(slice, true);
+}
@@ -1,5 +1,6 @@
 
 #include "landscapes/svo_curves.h"
+#include "landscapes/svo_morton.hpp"
 #include "gtest/gtest.h"
 #include <fstream>
 #include <vector>
@@ -23,18 +24,22 @@ protected:
 
 TEST_F(ZOrderTest,coords2vcurve){
 
-    std::vector<bool> vcurves_seen(SVO_VCURVE_LIMIT, false);
+    ///every voxel of the largest side covered by the lookup tables; all of them, without SVO_VCURVE_64.
+    const vside_t side = SVO_MORTON_TABLE_SIDE;
+    const vcurvesize_t size = vcurvesize_t(side) * side * side;
 
-    for (vside_t x = 0; x < SVO_VSIDE_LIMIT; ++x)
-    for (vside_t y = 0; y < SVO_VSIDE_LIMIT; ++y)
-    for (vside_t z = 0; z < SVO_VSIDE_LIMIT; ++z)
+    std::vector<bool> vcurves_seen(size, false);
+
+    for (vside_t x = 0; x < side; ++x)
+    for (vside_t y = 0; y < side; ++y)
+    for (vside_t z = 0; z < side; ++z)
     {
-        auto vcurve0 = coords2vcurve_brute(x,y,z,SVO_VSIDE_LIMIT);
-        auto vcurve = coords2vcurve(x,y,z,SVO_VSIDE_LIMIT);
+        auto vcurve0 = coords2vcurve_brute(x,y,z,side);
+        auto vcurve = coords2vcurve(x,y,z,side);
     
         
         
-        ASSERT_LT(vcurve, SVO_VCURVE_LIMIT);
+        ASSERT_LT(vcurve, size);
         ASSERT_EQ(vcurve0, vcurve);
         ASSERT_LT(vcurve, vcurves_seen.size());
         ASSERT_FALSE(vcurves_seen[vcurve]);
@@ -43,7 +48,7 @@ TEST_F(ZOrderTest,coords2vcurve){
         ASSERT_TRUE(vcurves_seen[vcurve]);
 
         vside_t x1, y1, z1;
-        vcurve2coords(vcurve, SVO_VSIDE_LIMIT, &x1, &y1, &z1);
+        vcurve2coords(vcurve, side, &x1, &y1, &z1);
 
         ASSERT_EQ(x, x1);
         ASSERT_EQ(y, y1);
@@ -56,3 +61,59 @@ TEST_F(ZOrderTest,coords2vcurve){
     
 }
 
+TEST_F(ZOrderTest,batch){
+
+    std::vector<vside_t> coords;
+    std::vector<vcurve_t> expected_vcurves;
+    for (vside_t x = 0; x < SVO_MORTON_TABLE_SIDE; x += 3)
+    for (vside_t y = 0; y < SVO_MORTON_TABLE_SIDE; y += 5)
+    for (vside_t z = 0; z < SVO_MORTON_TABLE_SIDE; z += 7)
+    {
+        coords.insert(coords.end(), {x, y, z});
+        expected_vcurves.push_back(coords2vcurve(x,y,z,SVO_MORTON_TABLE_SIDE));
+    }
+    ///the codec handles 10 bits per coordinate.
+    coords.insert(coords.end(), {1023, 512, 1});
+    expected_vcurves.push_back(vcurve_t(0x09249249 | (1 << 28) | (1 << 2)));
+#ifdef SVO_VCURVE_64
+    ///and 21 bits with 64 bit vcurves.
+    coords.insert(coords.end(), {2097151, 1 << 20, 0});
+    expected_vcurves.push_back(vcurve_t(0x1249249249249249ULL | (1ULL << 61)));
+#endif
+
+    std::size_t n = expected_vcurves.size();
+
+    std::vector<vcurve_t> vcurves(n), portable_vcurves(n);
+    svo::svo_morton_encode_n(coords.data(), vcurves.data(), n);
+    svo::svo_morton_encode_n_portable(coords.data(), portable_vcurves.data(), n);
+    ASSERT_EQ(vcurves, expected_vcurves);
+    ASSERT_EQ(portable_vcurves, expected_vcurves);
+
+    std::vector<vside_t> decoded(3*n), portable_decoded(3*n);
+    svo::svo_morton_decode_n(vcurves.data(), decoded.data(), n);
+    svo::svo_morton_decode_n_portable(vcurves.data(), portable_decoded.data(), n);
+    ASSERT_EQ(decoded, coords);
+    ASSERT_EQ(portable_decoded, coords);
+}
+
+#ifdef SVO_VCURVE_64
+TEST_F(ZOrderTest,wide){
+
+    const vside_t side = SVO_VSIDE_LIMIT;
+    for (vside_t x = 0; x < side; x += 4099)
+    for (vside_t y = 1; y < side; y += 8191)
+    for (vside_t z = 2; z < side; z += 65537)
+    {
+        auto vcurve = coords2vcurve(x,y,z,side);
+        ASSERT_EQ(coords2vcurve_brute(x,y,z,side), vcurve);
+
+        vside_t x1, y1, z1;
+        vcurve2coords(vcurve, side, &x1, &y1, &z1);
+        ASSERT_EQ(x, x1);
+        ASSERT_EQ(y, y1);
+        ASSERT_EQ(z, z1);
+    }
+
+    ASSERT_EQ(coords2vcurve(side - 1, side - 1, side - 1, side), vcurve_t(vcurvesize(side) - 1));
+}
+#endif